@@ -27,9 +27,38 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    REMORA_Database.cpp \
+    REMORA_ForecastEngine.cpp \
+    REMORA_ForecastStore.cpp \
+    REMORA_ModelLoader.cpp \
+    REMORA_QueryProfiler.cpp \
+    REMORA_ResultCache.cpp \
+    REMORA_RunWorker.cpp \
+    REMORA_Scenario.cpp \
+    REMORA_SQLiteStorage.cpp \
+    REMORA_SqlStorage.cpp \
+    REMORA_Statistics.cpp \
+    REMORA_Storage.cpp \
+    REMORA_Sweep.cpp \
+    REMORA_SweepDialog.cpp \
     REMORA_UI.cpp
 
 HEADERS += \
+    REMORA_Database.h \
+    REMORA_ForecastData.h \
+    REMORA_ForecastEngine.h \
+    REMORA_ForecastStore.h \
+    REMORA_ModelLoader.h \
+    REMORA_QueryProfiler.h \
+    REMORA_ResultCache.h \
+    REMORA_RunWorker.h \
+    REMORA_Scenario.h \
+    REMORA_SQLiteStorage.h \
+    REMORA_SqlStorage.h \
+    REMORA_Statistics.h \
+    REMORA_Storage.h \
+    REMORA_Sweep.h \
+    REMORA_SweepDialog.h \
     REMORA_UI.h \
     mainpage.h \
     precompiled_header.h
@@ -0,0 +1,318 @@
+#include "REMORA_Database.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSqlDriver>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QThread>
+
+#include <algorithm>
+
+
+REMORA_Database::REMORA_Database(
+        const QString&        sourceConnectionName,
+        nmfLogger*            logger,
+        REMORA_QueryProfiler* profiler)
+{
+    m_Logger   = logger;
+    m_Profiler = profiler;
+    m_CallSite = "REMORA_Database";
+
+    if (QThread::currentThread() == QCoreApplication::instance()->thread()) {
+        // The host application's connection may be used directly from the GUI thread
+        m_OwnsConnection = false;
+        m_ConnectionName = sourceConnectionName;
+    } else {
+        m_OwnsConnection = true;
+        m_ConnectionName = "REMORA_" + QString::number(quintptr(QThread::currentThreadId()),16);
+        if (! QSqlDatabase::contains(m_ConnectionName)) {
+            QSqlDatabase db = QSqlDatabase::cloneDatabase(sourceConnectionName,m_ConnectionName);
+            if (! db.open()) {
+                m_Logger->logMsg(nmfConstants::Error,
+                                 "REMORA_Database: Couldn't open connection " + m_ConnectionName.toStdString() +
+                                 ": " + db.lastError().text().toStdString());
+            }
+        }
+    }
+}
+
+REMORA_Database::~REMORA_Database()
+{
+    if (m_OwnsConnection && QSqlDatabase::contains(m_ConnectionName)) {
+        {
+            QSqlDatabase db = QSqlDatabase::database(m_ConnectionName,false);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(m_ConnectionName);
+    }
+}
+
+bool
+REMORA_Database::commit()
+{
+    QSqlDatabase db = QSqlDatabase::database(m_ConnectionName,false);
+    REMORA_QueryTimer timer(m_Profiler,m_CallSite,"COMMIT");
+
+    if (! db.commit()) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA_Database::commit: " +
+                         db.lastError().text().toStdString());
+        return false;
+    }
+    return true;
+}
+
+QString
+REMORA_Database::connectionName()
+{
+    return m_ConnectionName;
+}
+
+QString
+REMORA_Database::driverName()
+{
+    return QSqlDatabase::database(m_ConnectionName,false).driverName();
+}
+
+QString
+REMORA_Database::hostConnectionName()
+{
+    if (QSqlDatabase::contains(QSqlDatabase::defaultConnection)) {
+        return QString(QSqlDatabase::defaultConnection);
+    }
+    QStringList names = QSqlDatabase::connectionNames();
+    return (names.isEmpty()) ? QString(QSqlDatabase::defaultConnection) : names[0];
+}
+
+bool
+REMORA_Database::isOpen()
+{
+    return QSqlDatabase::database(m_ConnectionName,false).isOpen();
+}
+
+std::string
+REMORA_Database::lastError()
+{
+    return m_LastError;
+}
+
+int
+REMORA_Database::maxRowsPerStatement(
+        const int& numFields,
+        const int& chunkSize)
+{
+    // SQLite limits the number of bound values per statement to 999 in older
+    // versions; MySQL allows 65535.
+    int maxBindValues = (driverName() == "QSQLITE") ? 999 : 65535;
+
+    return std::max(1,std::min(chunkSize,maxBindValues/numFields));
+}
+
+std::string
+REMORA_Database::nmfInsertRows(
+        const std::string&              table,
+        const std::vector<std::string>& fields,
+        const QVariantList&             values,
+        const int&                      chunkSize)
+{
+    int numFields  = int(fields.size());
+    int numRows    = (numFields > 0) ? values.size()/numFields : 0;
+    int rowsPerCmd = maxRowsPerStatement(numFields,chunkSize);
+    int preparedRows = 0;
+    int rowsInCmd;
+    QString fieldList;
+    QString rowPlaceholders;
+    QString cmd;
+    QElapsedTimer timer;
+    QSqlQuery qry(QSqlDatabase::database(m_ConnectionName,false));
+    REMORA_QueryTimer queryTimer(m_Profiler,m_CallSite,"INSERT");
+    qint64 numBytes = 0;
+
+    if (numRows == 0) {
+        return "";
+    }
+    timer.start();
+    for (int i=0; i<numFields; ++i) {
+        fieldList       += (i == 0) ? "" : ",";
+        fieldList       += QString::fromStdString(fields[i]);
+        rowPlaceholders += (i == 0) ? "(?" : ",?";
+    }
+    rowPlaceholders += ")";
+
+    // Full chunks share one prepared statement; only the last, shorter chunk needs another
+    for (int firstRow=0; firstRow<numRows; firstRow+=rowsInCmd) {
+        rowsInCmd = std::min(rowsPerCmd,numRows-firstRow);
+        if (rowsInCmd != preparedRows) {
+            cmd = "INSERT INTO " + QString::fromStdString(table) + " (" + fieldList + ") VALUES " + rowPlaceholders;
+            for (int row=1; row<rowsInCmd; ++row) {
+                cmd += "," + rowPlaceholders;
+            }
+            if (! qry.prepare(cmd)) {
+                return qry.lastError().text().toStdString();
+            }
+            preparedRows = rowsInCmd;
+        }
+        for (int i=firstRow*numFields; i<(firstRow+rowsInCmd)*numFields; ++i) {
+            qry.addBindValue(values[i]);
+            numBytes += (values[i].type() == QVariant::String) ? values[i].toString().size() : qint64(sizeof(double));
+        }
+        if (! qry.exec()) {
+            return qry.lastError().text().toStdString();
+        }
+    }
+
+    queryTimer.setResult(numRows,numBytes);
+    qint64 msec = std::max(qint64(1),timer.elapsed());
+    m_Logger->logMsg(nmfConstants::Normal,"REMORA_Database: Inserted " + std::to_string(numRows) +
+                     " rows into " + table + " in " + std::to_string(msec) + " ms (" +
+                     std::to_string(qint64(numRows)*1000/msec) + " rows/s, " +
+                     std::to_string(rowsPerCmd) + " rows per statement)");
+    return "";
+}
+
+bool
+REMORA_Database::nmfQueryColumns(
+        const std::string&                queryStr,
+        const std::vector<REMORA_Column>& columns,
+        REMORA_QueryResult&               result)
+{
+    int numColumns = int(columns.size());
+    std::vector<std::vector<std::string>*> textColumns(numColumns,nullptr);
+    std::vector<std::vector<int>*>         integerColumns(numColumns,nullptr);
+    std::vector<std::vector<double>*>      realColumns(numColumns,nullptr);
+    QSqlQuery qry(QSqlDatabase::database(m_ConnectionName,false));
+    REMORA_QueryTimer timer(m_Profiler,m_CallSite,REMORA_QueryProfiler::statementClass(queryStr));
+    qint64 numBytes = 0;
+
+    result = REMORA_QueryResult();
+    qry.setForwardOnly(true);
+    qry.setNumericalPrecisionPolicy(QSql::LowPrecisionDouble); // Numeric columns arrive as doubles, not strings
+    if (! qry.exec(QString::fromStdString(queryStr))) {
+        m_LastError = qry.lastError().text().toStdString();
+        m_Logger->logMsg(nmfConstants::Error,"REMORA_Database::nmfQueryColumns: " + m_LastError);
+        m_Logger->logMsg(nmfConstants::Error,queryStr);
+        return false;
+    }
+
+    // Resolve each column's destination once rather than per row
+    int numRows = std::max(0,qry.size()); // -1 if the driver can't report it
+    for (int i=0; i<numColumns; ++i) {
+        switch (columns[i].DataType) {
+            case REMORA_Column::Text:
+                textColumns[i] = &result.Text[columns[i].Name];
+                textColumns[i]->reserve(numRows);
+                break;
+            case REMORA_Column::Integer:
+                integerColumns[i] = &result.Integer[columns[i].Name];
+                integerColumns[i]->reserve(numRows);
+                break;
+            case REMORA_Column::Real:
+                realColumns[i] = &result.Real[columns[i].Name];
+                realColumns[i]->reserve(numRows);
+                break;
+        }
+    }
+    while (qry.next()) {
+        for (int i=0; i<numColumns; ++i) {
+            if (realColumns[i] != nullptr) {
+                realColumns[i]->push_back(qry.value(i).toDouble());
+                numBytes += sizeof(double);
+            } else if (integerColumns[i] != nullptr) {
+                integerColumns[i]->push_back(qry.value(i).toInt());
+                numBytes += sizeof(int);
+            } else {
+                textColumns[i]->push_back(qry.value(i).toString().toStdString());
+                numBytes += textColumns[i]->back().size();
+            }
+        }
+        ++result.NumRows;
+    }
+    timer.setResult(result.NumRows,numBytes);
+    return true;
+}
+
+std::map<std::string, std::vector<std::string> >
+REMORA_Database::nmfQueryDatabase(
+        const std::string&              queryStr,
+        const std::vector<std::string>& fields)
+{
+    std::map<std::string, std::vector<std::string> > dataMap;
+    QSqlQuery qry(QSqlDatabase::database(m_ConnectionName,false));
+    REMORA_QueryTimer timer(m_Profiler,m_CallSite,REMORA_QueryProfiler::statementClass(queryStr));
+    qint64 numRows  = 0;
+    qint64 numBytes = 0;
+
+    qry.setForwardOnly(true);
+    if (! qry.exec(QString::fromStdString(queryStr))) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA_Database::nmfQueryDatabase: " +
+                         qry.lastError().text().toStdString());
+        m_Logger->logMsg(nmfConstants::Error,queryStr);
+        return dataMap;
+    }
+    for (const std::string& field : fields) {
+        dataMap[field].clear();
+    }
+    while (qry.next()) {
+        for (unsigned i=0; i<fields.size(); ++i) {
+            dataMap[fields[i]].push_back(qry.value(int(i)).toString().toStdString());
+            numBytes += dataMap[fields[i]].back().size();
+        }
+        ++numRows;
+    }
+    timer.setResult(numRows,numBytes);
+    return dataMap;
+}
+
+std::string
+REMORA_Database::nmfUpdateDatabase(const std::string& cmd)
+{
+    QSqlQuery qry(QSqlDatabase::database(m_ConnectionName,false));
+    REMORA_QueryTimer timer(m_Profiler,m_CallSite,REMORA_QueryProfiler::statementClass(cmd));
+
+    if (! qry.exec(QString::fromStdString(cmd))) {
+        return qry.lastError().text().toStdString();
+    }
+    timer.setResult(std::max(0,qry.numRowsAffected()),qint64(cmd.size()));
+    return "";
+}
+
+bool
+REMORA_Database::rollback()
+{
+    QSqlDatabase db = QSqlDatabase::database(m_ConnectionName,false);
+    REMORA_QueryTimer timer(m_Profiler,m_CallSite,"ROLLBACK");
+
+    if (! db.rollback()) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA_Database::rollback: " +
+                         db.lastError().text().toStdString());
+        return false;
+    }
+    return true;
+}
+
+void
+REMORA_Database::setCallSite(const std::string& callSite)
+{
+    m_CallSite = callSite;
+}
+
+void
+REMORA_Database::setProfiler(REMORA_QueryProfiler* profiler)
+{
+    m_Profiler = profiler;
+}
+
+bool
+REMORA_Database::transaction()
+{
+    QSqlDatabase db = QSqlDatabase::database(m_ConnectionName,false);
+    REMORA_QueryTimer timer(m_Profiler,m_CallSite,"BEGIN");
+
+    if (! db.transaction()) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA_Database::transaction: " +
+                         db.lastError().text().toStdString());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file REMORA_Database.h
+ * @brief Definition for the per-thread REMORA database connection
+ *
+ * This file contains the definition of a small database class that REMORA uses
+ * when it must access the database from a thread other than the one that opened
+ * the host application's connection. Qt database connections may only be used
+ * from the thread that created them, so this class clones the host connection
+ * into the calling thread.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+#ifndef REMORA_DATABASE_H
+#define REMORA_DATABASE_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QVariant>
+
+#include "nmfLogger.h"
+#include "REMORA_QueryProfiler.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A column requested from REMORA_Database::nmfQueryColumns and the type it's fetched as
+ */
+struct REMORA_Column {
+    enum Type { Text, Integer, Real };
+
+    std::string Name;
+    Type        DataType;
+};
+
+/**
+ * @brief Result of REMORA_Database::nmfQueryColumns. Each column is held in a contiguous
+ * vector of its requested type, so numeric values are never stored as strings.
+ */
+struct REMORA_QueryResult {
+    int NumRows = 0;
+    std::map<std::string, std::vector<std::string> > Text;
+    std::map<std::string, std::vector<int> >         Integer;
+    std::map<std::string, std::vector<double> >      Real;
+};
+
+/**
+ * @brief Database connection owned by the thread that constructs it
+ *
+ * The query and update methods mirror those of nmfDatabase so that code may
+ * be moved between the GUI thread and a worker thread without modification.
+ * If a REMORA_QueryProfiler is set, every call is recorded under the call site
+ * last passed to setCallSite.
+ */
+class REMORA_Database
+{
+
+private:
+    bool                  m_OwnsConnection;
+    QString               m_ConnectionName;
+    nmfLogger*            m_Logger;
+    REMORA_QueryProfiler* m_Profiler;
+    std::string           m_CallSite;
+    std::string           m_LastError;
+
+    int maxRowsPerStatement(const int& numFields,
+                            const int& chunkSize);
+
+public:
+    /**
+     * @brief Default number of rows written by each INSERT statement of nmfInsertRows
+     */
+    static const int DefaultInsertChunkSize = 500;
+
+    /**
+     * @brief Opens a connection usable from the calling thread
+     * @param sourceConnectionName : name of the connection opened by the host application
+     * @param logger : pointer to error logger API
+     * @param profiler : records the latency of each call (null disables profiling)
+     */
+    REMORA_Database(const QString&        sourceConnectionName,
+                    nmfLogger*            logger,
+                    REMORA_QueryProfiler* profiler = nullptr);
+   ~REMORA_Database();
+
+    /**
+     * @brief Commits the transaction started with transaction()
+     * @return true if the transaction was committed
+     */
+    bool commit();
+    /**
+     * @brief Returns the name of the connection used by this instance
+     * @return Qt connection name
+     */
+    QString connectionName();
+    /**
+     * @brief Returns the name of the Qt driver of the connection (i.e., QMYSQL or QSQLITE)
+     * @return Qt driver name
+     */
+    QString driverName();
+    /**
+     * @brief Finds the name of the connection opened by the host application
+     * @return The default connection name if it exists, else the first connection found
+     */
+    static QString hostConnectionName();
+    /**
+     * @brief Returns true if the underlying connection is open
+     * @return true if open, false otherwise
+     */
+    bool isOpen();
+    /**
+     * @brief Returns the database error message of the last failed nmfQueryColumns call
+     * @return The error message, empty if no query has failed
+     */
+    std::string lastError();
+    /**
+     * @brief Inserts rows with prepared, parameter bound INSERT statements of up to
+     * chunkSize rows each. The values are bound so no SQL text is built per value and
+     * the statements are prepared once per chunk size. Call within a transaction so
+     * that the rows are committed together.
+     * @param table : the table to insert into
+     * @param fields : the field names of each row
+     * @param values : the row values, fields.size() values per row in field order
+     * @param chunkSize : the maximum number of rows per INSERT statement (reduced if the
+     * driver can't bind that many values in one statement)
+     * @return An empty string on success, else the database error message
+     */
+    std::string nmfInsertRows(
+            const std::string&              table,
+            const std::vector<std::string>& fields,
+            const QVariantList&             values,
+            const int&                      chunkSize = DefaultInsertChunkSize);
+    /**
+     * @brief Queries the database and fetches each requested column directly into a
+     * vector of its type. Prefer this to nmfQueryDatabase for numeric columns.
+     * @param queryStr : the SELECT statement, selecting the columns in the order given
+     * @param columns : the name and type of each selected column
+     * @param result : the fetched columns, keyed by name in the map of their type
+     * @return true if the query succeeded (even if no rows were found), false otherwise
+     * (see lastError)
+     */
+    bool nmfQueryColumns(
+            const std::string&                queryStr,
+            const std::vector<REMORA_Column>& columns,
+            REMORA_QueryResult&               result);
+    /**
+     * @brief Queries the database and returns the requested fields as strings
+     * @param queryStr : the SELECT statement
+     * @param fields : the field names to return
+     * @return Map of field name to the values found for that field
+     */
+    std::map<std::string, std::vector<std::string> > nmfQueryDatabase(
+            const std::string&              queryStr,
+            const std::vector<std::string>& fields);
+    /**
+     * @brief Executes a statement that modifies the database
+     * @param cmd : the statement to execute
+     * @return An empty string on success, else the database error message
+     */
+    std::string nmfUpdateDatabase(const std::string& cmd);
+    /**
+     * @brief Rolls back the transaction started with transaction()
+     * @return true if the transaction was rolled back
+     */
+    bool rollback();
+    /**
+     * @brief Sets the call site under which subsequent calls are profiled
+     * @param callSite : the calling function (i.e., REMORA_RunWorker::saveHarvestData)
+     */
+    void setCallSite(const std::string& callSite);
+    /**
+     * @brief Sets the profiler that records the latency of each call
+     * @param profiler : the profiler (null disables profiling)
+     */
+    void setProfiler(REMORA_QueryProfiler* profiler);
+    /**
+     * @brief Starts a transaction on the connection
+     * @return true if the transaction was started
+     */
+    bool transaction();
+};
+
+#endif // REMORA_DATABASE_H
@@ -0,0 +1,381 @@
+/**
+ * @file REMORA_ForecastData.h
+ * @brief Data structures passed between the REMORA GUI and its run pipeline
+ *
+ * This file contains the plain data structures that REMORA uses to hand a
+ * snapshot of the GUI controls to the run pipeline and to hand the finished
+ * forecast data back to the drawing routines. None of these structures
+ * reference any widget so they may be safely copied across threads.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+#ifndef REMORA_FORECASTDATA_H
+#define REMORA_FORECASTDATA_H
+
+#include <QMetaType>
+#include <QString>
+
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class REMORA_QueryProfiler;
+
+/**
+ * @brief Metadata of the current project's model that REMORA reads repeatedly
+ *
+ * Loaded once per project and model by REMORA_UI and discarded whenever the
+ * host application sets the project or model name.
+ */
+struct REMORA_ModelMetadata {
+    bool        IsLoaded         = false;
+    bool        IsModelFound     = false; ///< The model's algorithm identifiers were found
+    bool        IsYearRangeFound = false;
+    int         StartYear        = 0;
+    int         EndYear          = 0;     ///< Last year of the estimation (i.e., StartYear + RunLength)
+    std::vector<std::string> SpeciesNames;
+    std::string Algorithm;
+    std::string Minimizer;
+    std::string ObjectiveCriterion;
+    std::string Scaling;
+    std::string CompetitionForm;
+};
+
+/**
+ * @brief A saved forecast's settings and the catch it's based upon, as drawn by REMORA
+ *
+ * Loaded once per forecast by REMORA_UI so that changing the plot type or scale
+ * only transforms data already in memory. Discarded whenever a forecast is run or
+ * the host application sets the project or model name.
+ */
+struct REMORA_ForecastInfo {
+    bool        IsLoaded           = false;
+    bool        IsForecastFound    = false;
+    std::string ProjectName;
+    std::string ModelName;
+    std::string ForecastName;
+    int         NumYearsPerRun     = 0;
+    int         NumRunsPerForecast = 0;
+    int         StartForecastYear  = 0;
+    std::string Algorithm;
+    std::string Minimizer;
+    std::string ObjectiveCriterion;
+    std::string Scaling;
+    std::string GrowthForm;
+    std::string HarvestForm;
+    std::string CompetitionForm;
+    std::string PredationForm;
+    std::string ForecastHarvestType;
+    std::string CatchType;                 ///< Time series LastCatch was read from (empty if not read)
+    std::vector<double> LastCatch;         ///< Catch of the last observed year, per species
+    std::map<std::string,std::vector<std::string> > HoverData; ///< Monte Carlo hover labels per species name, read on demand
+};
+
+/**
+ * @brief Snapshot of all of the REMORA controls needed to perform a forecast run
+ *
+ * The snapshot is taken on the GUI thread when the user presses Run, so that
+ * the run pipeline never has to touch a widget.
+ */
+struct REMORA_RunSettings {
+    QString     ConnectionName;     ///< Name of the connection holding the REMORA tables
+    QString     CacheDir;           ///< Directory of the forecast result cache (empty disables the cache)
+    QString     ForecastStoreDir;   ///< Directory of the binary forecast store (empty disables the store)
+    std::string ProjectName;
+    std::string ModelName;
+    std::string ForecastName;
+    std::string HarvestType;        ///< Name of the forecast harvest table (i.e., forecastharvestcatch)
+    std::string Algorithm;
+    std::string Minimizer;
+    std::string ObjectiveCriterion;
+    std::string Scaling;
+    std::string ForecastAlgorithm;          ///< Algorithm of the estimation the forecast is based upon
+    std::string ForecastMinimizer;
+    std::string ForecastObjectiveCriterion;
+    std::string ForecastScaling;
+    std::string GrowthForm;
+    std::string HarvestForm;
+    std::string CompetitionForm;
+    std::string PredationForm;
+    std::vector<std::string> SpeciesNames;
+    int    StartYear                   = 0;
+    int    EndYear                     = 0;
+    int    NumYearsPerRun              = 0;
+    int    NumRunsPerForecast          = 0;   ///< Number of runs, or the maximum number of runs if adaptive
+    bool   IsDeterministic             = false;
+    std::string SamplingMethod         = "Random"; ///< How the uncertainty multipliers are drawn: Random or Latin Hypercube
+    bool   IsAdaptive                  = false; ///< Stop adding runs once the run quantiles have converged
+    double ConvergenceTolerance        = 0.01;  ///< Largest relative change in any tracked quantile between batches at which an adaptive forecast stops
+    int    AdaptiveBatchSize           = 10;    ///< Number of runs added between convergence checks
+    double GrowthUncertainty           = 0.0; ///< Growth rate uncertainty as a fraction (i.e., 0.10 = 10%)
+    double CarryingCapacityUncertainty = 0.0; ///< Carrying capacity uncertainty as a fraction
+    double HarvestUncertainty          = 0.0; ///< Harvest uncertainty as a fraction
+    std::vector<std::vector<double> > ScaleFactors; ///< Harvest scale factor per [species][year]
+    int    InsertChunkSize             = 500;   ///< Rows per INSERT statement when saving the forecast configuration
+    REMORA_QueryProfiler* QueryProfiler = nullptr; ///< Records the latency of the run's database calls (null disables profiling)
+    bool   ForecastDirty                    = true; ///< Anything other than the scale factors and uncertainties changed since the last run
+    bool   GrowthUncertaintyDirty           = true;
+    bool   CarryingCapacityUncertaintyDirty = true;
+    bool   HarvestUncertaintyDirty          = true;
+    std::vector<bool> DirtySpecies;                 ///< Species whose scale factor curve changed since the last run
+
+    /**
+     * @brief Sets the dirty flags by comparing these settings with those of the last completed run
+     * @param previous : settings of the last completed run (default constructed if there was none)
+     */
+    void markChanges(const REMORA_RunSettings& previous) {
+        int NumSpecies = int(SpeciesNames.size());
+
+        ForecastDirty = previous.ProjectName.empty()                                        ||
+                        (ProjectName                != previous.ProjectName)                ||
+                        (ModelName                  != previous.ModelName)                  ||
+                        (ForecastName               != previous.ForecastName)               ||
+                        (HarvestType                != previous.HarvestType)                ||
+                        (Algorithm                  != previous.Algorithm)                  ||
+                        (Minimizer                  != previous.Minimizer)                  ||
+                        (ObjectiveCriterion         != previous.ObjectiveCriterion)         ||
+                        (Scaling                    != previous.Scaling)                    ||
+                        (ForecastAlgorithm          != previous.ForecastAlgorithm)          ||
+                        (ForecastMinimizer          != previous.ForecastMinimizer)          ||
+                        (ForecastObjectiveCriterion != previous.ForecastObjectiveCriterion) ||
+                        (ForecastScaling            != previous.ForecastScaling)            ||
+                        (GrowthForm                 != previous.GrowthForm)                 ||
+                        (HarvestForm                != previous.HarvestForm)                ||
+                        (CompetitionForm            != previous.CompetitionForm)            ||
+                        (PredationForm              != previous.PredationForm)              ||
+                        (SpeciesNames               != previous.SpeciesNames)               ||
+                        (StartYear                  != previous.StartYear)                  ||
+                        (EndYear                    != previous.EndYear)                    ||
+                        (NumYearsPerRun             != previous.NumYearsPerRun)             ||
+                        (NumRunsPerForecast         != previous.NumRunsPerForecast)         ||
+                        (IsDeterministic            != previous.IsDeterministic)            ||
+                        (SamplingMethod             != previous.SamplingMethod)             ||
+                        (IsAdaptive                 != previous.IsAdaptive)                 ||
+                        (IsAdaptive && (ConvergenceTolerance != previous.ConvergenceTolerance)) ||
+                        (IsAdaptive && (AdaptiveBatchSize    != previous.AdaptiveBatchSize));
+        GrowthUncertaintyDirty           = ForecastDirty || (GrowthUncertainty           != previous.GrowthUncertainty);
+        CarryingCapacityUncertaintyDirty = ForecastDirty || (CarryingCapacityUncertainty != previous.CarryingCapacityUncertainty);
+        HarvestUncertaintyDirty          = ForecastDirty || (HarvestUncertainty          != previous.HarvestUncertainty);
+        DirtySpecies.assign(NumSpecies,true);
+        if (! ForecastDirty && (int(previous.ScaleFactors.size()) == NumSpecies)) {
+            for (int species=0; species<NumSpecies; ++species) {
+                DirtySpecies[species] = (ScaleFactors[species] != previous.ScaleFactors[species]);
+            }
+        }
+    }
+    /**
+     * @brief Returns true if any of the uncertainty dials changed since the last run
+     */
+    bool isUncertaintyDirty() const {
+        return GrowthUncertaintyDirty || CarryingCapacityUncertaintyDirty || HarvestUncertaintyDirty;
+    }
+};
+
+/**
+ * @brief Dense (year x species x run) biomass of the Monte Carlo runs
+ *
+ * The runs of each year and species are contiguous so that all runs may be stepped, and
+ * all runs of a year summarized, with vector instructions.
+ */
+struct REMORA_BiomassTensor {
+    int NumYears   = 0;       ///< Number of years, including the initial year
+    int NumSpecies = 0;
+    int NumRuns    = 0;
+    std::vector<double> Values;          ///< Biomass at [(year*NumSpecies + species)*NumRuns + run]
+    std::shared_ptr<const double> Mapped; ///< Read-only biomass mapped from a REMORA_ForecastStore file, used instead of Values if set
+
+    void resize(const int& numYears, const int& numSpecies, const int& numRuns) {
+        NumYears   = numYears;
+        NumSpecies = numSpecies;
+        NumRuns    = numRuns;
+        Mapped.reset();
+        Values.assign(size_t(numYears)*numSpecies*numRuns,0.0);
+    }
+    /**
+     * @brief Copies mapped biomass into Values so that it may be modified and the
+     * mapped file may be replaced
+     */
+    void detach() {
+        if (Mapped) {
+            Values.assign(Mapped.get(),Mapped.get()+size_t(NumYears)*NumSpecies*NumRuns);
+            Mapped.reset();
+        }
+    }
+    bool isMapped() const {
+        return bool(Mapped);
+    }
+    /**
+     * @brief Keeps only the first numRuns runs
+     */
+    void truncateRuns(const int& numRuns) {
+        detach();
+        for (int row=0; row<NumYears*NumSpecies; ++row) {
+            std::copy(Values.begin()+size_t(row)*NumRuns,Values.begin()+size_t(row)*NumRuns+numRuns,
+                      Values.begin()+size_t(row)*numRuns);
+        }
+        NumRuns = numRuns;
+        Values.resize(size_t(NumYears)*NumSpecies*NumRuns);
+    }
+    /**
+     * @brief Returns a pointer to the contiguous biomass of every run for the year and species
+     */
+    double* runs(const int& year, const int& species) {
+        detach();
+        return Values.data() + (size_t(year)*NumSpecies + species)*NumRuns;
+    }
+    const double* runs(const int& year, const int& species) const {
+        return (Mapped ? Mapped.get() : Values.data()) + (size_t(year)*NumSpecies + species)*NumRuns;
+    }
+    /**
+     * @brief Copies a run into a (years x species) matrix
+     */
+    void getRun(const int& run, boost::numeric::ublas::matrix<double>& biomass) const {
+        biomass.resize(NumYears,NumSpecies,false);
+        for (int year=0; year<NumYears; ++year) {
+            for (int species=0; species<NumSpecies; ++species) {
+                biomass(year,species) = runs(year,species)[run];
+            }
+        }
+    }
+    /**
+     * @brief Copies a (years x species) matrix into a run
+     */
+    void setRun(const int& run, const boost::numeric::ublas::matrix<double>& biomass) {
+        for (int year=0; year<NumYears; ++year) {
+            for (int species=0; species<NumSpecies; ++species) {
+                runs(year,species)[run] = biomass(year,species);
+            }
+        }
+    }
+    bool isValid() const {
+        return Mapped || (Values.size() == size_t(NumYears)*NumSpecies*NumRuns);
+    }
+};
+
+/**
+ * @brief The raw forecast biomass produced by a run and consumed by the drawing routines
+ */
+struct REMORA_ForecastData {
+    std::string ProjectName;
+    std::string ModelName;
+    std::string ForecastName;
+    std::string Algorithm;
+    std::string Minimizer;
+    std::string ObjectiveCriterion;
+    std::string Scaling;
+    int NumSpecies         = 0;
+    int NumYearsPerRun     = 0;
+    int NumRunsPerForecast = 0;                                            ///< Number of runs in BiomassTensor
+    int NumRunsRequested   = 0;                                            ///< Number of runs requested (more than NumRunsPerForecast if an adaptive forecast converged early)
+    bool IsConverged       = false;                                        ///< True if an adaptive forecast stopped early because its quantiles converged
+    REMORA_BiomassTensor BiomassTensor;                                    ///< The Monte Carlo runs as a dense (year x species x run) tensor
+    std::vector<boost::numeric::ublas::matrix<double> > Biomass;           ///< Single (years x species) matrix without uncertainty
+    std::vector<bool> MonteCarloSpeciesLoaded;                             ///< Species whose runs have been read when reading one species at a time from the database (empty if all have)
+    uint64_t BaseSeed      = 0;                                            ///< Base random number seed of the forecast
+    std::vector<uint64_t> Seeds;                                           ///< Random number seed of each run (empty if not simulated by REMORA)
+    std::vector<std::vector<std::string> > HoverData;                      ///< Hover text per [species][run], the last run being without uncertainty
+    std::vector<bool> RecomputedSpecies;                                   ///< Species simulated by the last run (empty if all were loaded)
+
+    /**
+     * @brief Returns true if the data contain a complete forecast
+     */
+    bool isValid() const {
+        return (NumSpecies > 0) &&
+               (BiomassTensor.NumRuns == NumRunsPerForecast) && BiomassTensor.isValid() &&
+               (Biomass.size() == 1);
+    }
+    /**
+     * @brief Returns true if the data were generated for the passed forecast, algorithm, and run
+     * dimensions, the number of runs being the number requested
+     */
+    bool matches(const std::string& projectName,
+                 const std::string& modelName,
+                 const std::string& forecastName,
+                 const std::string& algorithm,
+                 const std::string& minimizer,
+                 const std::string& objectiveCriterion,
+                 const std::string& scaling,
+                 const int&         numSpecies,
+                 const int&         numYearsPerRun,
+                 const int&         numRunsPerForecast) const {
+        return isValid() &&
+               (ProjectName        == projectName)        &&
+               (ModelName          == modelName)          &&
+               (ForecastName       == forecastName)       &&
+               (Algorithm          == algorithm)          &&
+               (Minimizer          == minimizer)          &&
+               (ObjectiveCriterion == objectiveCriterion) &&
+               (Scaling            == scaling)            &&
+               (NumSpecies         == numSpecies)         &&
+               (NumYearsPerRun     == numYearsPerRun)     &&
+               (NumRunsRequested   == numRunsPerForecast);
+    }
+    /**
+     * @brief Returns true if the Monte Carlo runs of the passed species are held
+     */
+    bool isMonteCarloLoaded(const int& species) const {
+        return MonteCarloSpeciesLoaded.empty() || MonteCarloSpeciesLoaded[species];
+    }
+    void clear() {
+        NumSpecies         = 0;
+        NumYearsPerRun     = 0;
+        NumRunsPerForecast = 0;
+        NumRunsRequested   = 0;
+        IsConverged        = false;
+        BiomassTensor = REMORA_BiomassTensor();
+        Biomass.clear();
+        MonteCarloSpeciesLoaded.clear();
+        BaseSeed           = 0;
+        Seeds.clear();
+        HoverData.clear();
+        RecomputedSpecies.clear();
+    }
+};
+
+/**
+ * @brief A contiguous range of Monte Carlo runs sent to the GUI thread while the
+ * remainder of the forecast is still being simulated
+ */
+struct REMORA_RunBatch {
+    std::string ProjectName;
+    std::string ModelName;
+    std::string ForecastName;
+    int NumSpecies         = 0;
+    int NumYearsPerRun     = 0;
+    int NumRunsPerForecast = 0;
+    int FirstRun           = 0;                                            ///< Run number of the first matrix in BiomassMonteCarlo
+    std::vector<boost::numeric::ublas::matrix<double> > BiomassMonteCarlo; ///< One (years x species) matrix per run in the batch
+    std::vector<boost::numeric::ublas::matrix<double> > Biomass;           ///< The forecast without uncertainty (first batch only)
+};
+
+Q_DECLARE_METATYPE(REMORA_RunSettings)
+Q_DECLARE_METATYPE(REMORA_ForecastData)
+Q_DECLARE_METATYPE(REMORA_RunBatch)
+
+#endif // REMORA_FORECASTDATA_H
@@ -0,0 +1,668 @@
+#include "REMORA_ForecastEngine.h"
+#include "REMORA_Statistics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define REMORA_USE_SSE2
+#endif
+
+const uint64_t REMORA_ForecastEngine::DeterministicSeed = 1;
+const int      REMORA_ForecastEngine::LockstepChunkSize = 64;
+
+
+REMORA_ForecastEngine::REMORA_ForecastEngine(int numThreads)
+{
+    if (numThreads <= 0) {
+        numThreads = int(std::thread::hardware_concurrency());
+    }
+    m_NumThreads = std::max(1,numThreads);
+}
+
+REMORA_ForecastEngine::~REMORA_ForecastEngine()
+{
+}
+
+bool
+REMORA_ForecastEngine::isSupported(
+        const REMORA_ModelParameters& parameters,
+        std::string&                  errorMsg)
+{
+    errorMsg.clear();
+
+    if ((parameters.GrowthForm != "Null")   &&
+        (parameters.GrowthForm != "Linear") &&
+        (parameters.GrowthForm != "Logistic")) {
+        errorMsg = "Unsupported growth form: " + parameters.GrowthForm;
+    } else if ((parameters.HarvestForm != "Null")        &&
+               (parameters.HarvestForm != "Catch")       &&
+               (parameters.HarvestForm != "Effort (qE)") &&
+               (parameters.HarvestForm != "Exploitation (F)")) {
+        errorMsg = "Unsupported harvest form: " + parameters.HarvestForm;
+    } else if ((parameters.CompetitionForm != "Null") &&
+               (parameters.CompetitionForm != "NO_K") &&
+               (parameters.CompetitionForm != "MS-PROD")) {
+        errorMsg = "Unsupported competition form: " + parameters.CompetitionForm;
+    } else if ((parameters.PredationForm != "Null")     &&
+               (parameters.PredationForm != "Type I")   &&
+               (parameters.PredationForm != "Type II")  &&
+               (parameters.PredationForm != "Type III")) {
+        errorMsg = "Unsupported predation form: " + parameters.PredationForm;
+    }
+
+    return errorMsg.empty();
+}
+
+uint64_t
+REMORA_ForecastEngine::splitMix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+double
+REMORA_ForecastEngine::drawUniform(uint64_t& state)
+{
+    // Uniform on [-1,1)
+    return 2.0*double(splitMix64(state) >> 11)*(1.0/9007199254740992.0) - 1.0;
+}
+
+uint64_t
+REMORA_ForecastEngine::runSeed(const uint64_t& baseSeed, const int& runNum)
+{
+    uint64_t state = baseSeed ^ (0xD1B54A32D192ED03ULL * uint64_t(runNum+1));
+    return splitMix64(state);
+}
+
+void
+REMORA_ForecastEngine::simulateRun(
+        const REMORA_ModelParameters&          parameters,
+        const int&                             numYearsPerRun,
+        const double&                          growthMultiplier,
+        const double&                          carryingCapacityMultiplier,
+        const std::vector<double>&             harvestMultipliers,
+        const std::vector<bool>&               recomputeSpecies,
+        boost::numeric::ublas::matrix<double>& biomass)
+{
+    int NumSpecies = int(parameters.InitBiomass.size());
+    bool isLogistic   = (parameters.GrowthForm      == "Logistic");
+    bool isLinear     = (parameters.GrowthForm      == "Linear");
+    bool isCatch      = (parameters.HarvestForm     == "Catch");
+    bool isEffort     = (parameters.HarvestForm     == "Effort (qE)");
+    bool isExploit    = (parameters.HarvestForm     == "Exploitation (F)");
+    bool isNoK        = (parameters.CompetitionForm == "NO_K");
+    bool isMSProd     = (parameters.CompetitionForm == "MS-PROD");
+    bool isTypeI      = (parameters.PredationForm   == "Type I");
+    bool isTypeII     = (parameters.PredationForm   == "Type II");
+    bool isTypeIII    = (parameters.PredationForm   == "Type III");
+    double Bi;
+    double Bj;
+    double r;
+    double K;
+    double growth;
+    double harvest;
+    double competition;
+    double predation;
+    double preyTerm;
+    std::vector<double> GrowthRate(NumSpecies);
+    std::vector<double> CarryingCapacity(NumSpecies);
+
+    for (int species=0; species<NumSpecies; ++species) {
+        GrowthRate[species]       = parameters.GrowthRate[species]       * growthMultiplier;
+        CarryingCapacity[species] = parameters.CarryingCapacity[species] * carryingCapacityMultiplier;
+    }
+
+    // Species that aren't recomputed keep their previous biomass
+    biomass.resize(numYearsPerRun+1,NumSpecies,true);
+    for (int species=0; species<NumSpecies; ++species) {
+        if (recomputeSpecies[species]) {
+            biomass(0,species) = parameters.InitBiomass[species];
+        }
+    }
+
+    for (int time=0; time<numYearsPerRun; ++time) {
+        for (int species=0; species<NumSpecies; ++species) {
+            if (! recomputeSpecies[species]) {
+                continue;
+            }
+            Bi = biomass(time,species);
+            r  = GrowthRate[species];
+            K  = CarryingCapacity[species];
+
+            // Growth
+            growth = 0;
+            if (isLinear) {
+                growth = r*Bi;
+            } else if (isLogistic && (K > 0)) {
+                growth = r*Bi*(1.0 - Bi/K);
+            }
+
+            // Harvest
+            harvest = parameters.Harvest(time,species) * harvestMultipliers[time*NumSpecies+species];
+            if (isEffort) {
+                harvest *= parameters.Catchability[species]*Bi;
+            } else if (isExploit) {
+                harvest *= Bi;
+            } else if (! isCatch) {
+                harvest = 0;
+            }
+
+            // Competition and predation
+            competition = 0;
+            predation   = 0;
+            for (int other=0; other<NumSpecies; ++other) {
+                Bj = biomass(time,other);
+                if (isNoK) {
+                    competition += parameters.CompetitionAlpha(species,other)*Bi*Bj;
+                } else if (isMSProd && (other != species) && (K > 0)) {
+                    competition += (r/K)*parameters.CompetitionBeta(species,other)*Bi*Bj;
+                }
+                if (isTypeI) {
+                    predation += parameters.PredationRho(species,other)*Bi*Bj;
+                } else if (isTypeII) {
+                    preyTerm   = parameters.PredationRho(species,other)*Bi;
+                    predation += preyTerm*Bj/(1.0 + parameters.PredationHandling(species,other)*preyTerm);
+                } else if (isTypeIII) {
+                    preyTerm   = parameters.PredationRho(species,other)*std::pow(Bi,1.0+parameters.PredationExponent[other]);
+                    predation += preyTerm*Bj/(1.0 + parameters.PredationHandling(species,other)*preyTerm);
+                }
+            }
+
+            biomass(time+1,species) = std::max(0.0, Bi + growth - harvest - competition - predation);
+        }
+    }
+}
+
+bool
+REMORA_ForecastEngine::isLockstepSupported(const REMORA_ModelParameters& parameters)
+{
+    // Without competition or predation the species are independent and every run of a
+    // species may be stepped at once
+    return (parameters.CompetitionForm == "Null") &&
+           (parameters.PredationForm   == "Null") &&
+           ((parameters.GrowthForm  == "Null") || (parameters.GrowthForm  == "Linear") ||
+            (parameters.GrowthForm  == "Logistic")) &&
+           ((parameters.HarvestForm == "Null") || (parameters.HarvestForm == "Catch")  ||
+            (parameters.HarvestForm == "Effort (qE)") || (parameters.HarvestForm == "Exploitation (F)"));
+}
+
+void
+REMORA_ForecastEngine::simulateRunsLockstep(
+        const REMORA_ModelParameters& parameters,
+        const int&                    numYearsPerRun,
+        const int&                    firstRun,
+        const int&                    numRuns,
+        const double*                 growthMultipliers,
+        const double*                 carryingCapacityMultipliers,
+        const double*                 harvestMultipliers,
+        const std::vector<bool>&      recomputeSpecies,
+        REMORA_BiomassTensor&         biomass)
+{
+    int NumSpecies = int(parameters.InitBiomass.size());
+    bool isLogistic = (parameters.GrowthForm  == "Logistic");
+    bool isLinear   = (parameters.GrowthForm  == "Linear");
+    bool isCatch    = (parameters.HarvestForm == "Catch");
+    bool isEffort   = (parameters.HarvestForm == "Effort (qE)");
+    bool isExploit  = (parameters.HarvestForm == "Exploitation (F)");
+    bool isHarvest  = isCatch || isEffort || isExploit;
+    int run;
+    double Bi;
+    double growth;
+    double harvest;
+    double harvestPerBiomass;
+    std::vector<double> r(numRuns);
+    std::vector<double> K(numRuns);
+
+    for (int species=0; species<NumSpecies; ++species) {
+        if (! recomputeSpecies[species]) {
+            continue;
+        }
+        for (run=0; run<numRuns; ++run) {
+            r[run] = parameters.GrowthRate[species]       * growthMultipliers[run];
+            K[run] = parameters.CarryingCapacity[species] * carryingCapacityMultipliers[run];
+        }
+        harvestPerBiomass = (isEffort) ? parameters.Catchability[species] : 1.0;
+        std::fill(biomass.runs(0,species)+firstRun,biomass.runs(0,species)+firstRun+numRuns,
+                  parameters.InitBiomass[species]);
+
+        // Same arithmetic, in the same order, as simulateRun so that both give identical results
+        for (int time=0; time<numYearsPerRun; ++time) {
+            const double* B     = biomass.runs(time,species)   + firstRun;
+            double*       BNext = biomass.runs(time+1,species) + firstRun;
+            const double* hm    = harvestMultipliers + size_t(time*NumSpecies+species)*numRuns;
+            double H = parameters.Harvest(time,species);
+            run = 0;
+#ifdef REMORA_USE_SSE2
+            const __m128d zero   = _mm_setzero_pd();
+            const __m128d one    = _mm_set1_pd(1.0);
+            const __m128d vH     = _mm_set1_pd(H);
+            const __m128d vPerB  = _mm_set1_pd(harvestPerBiomass);
+            for (; run+2<=numRuns; run+=2) {
+                __m128d vB = _mm_loadu_pd(B+run);
+                __m128d vr = _mm_loadu_pd(&r[run]);
+                __m128d vK = _mm_loadu_pd(&K[run]);
+                __m128d vGrowth = zero;
+                if (isLinear) {
+                    vGrowth = _mm_mul_pd(vr,vB);
+                } else if (isLogistic) {
+                    // Runs whose K isn't positive don't grow
+                    vGrowth = _mm_mul_pd(_mm_mul_pd(vr,vB),_mm_sub_pd(one,_mm_div_pd(vB,vK)));
+                    vGrowth = _mm_and_pd(_mm_cmpgt_pd(vK,zero),vGrowth);
+                }
+                __m128d vHarvest = zero;
+                if (isHarvest) {
+                    vHarvest = _mm_mul_pd(vH,_mm_loadu_pd(hm+run));
+                    if (isEffort) {
+                        vHarvest = _mm_mul_pd(vHarvest,_mm_mul_pd(vPerB,vB));
+                    } else if (isExploit) {
+                        vHarvest = _mm_mul_pd(vHarvest,vB);
+                    }
+                }
+                _mm_storeu_pd(BNext+run,_mm_max_pd(_mm_sub_pd(_mm_add_pd(vB,vGrowth),vHarvest),zero));
+            }
+#endif
+            for (; run<numRuns; ++run) {
+                Bi = B[run];
+                growth = 0;
+                if (isLinear) {
+                    growth = r[run]*Bi;
+                } else if (isLogistic && (K[run] > 0)) {
+                    growth = r[run]*Bi*(1.0 - Bi/K[run]);
+                }
+                harvest = 0;
+                if (isHarvest) {
+                    harvest = H*hm[run];
+                    if (isEffort) {
+                        harvest *= harvestPerBiomass*Bi;
+                    } else if (isExploit) {
+                        harvest *= Bi;
+                    }
+                }
+                BNext[run] = std::max(0.0, Bi + growth - harvest);
+            }
+        }
+    }
+}
+
+void
+REMORA_ForecastEngine::simulate(
+        const REMORA_ModelParameters&          parameters,
+        const int&                             numYearsPerRun,
+        boost::numeric::ublas::matrix<double>& biomass)
+{
+    int NumSpecies = int(parameters.InitBiomass.size());
+    std::vector<double> noUncertainty(numYearsPerRun*NumSpecies,1.0);
+    std::vector<bool>   allSpecies(NumSpecies,true);
+
+    simulateRun(parameters,numYearsPerRun,1.0,1.0,noUncertainty,allSpecies,biomass);
+}
+
+std::vector<bool>
+REMORA_ForecastEngine::changedSpecies(
+        const REMORA_ModelParameters& previous,
+        const REMORA_ModelParameters& parameters)
+{
+    int NumSpecies = int(parameters.InitBiomass.size());
+    bool sameForms = (previous.GrowthForm        == parameters.GrowthForm)        &&
+                     (previous.HarvestForm       == parameters.HarvestForm)       &&
+                     (previous.CompetitionForm   == parameters.CompetitionForm)   &&
+                     (previous.PredationForm     == parameters.PredationForm)     &&
+                     (previous.PredationExponent == parameters.PredationExponent) &&
+                     (int(previous.InitBiomass.size()) == NumSpecies)             &&
+                     (previous.Harvest.size1() == parameters.Harvest.size1())     &&
+                     (previous.Harvest.size2() == parameters.Harvest.size2());
+    std::vector<bool> changed(NumSpecies,true);
+
+    if (! sameForms) {
+        return changed;
+    }
+
+    // A species has changed if any of its own parameters, any of the interaction
+    // coefficients acting upon it, or any of its forecast harvest has changed.
+    for (int species=0; species<NumSpecies; ++species) {
+        bool isChanged = (previous.InitBiomass[species]      != parameters.InitBiomass[species])      ||
+                         (previous.GrowthRate[species]       != parameters.GrowthRate[species])       ||
+                         (previous.CarryingCapacity[species] != parameters.CarryingCapacity[species]) ||
+                         (previous.Catchability[species]     != parameters.Catchability[species]);
+        for (int other=0; other<NumSpecies && ! isChanged; ++other) {
+            isChanged = (previous.CompetitionAlpha(species,other)  != parameters.CompetitionAlpha(species,other)) ||
+                        (previous.CompetitionBeta(species,other)   != parameters.CompetitionBeta(species,other))  ||
+                        (previous.PredationRho(species,other)      != parameters.PredationRho(species,other))     ||
+                        (previous.PredationHandling(species,other) != parameters.PredationHandling(species,other));
+        }
+        for (unsigned time=0; time<parameters.Harvest.size1() && ! isChanged; ++time) {
+            isChanged = (previous.Harvest(time,species) != parameters.Harvest(time,species));
+        }
+        changed[species] = isChanged;
+    }
+    return changed;
+}
+
+std::vector<bool>
+REMORA_ForecastEngine::dependencyClosure(
+        const REMORA_ModelParameters& parameters,
+        const std::vector<bool>&      changedSpecies)
+{
+    int NumSpecies = int(changedSpecies.size());
+    int species;
+    bool isNoK       = (parameters.CompetitionForm == "NO_K");
+    bool isMSProd    = (parameters.CompetitionForm == "MS-PROD");
+    bool isPredation = (parameters.PredationForm   != "Null");
+    std::vector<bool> closure = changedSpecies;
+    std::vector<int>  pending;
+
+    for (int i=0; i<NumSpecies; ++i) {
+        if (closure[i]) {
+            pending.push_back(i);
+        }
+    }
+
+    // A species must be recomputed if it interacts with any species being recomputed
+    while (! pending.empty()) {
+        species = pending.back();
+        pending.pop_back();
+        for (int other=0; other<NumSpecies; ++other) {
+            if (closure[other] || (other == species)) {
+                continue;
+            }
+            if ((isNoK       && (parameters.CompetitionAlpha(other,species) != 0)) ||
+                (isMSProd    && (parameters.CompetitionBeta(other,species)  != 0)) ||
+                (isPredation && (parameters.PredationRho(other,species)     != 0))) {
+                closure[other] = true;
+                pending.push_back(other);
+            }
+        }
+    }
+    return closure;
+}
+
+void
+REMORA_ForecastEngine::convergenceStatistics(
+        const REMORA_ModelParameters&      parameters,
+        const REMORA_ForecastData&         data,
+        const int&                         numRuns,
+        std::vector<std::vector<double> >& statistics)
+{
+    int NumSpecies = data.NumSpecies;
+    int NumYears   = data.NumYearsPerRun;
+    double biomass;
+    std::vector<double> biomassValues(numRuns);
+    std::vector<double> fishingMortalityValues(numRuns);
+    std::vector<double> quantiles;
+    const std::vector<double> probabilities = {0.05,0.5,0.95};
+
+    // One series of (5th, 50th, 95th) percentiles per year for each species' biomass and F
+    statistics.assign(2*NumSpecies,std::vector<double>());
+    for (int species=0; species<NumSpecies; ++species) {
+        for (int time=0; time<=NumYears; ++time) {
+            const double* runs = data.BiomassTensor.runs(time,species);
+            for (int runNum=0; runNum<numRuns; ++runNum) {
+                biomass = runs[runNum];
+                biomassValues[runNum]          = biomass;
+                fishingMortalityValues[runNum] = (biomass > 0) ? parameters.Harvest(time,species)/biomass : 0;
+            }
+            quantiles = REMORA_Statistics::quantiles(biomassValues,probabilities);
+            statistics[2*species].insert(statistics[2*species].end(),quantiles.begin(),quantiles.end());
+            quantiles = REMORA_Statistics::quantiles(fishingMortalityValues,probabilities);
+            statistics[2*species+1].insert(statistics[2*species+1].end(),quantiles.begin(),quantiles.end());
+        }
+    }
+}
+
+void
+REMORA_ForecastEngine::latinHypercubeStrata(
+        const uint64_t&   baseSeed,
+        const int&        firstRun,
+        const int&        numRuns,
+        const int&        numDimensions,
+        std::vector<int>& strata)
+{
+    uint64_t state = runSeed(baseSeed ^ 0x4C48530000000000ULL,firstRun); // "LHS"
+
+    // An independent random permutation of the strata for every dimension
+    strata.resize(numRuns*numDimensions);
+    for (int dimension=0; dimension<numDimensions; ++dimension) {
+        int* permutation = &strata[dimension*numRuns];
+        for (int i=0; i<numRuns; ++i) {
+            permutation[i] = i;
+        }
+        for (int i=numRuns-1; i>0; --i) {
+            std::swap(permutation[i],permutation[splitMix64(state) % uint64_t(i+1)]);
+        }
+    }
+}
+
+double
+REMORA_ForecastEngine::largestChange(
+        const std::vector<std::vector<double> >& previous,
+        const std::vector<std::vector<double> >& statistics)
+{
+    double range;
+    double change = 0;
+
+    // Changes are relative to the largest value of each series so that years in which
+    // a quantile is near zero don't prevent convergence
+    for (unsigned i=0; i<statistics.size(); ++i) {
+        range = 0;
+        for (const double& value : statistics[i]) {
+            range = std::max(range,std::fabs(value));
+        }
+        if (range <= 0) {
+            continue;
+        }
+        for (unsigned j=0; j<statistics[i].size(); ++j) {
+            change = std::max(change,std::fabs(statistics[i][j]-previous[i][j])/range);
+        }
+    }
+    return change;
+}
+
+bool
+REMORA_ForecastEngine::run(
+        const REMORA_ModelParameters&       parameters,
+        const REMORA_RunSettings&           settings,
+        const uint64_t&                     baseSeed,
+        const std::vector<bool>&            recomputeSpecies,
+        REMORA_ForecastData&                data,
+        const std::function<bool(int)>&     progress,
+        const std::function<void(int,int)>& runsAvailable)
+{
+    int NumSpecies     = int(parameters.InitBiomass.size());
+    int NumYearsPerRun = settings.NumYearsPerRun;
+    int NumRuns        = settings.NumRunsPerForecast;
+    int NumThreads     = std::min(m_NumThreads,std::max(1,NumRuns));
+    int BatchSize      = (settings.IsAdaptive) ? std::max(1,settings.AdaptiveBatchSize) : NumRuns;
+    int NumConverged   = 0;
+    int NumDimensions  = 2 + NumYearsPerRun*NumSpecies;
+    int batchStart     = 0;
+    int runLimit       = 0;
+    bool isLatinHypercube = (settings.SamplingMethod == "Latin Hypercube");
+    bool isLockstep       = isLockstepSupported(parameters);
+    bool isIncremental = (int(recomputeSpecies.size()) == NumSpecies) &&
+                         (data.NumSpecies         == NumSpecies)     &&
+                         (data.NumYearsPerRun     == NumYearsPerRun) &&
+                         (data.NumRunsPerForecast == NumRuns)        &&
+                         (data.BaseSeed           == baseSeed)       &&
+                         ! settings.IsAdaptive                       &&
+                          data.isValid();
+    std::vector<bool> recompute = (isIncremental) ? recomputeSpecies : std::vector<bool>(NumSpecies,true);
+    std::atomic<int>  nextRun(0);
+    std::atomic<int>  runsCompleted(0);
+    std::atomic<bool> cancelled(false);
+    std::unique_ptr<std::atomic<bool>[]> isRunDone(new std::atomic<bool>[std::max(1,NumRuns)]);
+    int runsReported = 0;
+    std::vector<double> noUncertainty(NumYearsPerRun*NumSpecies,1.0);
+    std::vector<double> GrowthMultipliers(NumRuns);
+    std::vector<double> CarryingCapacityMultipliers(NumRuns);
+    std::vector<std::thread> threads;
+    std::vector<int> strata;
+    std::vector<std::vector<double> > statistics;
+    std::vector<std::vector<double> > previousStatistics;
+
+    if (! isIncremental) {
+        data.NumSpecies         = NumSpecies;
+        data.NumYearsPerRun     = NumYearsPerRun;
+        data.NumRunsPerForecast = NumRuns;
+        data.NumRunsRequested   = NumRuns;
+        data.IsConverged        = false;
+        data.BaseSeed           = baseSeed;
+        data.BiomassTensor.resize(NumYearsPerRun+1,NumSpecies,NumRuns);
+        data.Biomass.assign(1,boost::numeric::ublas::matrix<double>());
+        data.Seeds.assign(NumRuns,0);
+    }
+    // The threads write the runs in place, so a mapped tensor is copied first
+    data.BiomassTensor.detach();
+    data.RecomputedSpecies = recompute;
+
+    for (int runNum=0; runNum<NumRuns; ++runNum) {
+        isRunDone[runNum] = false;
+    }
+
+    // The forecast without any uncertainty
+    simulateRun(parameters,NumYearsPerRun,1.0,1.0,noUncertainty,recompute,data.Biomass[0]);
+
+    // Runs finish in any order but are reported as contiguous ranges from the first run on
+    auto reportRuns = [&]() {
+        int firstRun = runsReported;
+        while ((runsReported < NumRuns) && isRunDone[runsReported]) {
+            ++runsReported;
+        }
+        if (runsReported > firstRun) {
+            runsAvailable(firstRun,runsReported);
+        }
+    };
+
+    // With Latin hypercube sampling each batch of runs divides every dimension (r, K, and
+    // each year's harvest of each species) into one stratum per run, and each run draws
+    // from a different stratum of every dimension.
+    auto draw = [&](uint64_t& state, const int& runNum, const int& dimension) {
+        double value = drawUniform(state);
+        if (isLatinHypercube) {
+            int NumBatchRuns = runLimit-batchStart;
+            value = 2.0*(strata[dimension*NumBatchRuns+runNum-batchStart] + 0.5*(value+1.0))/NumBatchRuns - 1.0;
+        }
+        return value;
+    };
+
+    // Each run draws its parameter multipliers from its own generator so that the
+    // results don't depend upon the number of threads, the order of the runs, or
+    // which species are being recomputed.
+    auto drawMultipliers = [&](const int& runNum, double* harvestMultipliers, const int& stride) {
+        uint64_t state = runSeed(baseSeed,runNum);
+        data.Seeds[runNum] = state;
+        GrowthMultipliers[runNum]           = 1.0 + settings.GrowthUncertainty*draw(state,runNum,0);
+        CarryingCapacityMultipliers[runNum] = 1.0 + settings.CarryingCapacityUncertainty*draw(state,runNum,1);
+        for (int i=0; i<NumYearsPerRun*NumSpecies; ++i) {
+            harvestMultipliers[i*stride] = 1.0 + settings.HarvestUncertainty*draw(state,runNum,2+i);
+        }
+    };
+
+    // Runs are simulated singly, or in chunks stepped in lockstep if the model's species
+    // are independent. A single run is simulated in a matrix and copied into the tensor.
+    auto simulateRuns = [&](bool reportProgress) {
+        int runNum;
+        int numChunkRuns;
+        std::vector<double> harvestMultipliers(NumYearsPerRun*NumSpecies*((isLockstep) ? LockstepChunkSize : 1));
+        boost::numeric::ublas::matrix<double> run;
+        while (! cancelled) {
+            runNum = nextRun.fetch_add((isLockstep) ? LockstepChunkSize : 1);
+            if (runNum >= runLimit) {
+                break;
+            }
+            numChunkRuns = (isLockstep) ? std::min(LockstepChunkSize,runLimit-runNum) : 1;
+            if (isLockstep) {
+                for (int i=0; i<numChunkRuns; ++i) {
+                    drawMultipliers(runNum+i,&harvestMultipliers[i],numChunkRuns);
+                }
+                simulateRunsLockstep(parameters,NumYearsPerRun,runNum,numChunkRuns,
+                                     &GrowthMultipliers[runNum],&CarryingCapacityMultipliers[runNum],
+                                     harvestMultipliers.data(),recompute,data.BiomassTensor);
+            } else {
+                // Species that aren't recomputed keep the run's previous biomass
+                drawMultipliers(runNum,harvestMultipliers.data(),1);
+                data.BiomassTensor.getRun(runNum,run);
+                simulateRun(parameters,NumYearsPerRun,
+                            GrowthMultipliers[runNum],CarryingCapacityMultipliers[runNum],
+                            harvestMultipliers,recompute,run);
+                data.BiomassTensor.setRun(runNum,run);
+            }
+            for (int i=runNum; i<runNum+numChunkRuns; ++i) {
+                isRunDone[i] = true;
+            }
+            runsCompleted += numChunkRuns;
+            if (reportProgress && ! progress(runsCompleted)) {
+                cancelled = true;
+            }
+            if (reportProgress && runsAvailable && ! cancelled) {
+                reportRuns();
+            }
+        }
+    };
+
+    // An adaptive forecast adds batches of runs until none of the tracked quantiles have
+    // changed by more than the tolerance for two consecutive batches. Each batch is
+    // complete before it's checked so the number of runs doesn't depend upon the threads.
+    while (runLimit < NumRuns) {
+        batchStart = runLimit;
+        nextRun    = runLimit;
+        runLimit   = std::min(NumRuns,runLimit+BatchSize);
+        if (isLatinHypercube) {
+            latinHypercubeStrata(baseSeed,batchStart,runLimit-batchStart,NumDimensions,strata);
+        }
+        threads.clear();
+        for (int i=1; i<NumThreads; ++i) {
+            threads.emplace_back(simulateRuns,false);
+        }
+        simulateRuns(true);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        if (cancelled || ! progress(runsCompleted)) {
+            return false;
+        }
+        if (runsAvailable) {
+            reportRuns();
+        }
+        if (settings.IsAdaptive && (runLimit < NumRuns)) {
+            convergenceStatistics(parameters,data,runLimit,statistics);
+            NumConverged = (! previousStatistics.empty() &&
+                            (largestChange(previousStatistics,statistics) <= settings.ConvergenceTolerance)) ?
+                            NumConverged+1 : 0;
+            previousStatistics.swap(statistics);
+            if (NumConverged >= 2) {
+                data.NumRunsPerForecast = runLimit;
+                data.IsConverged        = true;
+                data.BiomassTensor.truncateRuns(runLimit);
+                data.Seeds.resize(runLimit);
+                break;
+            }
+        }
+    }
+    NumRuns = data.NumRunsPerForecast;
+
+    // Hover text for each run (and for the run without uncertainty)
+    std::ostringstream hover;
+    data.HoverData.assign(NumSpecies,std::vector<std::string>(NumRuns+1));
+    for (int species=0; species<NumSpecies; ++species) {
+        for (int runNum=0; runNum<=NumRuns; ++runNum) {
+            double growthMultiplier           = (runNum < NumRuns) ? GrowthMultipliers[runNum]           : 1.0;
+            double carryingCapacityMultiplier = (runNum < NumRuns) ? CarryingCapacityMultipliers[runNum] : 1.0;
+            hover.str("");
+            hover << std::setprecision(4)
+                  << "r: " << parameters.GrowthRate[species]*growthMultiplier
+                  << ", K: " << parameters.CarryingCapacity[species]*carryingCapacityMultiplier;
+            data.HoverData[species][runNum] = hover.str();
+        }
+    }
+
+    return true;
+}
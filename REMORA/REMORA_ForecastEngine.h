@@ -0,0 +1,212 @@
+/**
+ * @file REMORA_ForecastEngine.h
+ * @brief Definition for the REMORA in-process Monte Carlo forecast engine
+ *
+ * This file contains the definition of the forecast engine that REMORA uses to
+ * simulate the Monte Carlo forecast runs itself rather than waiting for the host
+ * application to simulate them and write them to the database. The runs are
+ * distributed over all available cores and each run uses its own reproducible seed.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+#ifndef REMORA_FORECASTENGINE_H
+#define REMORA_FORECASTENGINE_H
+
+#include "REMORA_ForecastData.h"
+
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The estimated model parameters and forecast harvest needed to simulate a forecast
+ */
+struct REMORA_ModelParameters {
+    std::string GrowthForm;
+    std::string HarvestForm;
+    std::string CompetitionForm;
+    std::string PredationForm;
+    std::vector<double> InitBiomass;       ///< Estimated biomass in the last observed year, per species
+    std::vector<double> GrowthRate;        ///< r, per species
+    std::vector<double> CarryingCapacity;  ///< K, per species
+    std::vector<double> Catchability;      ///< q, per species
+    std::vector<double> PredationExponent; ///< b, per predator
+    boost::numeric::ublas::matrix<double> CompetitionAlpha;  ///< alpha(i,j): effect of species j on species i
+    boost::numeric::ublas::matrix<double> CompetitionBeta;   ///< beta(i,j): effect of species j on species i
+    boost::numeric::ublas::matrix<double> PredationRho;      ///< rho(i,j): predation of predator j on prey i
+    boost::numeric::ublas::matrix<double> PredationHandling; ///< h(i,j): handling time of predator j on prey i
+    boost::numeric::ublas::matrix<double> Harvest;           ///< (years x species) forecast catch, effort, or exploitation
+    std::vector<double> LastHarvest;       ///< Catch, effort, or exploitation in the last observed year, per species
+};
+
+Q_DECLARE_METATYPE(REMORA_ModelParameters)
+
+/**
+ * @brief Multithreaded Monte Carlo simulator for the MSSPM forecast model
+ *
+ * The engine supports the Null, Linear, and Logistic growth forms, the Null, Catch,
+ * Effort (qE), and Exploitation (F) harvest forms, the Null, NO_K, and MS-PROD
+ * competition forms, and the Null, Type I, Type II, and Type III predation forms.
+ */
+class REMORA_ForecastEngine
+{
+
+private:
+    int m_NumThreads;
+
+    static void convergenceStatistics(
+            const REMORA_ModelParameters&      parameters,
+            const REMORA_ForecastData&         data,
+            const int&                         numRuns,
+            std::vector<std::vector<double> >& statistics);
+    static double drawUniform(uint64_t& state);
+    static bool isLockstepSupported(const REMORA_ModelParameters& parameters);
+    static void latinHypercubeStrata(
+            const uint64_t&   baseSeed,
+            const int&        firstRun,
+            const int&        numRuns,
+            const int&        numDimensions,
+            std::vector<int>& strata);
+    static double largestChange(
+            const std::vector<std::vector<double> >& previous,
+            const std::vector<std::vector<double> >& statistics);
+    static uint64_t splitMix64(uint64_t& state);
+    void simulateRun(
+            const REMORA_ModelParameters&          parameters,
+            const int&                             numYearsPerRun,
+            const double&                          growthMultiplier,
+            const double&                          carryingCapacityMultiplier,
+            const std::vector<double>&             harvestMultipliers,
+            const std::vector<bool>&               recomputeSpecies,
+            boost::numeric::ublas::matrix<double>& biomass);
+    void simulateRunsLockstep(
+            const REMORA_ModelParameters& parameters,
+            const int&                    numYearsPerRun,
+            const int&                    firstRun,
+            const int&                    numRuns,
+            const double*                 growthMultipliers,
+            const double*                 carryingCapacityMultipliers,
+            const double*                 harvestMultipliers,
+            const std::vector<bool>&      recomputeSpecies,
+            REMORA_BiomassTensor&         biomass);
+
+public:
+    /**
+     * @brief Base seed used for deterministic forecasts
+     */
+    static const uint64_t DeterministicSeed;
+    /**
+     * @brief Number of runs stepped together when the model's species are independent
+     */
+    static const int LockstepChunkSize;
+
+    /**
+     * @brief Class definition for the REMORA forecast engine
+     * @param numThreads : number of threads to use (0 signifies use all available cores)
+     */
+    REMORA_ForecastEngine(int numThreads = 0);
+   ~REMORA_ForecastEngine();
+
+    /**
+     * @brief Compares two sets of model parameters and returns the species whose forecast would differ
+     * @param previous : the parameters used for the previous forecast
+     * @param parameters : the parameters for the next forecast
+     * @return Flag per species, true if the species' own parameters or harvest changed
+     */
+    static std::vector<bool> changedSpecies(
+            const REMORA_ModelParameters& previous,
+            const REMORA_ModelParameters& parameters);
+    /**
+     * @brief Extends a set of changed species with every species that interacts with them,
+     * directly or indirectly, through competition or predation
+     * @param parameters : the model parameters
+     * @param changedSpecies : flag per species, true if the species changed
+     * @return Flag per species, true if the species must be recomputed
+     */
+    static std::vector<bool> dependencyClosure(
+            const REMORA_ModelParameters& parameters,
+            const std::vector<bool>&      changedSpecies);
+    /**
+     * @brief Returns true if the engine can simulate the model forms in the passed parameters
+     * @param parameters : the model parameters
+     * @param errorMsg : description of the unsupported form, if any
+     * @return true if supported, false otherwise
+     */
+    static bool isSupported(
+            const REMORA_ModelParameters& parameters,
+            std::string&                  errorMsg);
+    /**
+     * @brief Returns the seed used for a particular run. Seeds depend only on the base seed
+     * and the run number so any single run may be reproduced independently of the others.
+     * @param baseSeed : the forecast's base seed
+     * @param runNum : the run number
+     * @return The run's seed
+     */
+    static uint64_t runSeed(const uint64_t& baseSeed, const int& runNum);
+    /**
+     * @brief Simulates a single forecast without any uncertainty. This is fast enough to be
+     * called from the GUI thread.
+     * @param parameters : the estimated model parameters and forecast harvest
+     * @param numYearsPerRun : number of years to forecast
+     * @param biomass : the simulated (years x species) forecast biomass
+     */
+    void simulate(
+            const REMORA_ModelParameters&          parameters,
+            const int&                             numYearsPerRun,
+            boost::numeric::ublas::matrix<double>& biomass);
+    /**
+     * @brief Simulates the deterministic forecast and all of the Monte Carlo forecast runs. If the
+     * settings are adaptive, runs are added in batches until the 5th, 50th, and 95th percentiles of
+     * every species' biomass and F in every year have changed by no more than the convergence
+     * tolerance for two consecutive batches, or until the maximum number of runs is reached.
+     * The number of runs used is returned in the data's NumRunsPerForecast. With Latin hypercube
+     * sampling each batch (or, if not adaptive, all of the runs) is stratified separately, so a
+     * run's multipliers depend upon the other runs of its batch as well as its own seed.
+     * @param parameters : the estimated model parameters and forecast harvest
+     * @param settings : the forecast settings (years, runs, and uncertainties)
+     * @param baseSeed : the forecast's base seed
+     * @param recomputeSpecies : flag per species, true if the species must be simulated. If the
+     * passed data hold a previous forecast with the same dimensions and base seed, only these
+     * species are simulated and the others are kept, else all species are simulated.
+     * @param data : the simulated forecast biomass
+     * @param progress : function called periodically with the number of runs completed;
+     * returning false cancels the simulation
+     * @param runsAvailable : optional function called from the calling thread with each
+     * range [first,last) of runs that have been simulated, in run order. The deterministic
+     * forecast is simulated before any range is reported.
+     * @return true if all runs were simulated, false if cancelled
+     */
+    bool run(const REMORA_ModelParameters&       parameters,
+             const REMORA_RunSettings&           settings,
+             const uint64_t&                     baseSeed,
+             const std::vector<bool>&            recomputeSpecies,
+             REMORA_ForecastData&                data,
+             const std::function<bool(int)>&     progress,
+             const std::function<void(int,int)>& runsAvailable = nullptr);
+};
+
+#endif // REMORA_FORECASTENGINE_H
@@ -0,0 +1,330 @@
+#include "REMORA_ForecastStore.h"
+
+#include "nmfConstants.h"
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+static const quint32 StoreFileMagic     = 0x524D4653; // "RMFS"
+static const quint32 StoreFileVersion   = 1;
+static const quint32 StoreByteOrderMark = 0x01020304;
+
+namespace {
+
+struct StoreHeader {
+    quint32 Magic;
+    quint32 Version;
+    quint32 ByteOrderMark;
+    quint32 HeaderSize;
+    qint32  NumSpecies;
+    qint32  NumYearsPerRun;
+    qint32  NumRuns;
+    qint32  NumRunsRequested;
+    quint32 IsConverged;
+    quint32 NumHoverRuns;     // Hover strings per species (0 if none)
+    quint64 BaseSeed;
+    quint64 IdentifiersOffset;
+    quint64 IdentifiersSize;
+    quint64 BiomassOffset;    // (years x species) doubles
+    quint64 MonteCarloOffset; // (years x species x runs) doubles
+    quint64 SeedsOffset;      // runs quint64s
+    quint64 HoverOffset;      // length prefixed UTF-8 strings
+    quint64 FileSize;
+};
+
+}
+
+static quint64
+aligned(const quint64& offset, const quint64& alignment)
+{
+    return ((offset + alignment - 1)/alignment)*alignment;
+}
+
+static bool
+writePadded(QSaveFile& file, const char* bytes, const quint64& size, const quint64& alignedSize)
+{
+    static const char padding[64] = {0};
+
+    if ((size > 0) && (file.write(bytes,size) != qint64(size))) {
+        return false;
+    }
+    for (quint64 remaining=alignedSize-size; remaining>0; ) {
+        quint64 chunk = std::min<quint64>(remaining,sizeof(padding));
+        if (file.write(padding,chunk) != qint64(chunk)) {
+            return false;
+        }
+        remaining -= chunk;
+    }
+    return true;
+}
+
+REMORA_ForecastStore::REMORA_ForecastStore(nmfLogger* logger)
+{
+    m_Logger = logger;
+}
+
+REMORA_ForecastStore::~REMORA_ForecastStore()
+{
+}
+
+QString
+REMORA_ForecastStore::filename(
+        const std::string& identifiers,
+        const QString&     extension)
+{
+    QByteArray hash = QCryptographicHash::hash(QByteArray::fromStdString(identifiers),QCryptographicHash::Sha1);
+    return QDir(m_Directory).filePath(QString::fromLatin1(hash.toHex()) + extension);
+}
+
+std::string
+REMORA_ForecastStore::identifiers(const REMORA_ForecastData& data)
+{
+    std::string retv;
+
+    for (const std::string& value : {data.ProjectName, data.ModelName, data.ForecastName,
+                                     data.Algorithm, data.Minimizer,
+                                     data.ObjectiveCriterion, data.Scaling}) {
+        retv += value + "\n";
+    }
+    return retv;
+}
+
+bool
+REMORA_ForecastStore::isEngineForecast(const REMORA_ForecastData& data)
+{
+    return ! m_Directory.isEmpty() && QFile::exists(filename(identifiers(data),".engine"));
+}
+
+bool
+REMORA_ForecastStore::load(REMORA_ForecastData& data)
+{
+    StoreHeader header;
+    std::string ids = identifiers(data);
+
+    if (m_Directory.isEmpty()) {
+        return false;
+    }
+
+    // The file is owned by the tensor's mapped pointer and unmapped when the last copy is released
+    std::shared_ptr<QFile> file = std::make_shared<QFile>(filename(ids));
+    if (! file->open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    quint64 fileSize = quint64(file->size());
+    const uchar* bytes = (fileSize >= sizeof(header)) ? file->map(0,fileSize) : nullptr;
+    if (bytes == nullptr) {
+        return false;
+    }
+    std::memcpy(&header,bytes,sizeof(header));
+
+    quint64 numYears  = quint64(data.NumYearsPerRun) + 1;
+    quint64 numValues = numYears*quint64(data.NumSpecies);
+    bool isValid = (header.Magic            == StoreFileMagic)      &&
+                   (header.Version          == StoreFileVersion)    &&
+                   (header.ByteOrderMark    == StoreByteOrderMark)  &&
+                   (header.FileSize         == fileSize)            &&
+                   (header.NumSpecies       == data.NumSpecies)     &&
+                   (header.NumYearsPerRun   == data.NumYearsPerRun) &&
+                   (header.NumRunsRequested == data.NumRunsRequested) &&
+                   (header.NumRuns > 0) && (header.NumRuns <= header.NumRunsRequested) &&
+                   (header.IdentifiersSize  == ids.size()) &&
+                   (header.IdentifiersOffset+header.IdentifiersSize <= fileSize) &&
+                   (header.BiomassOffset+numValues*sizeof(double) <= fileSize) &&
+                   (header.MonteCarloOffset+numValues*header.NumRuns*sizeof(double) <= fileSize) &&
+                   (header.SeedsOffset+quint64(header.NumRuns)*sizeof(quint64) <= fileSize) &&
+                   (header.HoverOffset <= fileSize) &&
+                   (header.MonteCarloOffset%sizeof(double) == 0);
+    if (! isValid || (std::memcmp(bytes+header.IdentifiersOffset,ids.data(),ids.size()) != 0)) {
+        m_Logger->logMsg(nmfConstants::Warning,"REMORA_ForecastStore: Ignoring stale forecast file: " +
+                         file->fileName().toStdString());
+        return false;
+    }
+
+    // Only the Monte Carlo runs are mapped; the rest is small and copied
+    std::vector<boost::numeric::ublas::matrix<double> > biomass(1,boost::numeric::ublas::matrix<double>(numYears,data.NumSpecies));
+    const double* biomassValues = reinterpret_cast<const double*>(bytes+header.BiomassOffset);
+    for (unsigned year=0; year<numYears; ++year) {
+        for (int species=0; species<data.NumSpecies; ++species) {
+            biomass[0](year,species) = biomassValues[year*data.NumSpecies+species];
+        }
+    }
+    std::vector<uint64_t> seeds(header.NumRuns);
+    std::memcpy(seeds.data(),bytes+header.SeedsOffset,seeds.size()*sizeof(quint64));
+
+    std::vector<std::vector<std::string> > hoverData((header.NumHoverRuns > 0) ? data.NumSpecies : 0,
+                                                     std::vector<std::string>(header.NumHoverRuns));
+    quint64 offset = header.HoverOffset;
+    for (std::vector<std::string>& speciesHover : hoverData) {
+        for (std::string& runHover : speciesHover) {
+            quint32 length;
+            if (offset+sizeof(length) > fileSize) {
+                return false;
+            }
+            std::memcpy(&length,bytes+offset,sizeof(length));
+            offset += sizeof(length);
+            if (offset+length > fileSize) {
+                return false;
+            }
+            runHover.assign(reinterpret_cast<const char*>(bytes+offset),length);
+            offset += length;
+        }
+    }
+
+    data.NumRunsPerForecast = header.NumRuns;
+    data.IsConverged        = (header.IsConverged != 0);
+    data.BaseSeed           = header.BaseSeed;
+    data.Biomass            = biomass;
+    data.MonteCarloSpeciesLoaded.clear();
+    data.Seeds              = seeds;
+    data.HoverData          = hoverData;
+    data.RecomputedSpecies.clear();
+    data.BiomassTensor = REMORA_BiomassTensor();
+    data.BiomassTensor.NumYears   = int(numYears);
+    data.BiomassTensor.NumSpecies = data.NumSpecies;
+    data.BiomassTensor.NumRuns    = header.NumRuns;
+    data.BiomassTensor.Mapped     = std::shared_ptr<const double>(
+                file,reinterpret_cast<const double*>(bytes+header.MonteCarloOffset));
+
+    return true;
+}
+
+bool
+REMORA_ForecastStore::markEngineForecast(const REMORA_ForecastData& data)
+{
+    if (m_Directory.isEmpty()) {
+        return false;
+    }
+
+    QFile file(filename(identifiers(data),".engine"));
+    if (! file.exists() && ! file.open(QIODevice::WriteOnly)) {
+        m_Logger->logMsg(nmfConstants::Warning,"REMORA_ForecastStore: Couldn't mark forecast: " +
+                         file.fileName().toStdString());
+        return false;
+    }
+    return true;
+}
+
+bool
+REMORA_ForecastStore::remove(const REMORA_ForecastData& data)
+{
+    bool isRemoved = true;
+
+    if (m_Directory.isEmpty()) {
+        return true;
+    }
+
+    for (const QString& extension : {QString(".rfs"),QString(".engine")}) {
+        QFile file(filename(identifiers(data),extension));
+        if (file.exists() && ! file.remove()) {
+            m_Logger->logMsg(nmfConstants::Warning,"REMORA_ForecastStore: Couldn't remove forecast file: " +
+                             file.fileName().toStdString());
+            isRemoved = false;
+        }
+    }
+    return isRemoved;
+}
+
+bool
+REMORA_ForecastStore::save(const REMORA_ForecastData& data)
+{
+    StoreHeader header;
+    std::string ids = identifiers(data);
+    QByteArray hover;
+
+    if (m_Directory.isEmpty() || ! data.isValid()) {
+        return false;
+    }
+
+    quint64 numYears  = quint64(data.NumYearsPerRun) + 1;
+    quint64 numValues = numYears*quint64(data.NumSpecies);
+    if ((data.Biomass[0].size1() != numYears) || (int(data.Biomass[0].size2()) != data.NumSpecies)) {
+        return false;
+    }
+    std::vector<double> biomass(numValues);
+    for (unsigned year=0; year<numYears; ++year) {
+        for (int species=0; species<data.NumSpecies; ++species) {
+            biomass[year*data.NumSpecies+species] = data.Biomass[0](year,species);
+        }
+    }
+    std::vector<quint64> seeds(data.NumRunsPerForecast,0);
+    for (int runNum=0; runNum<data.NumRunsPerForecast && runNum<int(data.Seeds.size()); ++runNum) {
+        seeds[runNum] = data.Seeds[runNum];
+    }
+    quint32 numHoverRuns = (int(data.HoverData.size()) == data.NumSpecies) ? quint32(data.HoverData[0].size()) : 0;
+    for (int species=0; species<data.NumSpecies && numHoverRuns>0; ++species) {
+        for (quint32 run=0; run<numHoverRuns; ++run) {
+            const std::string& runHover = (run < data.HoverData[species].size()) ? data.HoverData[species][run] : std::string();
+            quint32 length = quint32(runHover.size());
+            hover.append(reinterpret_cast<const char*>(&length),sizeof(length));
+            hover.append(runHover.data(),int(runHover.size()));
+        }
+    }
+
+    std::memset(&header,0,sizeof(header));
+    header.Magic             = StoreFileMagic;
+    header.Version           = StoreFileVersion;
+    header.ByteOrderMark     = StoreByteOrderMark;
+    header.HeaderSize        = quint32(aligned(sizeof(header),Alignment));
+    header.NumSpecies        = data.NumSpecies;
+    header.NumYearsPerRun    = data.NumYearsPerRun;
+    header.NumRuns           = data.NumRunsPerForecast;
+    header.NumRunsRequested  = data.NumRunsRequested;
+    header.IsConverged       = data.IsConverged ? 1 : 0;
+    header.NumHoverRuns      = numHoverRuns;
+    header.BaseSeed          = data.BaseSeed;
+    header.IdentifiersOffset = header.HeaderSize;
+    header.IdentifiersSize   = ids.size();
+    header.BiomassOffset     = aligned(header.IdentifiersOffset+header.IdentifiersSize,Alignment);
+    header.MonteCarloOffset  = aligned(header.BiomassOffset+numValues*sizeof(double),Alignment);
+    header.SeedsOffset       = aligned(header.MonteCarloOffset+numValues*header.NumRuns*sizeof(double),Alignment);
+    header.HoverOffset       = aligned(header.SeedsOffset+seeds.size()*sizeof(quint64),Alignment);
+    header.FileSize          = header.HoverOffset+quint64(hover.size());
+
+    // Written to a temporary file and renamed so that a partial file is never mapped
+    QSaveFile file(filename(ids));
+    if (! file.open(QIODevice::WriteOnly)) {
+        m_Logger->logMsg(nmfConstants::Warning,"REMORA_ForecastStore: Couldn't write forecast file: " +
+                         file.fileName().toStdString());
+        return false;
+    }
+    bool isWritten =
+        writePadded(file,reinterpret_cast<const char*>(&header),sizeof(header),
+                    header.IdentifiersOffset) &&
+        writePadded(file,ids.data(),ids.size(),
+                    header.BiomassOffset-header.IdentifiersOffset) &&
+        writePadded(file,reinterpret_cast<const char*>(biomass.data()),numValues*sizeof(double),
+                    header.MonteCarloOffset-header.BiomassOffset) &&
+        writePadded(file,reinterpret_cast<const char*>(data.BiomassTensor.runs(0,0)),numValues*header.NumRuns*sizeof(double),
+                    header.SeedsOffset-header.MonteCarloOffset) &&
+        writePadded(file,reinterpret_cast<const char*>(seeds.data()),seeds.size()*sizeof(quint64),
+                    header.HoverOffset-header.SeedsOffset) &&
+        writePadded(file,hover.constData(),quint64(hover.size()),quint64(hover.size()));
+    if (! isWritten || ! file.commit()) {
+        m_Logger->logMsg(nmfConstants::Warning,"REMORA_ForecastStore: Couldn't write forecast file: " +
+                         file.fileName().toStdString());
+        return false;
+    }
+
+    return true;
+}
+
+void
+REMORA_ForecastStore::setDirectory(const QString& directory)
+{
+    if (directory == m_Directory) {
+        return;
+    }
+    m_Directory = directory;
+    if (! m_Directory.isEmpty() && ! QDir().mkpath(m_Directory)) {
+        m_Logger->logMsg(nmfConstants::Warning,"REMORA_ForecastStore: Couldn't create forecast directory: " +
+                         m_Directory.toStdString());
+        m_Directory.clear();
+    }
+}
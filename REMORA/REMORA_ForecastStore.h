@@ -0,0 +1,122 @@
+/**
+ * @file REMORA_ForecastStore.h
+ * @brief Definition for the REMORA binary forecast store
+ *
+ * This file contains the definition of the store that keeps the biomass of the last
+ * forecast REMORA simulated of each forecast name in a compact binary file, which is memory-mapped when
+ * read so that the Monte Carlo runs are drawn without being copied.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+#ifndef REMORA_FORECASTSTORE_H
+#define REMORA_FORECASTSTORE_H
+
+#include <QString>
+
+#include "nmfLogger.h"
+#include "REMORA_ForecastData.h"
+
+#include <string>
+
+/**
+ * @brief Memory-mapped binary store of forecast results
+ *
+ * Each forecast is kept in its own file, named by a hash of its project, model, forecast,
+ * and algorithm identifiers. A file consists of a versioned header, the identifiers, the
+ * biomass without uncertainty, the Monte Carlo biomass as a dense (year x species x run)
+ * tensor laid out as in REMORA_BiomassTensor, the run seeds, and the hover text. The
+ * header and each array start on a 64 byte boundary and the values are in host byte
+ * order, a file written with a different byte order being ignored.
+ *
+ * A forecast simulated by REMORA is also marked by an empty file of the same name, so
+ * that it's known not to be in the host application's database even if its file can't
+ * be read.
+ */
+class REMORA_ForecastStore
+{
+
+private:
+    static const int Alignment = 64;
+
+    nmfLogger* m_Logger;
+    QString    m_Directory;
+
+    QString filename(const std::string& identifiers,
+                     const QString&     extension = ".rfs");
+    static std::string identifiers(const REMORA_ForecastData& data);
+
+public:
+    /**
+     * @brief Class definition for the REMORA forecast store
+     * @param logger : pointer to error logger API
+     */
+    REMORA_ForecastStore(nmfLogger* logger);
+   ~REMORA_ForecastStore();
+
+    /**
+     * @brief Returns true if the forecast whose identifiers are set in data was last
+     * simulated by REMORA (see markEngineForecast)
+     * @param data : the forecast data, whose identifiers must be set
+     * @return true if marked, false otherwise
+     */
+    bool isEngineForecast(const REMORA_ForecastData& data);
+    /**
+     * @brief Reads the forecast whose identifiers and dimensions are set in data. The Monte
+     * Carlo biomass is memory-mapped into data.BiomassTensor. The file stays mapped until
+     * the tensor is detached or released.
+     * @param data : the forecast data, whose identifiers, number of species, years per run,
+     * and number of runs requested must be set
+     * @return true if found, false otherwise
+     */
+    bool load(REMORA_ForecastData& data);
+    /**
+     * @brief Marks the forecast whose identifiers are set in data as simulated by REMORA.
+     * The mark is removed along with the forecast by remove.
+     * @param data : the forecast data, whose identifiers must be set
+     * @return true if marked, false otherwise
+     */
+    bool markEngineForecast(const REMORA_ForecastData& data);
+    /**
+     * @brief Removes the forecast whose identifiers are set in data, and its mark, if it's
+     * stored. The tensor of any forecast read from the store must be detached first.
+     * @param data : the forecast data, whose identifiers must be set
+     * @return true if no file remains, false otherwise
+     */
+    bool remove(const REMORA_ForecastData& data);
+    /**
+     * @brief Writes a forecast, replacing any previous forecast with the same identifiers.
+     * A file that's currently mapped can't be replaced on all platforms so the tensor of
+     * any forecast read from the store must be detached first.
+     * @param data : the forecast data
+     * @return true if written, false otherwise
+     */
+    bool save(const REMORA_ForecastData& data);
+    /**
+     * @brief Sets the directory in which the forecast files are kept, creating it if needed
+     * @param directory : the store directory (empty disables the store)
+     */
+    void setDirectory(const QString& directory);
+};
+
+#endif // REMORA_FORECASTSTORE_H
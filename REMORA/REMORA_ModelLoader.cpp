@@ -0,0 +1,327 @@
+#include "REMORA_ModelLoader.h"
+
+#include "nmfConstants.h"
+#include "nmfConstantsMSSPM.h"
+
+#include <QString>
+
+
+REMORA_ModelLoader::REMORA_ModelLoader(
+        REMORA_Database* database,
+        nmfLogger*       logger)
+{
+    m_Database = database;
+    m_Logger   = logger;
+}
+
+REMORA_ModelLoader::~REMORA_ModelLoader()
+{
+}
+
+bool
+REMORA_ModelLoader::getSpecies(std::vector<std::string>& speciesNames)
+{
+    std::vector<std::string> fields = {"SpeName"};
+    std::string queryStr = "SELECT SpeName FROM " + nmfConstantsMSSPM::TableSpecies;
+    m_Database->setCallSite("REMORA_ModelLoader::getSpecies");
+    std::map<std::string, std::vector<std::string> > dataMap = m_Database->nmfQueryDatabase(queryStr, fields);
+
+    speciesNames = dataMap["SpeName"];
+    return ! speciesNames.empty();
+}
+
+bool
+REMORA_ModelLoader::getYearRange(
+        const std::string& projectName,
+        const std::string& modelName,
+        int&               firstYear,
+        int&               lastYear)
+{
+    REMORA_QueryResult result;
+    std::string queryStr = "SELECT StartYear,RunLength from " +
+                            nmfConstantsMSSPM::TableModels +
+                           " WHERE ProjectName = '" + projectName +
+                           "' AND ModelName = '"    + modelName   + "'";
+
+    m_Database->setCallSite("REMORA_ModelLoader::getYearRange");
+    if (! m_Database->nmfQueryColumns(queryStr,{{"StartYear",REMORA_Column::Integer},
+                                                {"RunLength",REMORA_Column::Integer}},result) ||
+        (result.NumRows == 0)) {
+        return false;
+    }
+    firstYear = result.Integer["StartYear"][0];
+    lastYear  = firstYear + result.Integer["RunLength"][0];
+    return true;
+}
+
+bool
+REMORA_ModelLoader::getForecastInfo(
+        REMORA_RunSettings& settings,
+        std::string&        errorMsg)
+{
+    std::vector<std::string> fields = {"Algorithm","Minimizer","ObjectiveCriterion","Scaling",
+                                       "GrowthForm","HarvestForm","WithinGuildCompetitionForm","PredationForm"};
+    std::string queryStr = "SELECT Algorithm,Minimizer,ObjectiveCriterion,Scaling,"
+                           "GrowthForm,HarvestForm,WithinGuildCompetitionForm,PredationForm FROM " +
+                            nmfConstantsMSSPM::TableForecasts +
+                           " WHERE ProjectName = '" + settings.ProjectName +
+                           "' AND ForecastName = '" + settings.ForecastName + "'";
+    m_Database->setCallSite("REMORA_ModelLoader::getForecastInfo");
+    std::map<std::string, std::vector<std::string> > dataMap = m_Database->nmfQueryDatabase(queryStr, fields);
+
+    if (dataMap["Algorithm"].size() == 0) {
+        errorMsg = "No forecast found: " + settings.ForecastName;
+        m_Logger->logMsg(nmfConstants::Error,"REMORA_ModelLoader::getForecastInfo: " + errorMsg);
+        m_Logger->logMsg(nmfConstants::Error,queryStr);
+        return false;
+    }
+    settings.ForecastAlgorithm          = dataMap["Algorithm"][0];
+    settings.ForecastMinimizer          = dataMap["Minimizer"][0];
+    settings.ForecastObjectiveCriterion = dataMap["ObjectiveCriterion"][0];
+    settings.ForecastScaling            = dataMap["Scaling"][0];
+    settings.GrowthForm                 = dataMap["GrowthForm"][0];
+    settings.HarvestForm                = dataMap["HarvestForm"][0];
+    settings.CompetitionForm            = dataMap["WithinGuildCompetitionForm"][0];
+    settings.PredationForm              = dataMap["PredationForm"][0];
+    return true;
+}
+
+bool
+REMORA_ModelLoader::getForecastHarvest(
+        const REMORA_RunSettings&              settings,
+        std::vector<double>&                   lastYearsCatchValues,
+        boost::numeric::ublas::matrix<double>& harvest,
+        std::string&                           errorMsg)
+{
+    int NumYears = settings.EndYear-settings.StartYear+1;
+    int NumSpecies = int(settings.SpeciesNames.size());
+
+    if (! getLastYearsCatchValues(settings,NumYears,lastYearsCatchValues,errorMsg)) {
+        return false;
+    }
+    if (int(lastYearsCatchValues.size()) < NumSpecies) {
+        errorMsg = "REMORA_ModelLoader::getForecastHarvest: Found " + std::to_string(lastYearsCatchValues.size()) +
+                   " last year catch values for " + std::to_string(NumSpecies) + " species";
+        m_Logger->logMsg(nmfConstants::Error,errorMsg);
+        return false;
+    }
+
+    harvest.resize(settings.NumYearsPerRun+1,NumSpecies,false);
+    for (int speciesNum=0; speciesNum<NumSpecies; ++speciesNum) {
+        for (int yearNum=0; yearNum<=settings.NumYearsPerRun; ++yearNum) {
+            harvest(yearNum,speciesNum) = settings.ScaleFactors[speciesNum][yearNum] * lastYearsCatchValues[speciesNum];
+        }
+    }
+    return true;
+}
+
+bool
+REMORA_ModelLoader::getLastYearsCatchValues(
+        const REMORA_RunSettings& settings,
+        const int&                lastYear,
+        std::vector<double>&      lastYearsCatchValues,
+        std::string&              errorMsg)
+{
+    REMORA_QueryResult result;
+    std::string queryStr;
+    std::string lastYearHarvestTable = QString::fromStdString(settings.HarvestType).replace("forecast","").toStdString();
+    lastYearsCatchValues.clear();
+
+    // Get last year's catch data
+    queryStr  = "SELECT Value FROM " +
+                 lastYearHarvestTable +
+                " WHERE ProjectName = '" + settings.ProjectName +
+                "' AND ModelName = '"    + settings.ModelName +
+                "' AND Year = " + std::to_string(lastYear-1);
+
+    m_Database->setCallSite("REMORA_ModelLoader::getLastYearsCatchValues");
+    if (! m_Database->nmfQueryColumns(queryStr,{{"Value",REMORA_Column::Real}},result)) {
+        errorMsg = "Couldn't query table " + lastYearHarvestTable + ": " + m_Database->lastError();
+        return false;
+    }
+    if (result.NumRows == 0) {
+        errorMsg = "No entries found in table: " + lastYearHarvestTable;
+        m_Logger->logMsg(nmfConstants::Error,errorMsg);
+        m_Logger->logMsg(nmfConstants::Error,queryStr);
+        return false;
+    }
+    lastYearsCatchValues = result.Real["Value"];
+    return true;
+}
+
+bool
+REMORA_ModelLoader::loadInteractionParameter(
+        const REMORA_RunSettings&              settings,
+        const std::string&                     tableName,
+        boost::numeric::ublas::matrix<double>& values,
+        std::string&                           errorMsg)
+{
+    int NumSpecies = int(settings.SpeciesNames.size());
+    std::map<std::string,int> speciesIndex;
+    REMORA_QueryResult result;
+    std::string queryStr;
+
+    for (int i=0; i<NumSpecies; ++i) {
+        speciesIndex[settings.SpeciesNames[i]] = i;
+    }
+    queryStr  = "SELECT SpeciesA,SpeciesB,Value FROM " + tableName +
+                " WHERE ProjectName = '"       + settings.ProjectName +
+                "' AND ModelName = '"          + settings.ModelName +
+                "' AND Algorithm = '"          + settings.ForecastAlgorithm +
+                "' AND Minimizer = '"          + settings.ForecastMinimizer +
+                "' AND ObjectiveCriterion = '" + settings.ForecastObjectiveCriterion +
+                "' AND Scaling = '"            + settings.ForecastScaling + "'";
+    m_Database->setCallSite("REMORA_ModelLoader::loadInteractionParameter");
+    if (! m_Database->nmfQueryColumns(queryStr,{{"SpeciesA",REMORA_Column::Text},
+                                                {"SpeciesB",REMORA_Column::Text},
+                                                {"Value",   REMORA_Column::Real}},result)) {
+        errorMsg = "Couldn't query table " + tableName + ": " + m_Database->lastError();
+        return false;
+    }
+    if (result.NumRows == 0) {
+        errorMsg = "No records found in table: " + tableName;
+        return false;
+    }
+
+    const std::vector<std::string>& SpeciesA = result.Text["SpeciesA"];
+    const std::vector<std::string>& SpeciesB = result.Text["SpeciesB"];
+    const std::vector<double>&      Value    = result.Real["Value"];
+    values.resize(NumSpecies,NumSpecies,false);
+    values.clear();
+    for (int i=0; i<result.NumRows; ++i) {
+        if ((speciesIndex.find(SpeciesA[i]) == speciesIndex.end()) ||
+            (speciesIndex.find(SpeciesB[i]) == speciesIndex.end())) {
+            continue;
+        }
+        values(speciesIndex[SpeciesA[i]],speciesIndex[SpeciesB[i]]) = Value[i];
+    }
+    return true;
+}
+
+bool
+REMORA_ModelLoader::loadModelParameters(
+        const REMORA_RunSettings&                    settings,
+        const std::vector<double>&                   lastYearsCatchValues,
+        const boost::numeric::ublas::matrix<double>& harvest,
+        REMORA_ModelParameters&                      parameters,
+        std::string&                                 errorMsg)
+{
+    int NumSpecies = int(settings.SpeciesNames.size());
+    int LastObservedYear = settings.EndYear - settings.StartYear;
+    std::string noYear = "";
+
+    parameters.GrowthForm      = settings.GrowthForm;
+    parameters.HarvestForm     = settings.HarvestForm;
+    parameters.CompetitionForm = settings.CompetitionForm;
+    parameters.PredationForm   = settings.PredationForm;
+    parameters.Harvest         = harvest;
+    parameters.LastHarvest.assign(lastYearsCatchValues.begin(),lastYearsCatchValues.begin()+NumSpecies);
+    if (! REMORA_ForecastEngine::isSupported(parameters,errorMsg)) {
+        return false;
+    }
+
+    // Only the parameters used by the model's forms are required
+    parameters.GrowthRate.assign(NumSpecies,0.0);
+    parameters.CarryingCapacity.assign(NumSpecies,0.0);
+    parameters.Catchability.assign(NumSpecies,0.0);
+    parameters.PredationExponent.assign(NumSpecies,0.0);
+    parameters.CompetitionAlpha  = boost::numeric::ublas::zero_matrix<double>(NumSpecies,NumSpecies);
+    parameters.CompetitionBeta   = boost::numeric::ublas::zero_matrix<double>(NumSpecies,NumSpecies);
+    parameters.PredationRho      = boost::numeric::ublas::zero_matrix<double>(NumSpecies,NumSpecies);
+    parameters.PredationHandling = boost::numeric::ublas::zero_matrix<double>(NumSpecies,NumSpecies);
+
+    if (! loadSpeciesParameter(settings,nmfConstantsMSSPM::TableOutputBiomass,
+                               " AND Year = " + std::to_string(LastObservedYear),
+                               parameters.InitBiomass,errorMsg)) {
+        return false;
+    }
+    if ((parameters.GrowthForm != "Null") &&
+        ! loadSpeciesParameter(settings,nmfConstantsMSSPM::TableOutputGrowthRate,noYear,
+                               parameters.GrowthRate,errorMsg)) {
+        return false;
+    }
+    if (((parameters.GrowthForm == "Logistic") || (parameters.CompetitionForm == "MS-PROD")) &&
+        ! loadSpeciesParameter(settings,nmfConstantsMSSPM::TableOutputCarryingCapacity,noYear,
+                               parameters.CarryingCapacity,errorMsg)) {
+        return false;
+    }
+    if ((parameters.HarvestForm == "Effort (qE)") &&
+        ! loadSpeciesParameter(settings,nmfConstantsMSSPM::TableOutputCatchability,noYear,
+                               parameters.Catchability,errorMsg)) {
+        return false;
+    }
+    if ((parameters.CompetitionForm == "NO_K") &&
+        ! loadInteractionParameter(settings,nmfConstantsMSSPM::TableOutputCompetitionAlpha,
+                                   parameters.CompetitionAlpha,errorMsg)) {
+        return false;
+    }
+    if ((parameters.CompetitionForm == "MS-PROD") &&
+        ! loadInteractionParameter(settings,nmfConstantsMSSPM::TableOutputCompetitionBetaSpecies,
+                                   parameters.CompetitionBeta,errorMsg)) {
+        return false;
+    }
+    if ((parameters.PredationForm != "Null") &&
+        ! loadInteractionParameter(settings,nmfConstantsMSSPM::TableOutputPredationRho,
+                                   parameters.PredationRho,errorMsg)) {
+        return false;
+    }
+    if (((parameters.PredationForm == "Type II") || (parameters.PredationForm == "Type III")) &&
+        ! loadInteractionParameter(settings,nmfConstantsMSSPM::TableOutputPredationHandling,
+                                   parameters.PredationHandling,errorMsg)) {
+        return false;
+    }
+    if ((parameters.PredationForm == "Type III") &&
+        ! loadSpeciesParameter(settings,nmfConstantsMSSPM::TableOutputPredationExponent,noYear,
+                               parameters.PredationExponent,errorMsg)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool
+REMORA_ModelLoader::loadSpeciesParameter(
+        const REMORA_RunSettings& settings,
+        const std::string&        tableName,
+        const std::string&        yearClause,
+        std::vector<double>&      values,
+        std::string&              errorMsg)
+{
+    int NumFound = 0;
+    REMORA_QueryResult result;
+    std::string queryStr;
+
+    queryStr  = "SELECT SpeName,Value FROM " + tableName +
+                " WHERE ProjectName = '"       + settings.ProjectName +
+                "' AND ModelName = '"          + settings.ModelName +
+                "' AND Algorithm = '"          + settings.ForecastAlgorithm +
+                "' AND Minimizer = '"          + settings.ForecastMinimizer +
+                "' AND ObjectiveCriterion = '" + settings.ForecastObjectiveCriterion +
+                "' AND Scaling = '"            + settings.ForecastScaling + "'" +
+                 yearClause;
+    m_Database->setCallSite("REMORA_ModelLoader::loadSpeciesParameter");
+    if (! m_Database->nmfQueryColumns(queryStr,{{"SpeName",REMORA_Column::Text},
+                                                {"Value",  REMORA_Column::Real}},result)) {
+        errorMsg = "Couldn't query table " + tableName + ": " + m_Database->lastError();
+        return false;
+    }
+
+    const std::vector<std::string>& SpeName = result.Text["SpeName"];
+    const std::vector<double>&      Value   = result.Real["Value"];
+    values.assign(settings.SpeciesNames.size(),0.0);
+    for (int i=0; i<result.NumRows; ++i) {
+        for (unsigned species=0; species<settings.SpeciesNames.size(); ++species) {
+            if (SpeName[i] == settings.SpeciesNames[species]) {
+                values[species] = Value[i];
+                ++NumFound;
+                break;
+            }
+        }
+    }
+    if (NumFound < int(settings.SpeciesNames.size())) {
+        errorMsg = "Found " + std::to_string(NumFound) + " of " +
+                    std::to_string(settings.SpeciesNames.size()) + " species in table: " + tableName;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file REMORA_ModelLoader.h
+ * @brief Definition for the REMORA model parameter loader
+ *
+ * This file contains the definition of the class that reads the estimated model
+ * parameters, species, year range, and forecast information that REMORA needs to
+ * simulate a forecast. It doesn't reference any widget so it may be used from a
+ * worker thread or from the headless batch runner.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+#ifndef REMORA_MODELLOADER_H
+#define REMORA_MODELLOADER_H
+
+#include "nmfLogger.h"
+#include "REMORA_Database.h"
+#include "REMORA_ForecastData.h"
+#include "REMORA_ForecastEngine.h"
+
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Reads the data needed to simulate a forecast from the MSSPM database
+ */
+class REMORA_ModelLoader
+{
+
+private:
+    REMORA_Database* m_Database;
+    nmfLogger*       m_Logger;
+
+    bool getLastYearsCatchValues(
+            const REMORA_RunSettings& settings,
+            const int&                lastYear,
+            std::vector<double>&      lastYearsCatchValues,
+            std::string&              errorMsg);
+    bool loadInteractionParameter(
+            const REMORA_RunSettings&              settings,
+            const std::string&                     tableName,
+            boost::numeric::ublas::matrix<double>& values,
+            std::string&                           errorMsg);
+    bool loadSpeciesParameter(
+            const REMORA_RunSettings& settings,
+            const std::string&        tableName,
+            const std::string&        yearClause,
+            std::vector<double>&      values,
+            std::string&              errorMsg);
+
+public:
+    /**
+     * @brief Class definition for the REMORA model loader
+     * @param database : database connection usable from the calling thread
+     * @param logger : pointer to error logger API
+     */
+    REMORA_ModelLoader(REMORA_Database* database,
+                       nmfLogger*       logger);
+   ~REMORA_ModelLoader();
+
+    /**
+     * @brief Calculates the forecast harvest from the last observed year's harvest and the harvest scale factors
+     * @param settings : the run settings
+     * @param lastYearsCatchValues : the last observed year's catch, effort, or exploitation per species
+     * @param harvest : the (years x species) forecast harvest
+     * @param errorMsg : description of any error
+     * @return true if successful, false otherwise
+     */
+    bool getForecastHarvest(
+            const REMORA_RunSettings&              settings,
+            std::vector<double>&                   lastYearsCatchValues,
+            boost::numeric::ublas::matrix<double>& harvest,
+            std::string&                           errorMsg);
+    /**
+     * @brief Reads the forecast's model forms and the algorithm identifiers of the estimation
+     * it's based upon into the passed settings
+     * @param settings : the run settings, whose ProjectName and ForecastName must be set
+     * @param errorMsg : description of any error
+     * @return true if the forecast was found, false otherwise
+     */
+    bool getForecastInfo(
+            REMORA_RunSettings& settings,
+            std::string&        errorMsg);
+    /**
+     * @brief Reads the species names in the order used by the REMORA controls
+     * @param speciesNames : the species names
+     * @return true if any species were found, false otherwise
+     */
+    bool getSpecies(std::vector<std::string>& speciesNames);
+    /**
+     * @brief Reads the first and last observed years of a model
+     * @param projectName : the project name
+     * @param modelName : the model name
+     * @param firstYear : the first observed year
+     * @param lastYear : the last observed year
+     * @return true if the model was found, false otherwise
+     */
+    bool getYearRange(
+            const std::string& projectName,
+            const std::string& modelName,
+            int&               firstYear,
+            int&               lastYear);
+    /**
+     * @brief Reads the estimated parameters required by the forecast's model forms
+     * @param settings : the run settings
+     * @param lastYearsCatchValues : the last observed year's catch, effort, or exploitation per species
+     * @param harvest : the (years x species) forecast harvest
+     * @param parameters : the model parameters
+     * @param errorMsg : description of any missing parameter or unsupported form
+     * @return true if REMORA_ForecastEngine can simulate the forecast, false otherwise
+     */
+    bool loadModelParameters(
+            const REMORA_RunSettings&                    settings,
+            const std::vector<double>&                   lastYearsCatchValues,
+            const boost::numeric::ublas::matrix<double>& harvest,
+            REMORA_ModelParameters&                      parameters,
+            std::string&                                 errorMsg);
+};
+
+#endif // REMORA_MODELLOADER_H
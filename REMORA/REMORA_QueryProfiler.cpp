@@ -0,0 +1,200 @@
+#include "REMORA_QueryProfiler.h"
+
+#include "nmfConstants.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+
+REMORA_QueryProfiler::REMORA_QueryProfiler()
+{
+}
+
+REMORA_QueryProfiler::~REMORA_QueryProfiler()
+{
+}
+
+double
+REMORA_QueryProfiler::bucketUpperMSec(const int& bucket)
+{
+    return (bucket < NumBuckets-1) ? 0.25*std::pow(2.0,bucket) : std::numeric_limits<double>::infinity();
+}
+
+void
+REMORA_QueryProfiler::clear()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Stats.clear();
+}
+
+bool
+REMORA_QueryProfiler::isEmpty()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    return m_Stats.empty();
+}
+
+void
+REMORA_QueryProfiler::record(
+        const std::string& callSite,
+        const std::string& statementClass,
+        const qint64&      numRows,
+        const qint64&      numBytes,
+        const double&      msec)
+{
+    int bucket = 0;
+
+    while ((bucket < NumBuckets-1) && (msec > bucketUpperMSec(bucket))) {
+        ++bucket;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Stats& stats = m_Stats[std::make_pair(callSite,statementClass)];
+    stats.NumCalls  += 1;
+    stats.NumRows   += numRows;
+    stats.NumBytes  += numBytes;
+    stats.TotalMSec += msec;
+    stats.MaxMSec    = std::max(stats.MaxMSec,msec);
+    stats.Histogram[bucket] += 1;
+}
+
+std::vector<std::pair<std::pair<std::string,std::string>, REMORA_QueryProfiler::Stats> >
+REMORA_QueryProfiler::sortedStats()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    std::vector<std::pair<std::pair<std::string,std::string>, Stats> > sorted(m_Stats.begin(),m_Stats.end());
+
+    std::stable_sort(sorted.begin(),sorted.end(),[](const std::pair<std::pair<std::string,std::string>, Stats>& a,
+                                                   const std::pair<std::pair<std::string,std::string>, Stats>& b) {
+        return a.second.TotalMSec > b.second.TotalMSec;
+    });
+    return sorted;
+}
+
+std::string
+REMORA_QueryProfiler::statementClass(const std::string& sql)
+{
+    std::string retv;
+    size_t pos = sql.find_first_not_of(" \t\r\n(");
+
+    while ((pos < sql.size()) && std::isalpha(static_cast<unsigned char>(sql[pos]))) {
+        retv += char(std::toupper(static_cast<unsigned char>(sql[pos++])));
+    }
+    return retv.empty() ? "OTHER" : retv;
+}
+
+bool
+REMORA_QueryProfiler::writeJson(
+        const QString&     filename,
+        const std::string& title)
+{
+    QJsonArray calls;
+
+    for (const std::pair<std::pair<std::string,std::string>, Stats>& entry : sortedStats()) {
+        const Stats& stats = entry.second;
+        QJsonArray histogram;
+        for (int bucket=0; bucket<NumBuckets; ++bucket) {
+            QJsonObject bin;
+            bin["UpperMSec"] = (bucket < NumBuckets-1) ? QJsonValue(bucketUpperMSec(bucket)) : QJsonValue();
+            bin["Count"]     = stats.Histogram[bucket];
+            histogram.append(bin);
+        }
+        QJsonObject call;
+        call["CallSite"]       = QString::fromStdString(entry.first.first);
+        call["StatementClass"] = QString::fromStdString(entry.first.second);
+        call["NumCalls"]       = stats.NumCalls;
+        call["NumRows"]        = double(stats.NumRows);
+        call["NumBytes"]       = double(stats.NumBytes);
+        call["TotalMSec"]      = stats.TotalMSec;
+        call["MaxMSec"]        = stats.MaxMSec;
+        call["Histogram"]      = histogram;
+        calls.append(call);
+    }
+    QJsonObject root;
+    root["Run"]   = QString::fromStdString(title);
+    root["Calls"] = calls;
+
+    QSaveFile file(filename);
+    if (! file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return file.commit();
+}
+
+void
+REMORA_QueryProfiler::writeToLog(
+        nmfLogger*         logger,
+        const std::string& title)
+{
+    logger->logMsg(nmfConstants::Normal,"REMORA_QueryProfiler: Database calls of " + title +
+                   " (call site, statement class, calls, rows, bytes, total ms, max ms, calls per latency bucket)");
+    for (const std::pair<std::pair<std::string,std::string>, Stats>& entry : sortedStats()) {
+        const Stats& stats = entry.second;
+        std::ostringstream line;
+        line.precision(3);
+        line << std::fixed << "REMORA_QueryProfiler: " << entry.first.first << " " << entry.first.second
+             << " calls=" << stats.NumCalls << " rows=" << stats.NumRows << " bytes=" << stats.NumBytes
+             << " total=" << stats.TotalMSec << " max=" << stats.MaxMSec << " histogram=";
+        for (int bucket=0; bucket<NumBuckets; ++bucket) {
+            if (stats.Histogram[bucket] > 0) {
+                line << ((bucket < NumBuckets-1) ? "<=" : ">") << bucketUpperMSec(std::min(bucket,NumBuckets-2))
+                     << "ms:" << stats.Histogram[bucket] << " ";
+            }
+        }
+        logger->logMsg(nmfConstants::Normal,line.str());
+    }
+}
+
+
+REMORA_QueryTimer::REMORA_QueryTimer(
+        REMORA_QueryProfiler* profiler,
+        const std::string&    callSite,
+        const std::string&    statementClass)
+{
+    m_Profiler       = profiler;
+    m_CallSite       = callSite;
+    m_StatementClass = statementClass;
+    m_NumRows        = 0;
+    m_NumBytes       = 0;
+    if (m_Profiler != nullptr) {
+        m_Timer.start();
+    }
+}
+
+REMORA_QueryTimer::~REMORA_QueryTimer()
+{
+    if (m_Profiler != nullptr) {
+        m_Profiler->record(m_CallSite,m_StatementClass,m_NumRows,m_NumBytes,m_Timer.nsecsElapsed()/1.0e6);
+    }
+}
+
+void
+REMORA_QueryTimer::setResult(
+        const qint64& numRows,
+        const qint64& numBytes)
+{
+    m_NumRows  = numRows;
+    m_NumBytes = numBytes;
+}
+
+void
+REMORA_QueryTimer::stop(
+        const qint64& numRows,
+        const qint64& numBytes)
+{
+    if (m_Profiler != nullptr) {
+        m_Profiler->record(m_CallSite,m_StatementClass,numRows,numBytes,m_Timer.nsecsElapsed()/1.0e6);
+        m_Profiler = nullptr;
+    }
+}
@@ -0,0 +1,173 @@
+/**
+ * @file REMORA_QueryProfiler.h
+ * @brief Definition for the REMORA database call profiler
+ *
+ * This file contains the definition of the profiler that records the latency of each
+ * database call made during a REMORA run, so that the slow calls may be found.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+#ifndef REMORA_QUERYPROFILER_H
+#define REMORA_QUERYPROFILER_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include "nmfLogger.h"
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Per call site and statement class latency histograms of database calls
+ *
+ * Each recorded call is accumulated under its call site (i.e., REMORA_RunWorker::saveHarvestData)
+ * and statement class (i.e., SELECT, INSERT). Calls may be recorded from any thread.
+ */
+class REMORA_QueryProfiler
+{
+
+public:
+    static const int NumBuckets = 13; ///< Latency buckets: up to 0.25 ms, doubling to 512 ms, then beyond
+
+    /**
+     * @brief The calls accumulated under one call site and statement class
+     */
+    struct Stats {
+        int    NumCalls = 0;
+        qint64 NumRows  = 0;
+        qint64 NumBytes = 0;
+        double TotalMSec = 0.0;
+        double MaxMSec   = 0.0;
+        std::array<int,NumBuckets> Histogram{}; ///< Number of calls per latency bucket
+    };
+
+private:
+    std::mutex                                          m_Mutex;
+    std::map<std::pair<std::string,std::string>, Stats> m_Stats; // Keyed by call site and statement class
+
+    std::vector<std::pair<std::pair<std::string,std::string>, Stats> > sortedStats();
+
+public:
+    REMORA_QueryProfiler();
+   ~REMORA_QueryProfiler();
+
+    /**
+     * @brief Returns the upper latency bound of a histogram bucket
+     * @param bucket : the bucket number
+     * @return Upper bound in milliseconds (infinity for the last bucket)
+     */
+    static double bucketUpperMSec(const int& bucket);
+    /**
+     * @brief Discards all recorded calls (i.e., at the start of a run)
+     */
+    void clear();
+    /**
+     * @brief Returns true if no calls have been recorded
+     */
+    bool isEmpty();
+    /**
+     * @brief Records a database call
+     * @param callSite : the function that made the call
+     * @param statementClass : the kind of statement (i.e., SELECT, INSERT, DELETE, COMMIT)
+     * @param numRows : the number of rows read or written
+     * @param numBytes : the approximate number of value bytes read or written
+     * @param msec : the wall time of the call in milliseconds
+     */
+    void record(const std::string& callSite,
+                const std::string& statementClass,
+                const qint64&      numRows,
+                const qint64&      numBytes,
+                const double&      msec);
+    /**
+     * @brief Returns the statement class of an SQL statement, its first keyword in upper case
+     * @param sql : the statement
+     * @return The statement class (i.e., SELECT)
+     */
+    static std::string statementClass(const std::string& sql);
+    /**
+     * @brief Writes one line per call site and statement class to the log, slowest first
+     * @param logger : pointer to error logger API
+     * @param title : identifies the run in the log
+     */
+    void writeToLog(nmfLogger*         logger,
+                    const std::string& title);
+    /**
+     * @brief Writes the histograms to a JSON file, slowest call site first
+     * @param filename : the JSON file to write
+     * @param title : identifies the run in the file
+     * @return true if written, false otherwise
+     */
+    bool writeJson(const QString&     filename,
+                   const std::string& title);
+};
+
+/**
+ * @brief Times a database call from construction until stop() is called or the timer is
+ * destroyed, and records it with REMORA_QueryProfiler. Nothing is recorded if the profiler is null.
+ */
+class REMORA_QueryTimer
+{
+
+private:
+    REMORA_QueryProfiler* m_Profiler;
+    std::string           m_CallSite;
+    std::string           m_StatementClass;
+    qint64                m_NumRows;
+    qint64                m_NumBytes;
+    QElapsedTimer         m_Timer;
+
+public:
+    /**
+     * @brief Starts timing a database call
+     * @param profiler : the profiler to record with (null disables recording)
+     * @param callSite : the function that makes the call
+     * @param statementClass : the kind of statement
+     */
+    REMORA_QueryTimer(REMORA_QueryProfiler* profiler,
+                      const std::string&    callSite,
+                      const std::string&    statementClass);
+   ~REMORA_QueryTimer();
+
+    /**
+     * @brief Sets the size of the call's result, recorded when the timer is destroyed
+     * @param numRows : the number of rows read or written
+     * @param numBytes : the approximate number of value bytes read or written
+     */
+    void setResult(const qint64& numRows,
+                   const qint64& numBytes);
+    /**
+     * @brief Records the call now, rather than when the timer is destroyed
+     * @param numRows : the number of rows read or written
+     * @param numBytes : the approximate number of value bytes read or written
+     */
+    void stop(const qint64& numRows,
+              const qint64& numBytes);
+};
+
+#endif // REMORA_QUERYPROFILER_H
@@ -0,0 +1,316 @@
+#include "REMORA_ResultCache.h"
+
+#include "nmfConstants.h"
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+
+static const quint32 CacheFileMagic   = 0x524D5243; // "RMRC"
+static const quint32 CacheFileVersion = 3;
+
+
+REMORA_ResultCache::REMORA_ResultCache(nmfLogger* logger)
+{
+    m_Logger = logger;
+}
+
+REMORA_ResultCache::~REMORA_ResultCache()
+{
+}
+
+static void
+writeVector(QDataStream& stream, const std::vector<double>& values)
+{
+    stream << quint32(values.size());
+    for (const double& value : values) {
+        stream << value;
+    }
+}
+
+static void
+writeMatrix(QDataStream& stream, const boost::numeric::ublas::matrix<double>& values)
+{
+    stream << quint32(values.size1()) << quint32(values.size2());
+    for (unsigned i=0; i<values.size1(); ++i) {
+        for (unsigned j=0; j<values.size2(); ++j) {
+            stream << values(i,j);
+        }
+    }
+}
+
+static void
+writeTensor(QDataStream& stream, const REMORA_BiomassTensor& tensor)
+{
+    size_t NumValues = size_t(tensor.NumYears)*tensor.NumSpecies*tensor.NumRuns;
+    const double* values = tensor.runs(0,0);
+
+    stream << quint32(tensor.NumYears) << quint32(tensor.NumSpecies) << quint32(tensor.NumRuns);
+    for (size_t i=0; i<NumValues; ++i) {
+        stream << values[i];
+    }
+}
+
+static bool
+readTensor(QDataStream& stream, REMORA_BiomassTensor& tensor)
+{
+    quint32 numYears;
+    quint32 numSpecies;
+    quint32 numRuns;
+
+    stream >> numYears >> numSpecies >> numRuns;
+    if ((stream.status() != QDataStream::Ok) || (quint64(numYears)*numSpecies*numRuns > 100000000)) {
+        return false;
+    }
+    tensor.resize(numYears,numSpecies,numRuns);
+    for (double& value : tensor.Values) {
+        stream >> value;
+    }
+    return (stream.status() == QDataStream::Ok);
+}
+
+static bool
+readMatrix(QDataStream& stream, boost::numeric::ublas::matrix<double>& values)
+{
+    quint32 rows;
+    quint32 cols;
+
+    stream >> rows >> cols;
+    if ((stream.status() != QDataStream::Ok) || (quint64(rows)*cols > 100000000)) {
+        return false;
+    }
+    values.resize(rows,cols,false);
+    for (unsigned i=0; i<rows; ++i) {
+        for (unsigned j=0; j<cols; ++j) {
+            stream >> values(i,j);
+        }
+    }
+    return (stream.status() == QDataStream::Ok);
+}
+
+std::string
+REMORA_ResultCache::key(
+        const REMORA_RunSettings&     settings,
+        const REMORA_ModelParameters& parameters)
+{
+    QByteArray bytes;
+    QDataStream stream(&bytes,QIODevice::WriteOnly);
+
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+    stream << CacheFileVersion;
+    for (const std::string& value : {settings.ProjectName, settings.ModelName, settings.ForecastName,
+                                     settings.HarvestType, settings.SamplingMethod,
+                                     settings.Algorithm, settings.Minimizer,
+                                     settings.ObjectiveCriterion, settings.Scaling,
+                                     settings.ForecastAlgorithm, settings.ForecastMinimizer,
+                                     settings.ForecastObjectiveCriterion, settings.ForecastScaling,
+                                     settings.GrowthForm, settings.HarvestForm,
+                                     settings.CompetitionForm, settings.PredationForm}) {
+        stream << QString::fromStdString(value);
+    }
+    stream << quint32(settings.SpeciesNames.size());
+    for (const std::string& speciesName : settings.SpeciesNames) {
+        stream << QString::fromStdString(speciesName);
+    }
+    stream << qint32(settings.StartYear) << qint32(settings.EndYear)
+           << qint32(settings.NumYearsPerRun) << qint32(settings.NumRunsPerForecast)
+           << settings.IsDeterministic
+           << settings.IsAdaptive << settings.ConvergenceTolerance << qint32(settings.AdaptiveBatchSize)
+           << settings.GrowthUncertainty << settings.CarryingCapacityUncertainty << settings.HarvestUncertainty;
+    stream << quint32(settings.ScaleFactors.size());
+    for (const std::vector<double>& scaleFactors : settings.ScaleFactors) {
+        writeVector(stream,scaleFactors);
+    }
+
+    // The estimated parameters change if the model is re-estimated with the same identifiers
+    writeVector(stream,parameters.InitBiomass);
+    writeVector(stream,parameters.GrowthRate);
+    writeVector(stream,parameters.CarryingCapacity);
+    writeVector(stream,parameters.Catchability);
+    writeVector(stream,parameters.PredationExponent);
+    writeVector(stream,parameters.LastHarvest);
+    writeMatrix(stream,parameters.CompetitionAlpha);
+    writeMatrix(stream,parameters.CompetitionBeta);
+    writeMatrix(stream,parameters.PredationRho);
+    writeMatrix(stream,parameters.PredationHandling);
+    writeMatrix(stream,parameters.Harvest);
+
+    return QCryptographicHash::hash(bytes,QCryptographicHash::Sha256).toHex().toStdString();
+}
+
+QString
+REMORA_ResultCache::filename(const std::string& key)
+{
+    return QDir(m_Directory).filePath(QString::fromStdString(key) + ".rfc");
+}
+
+bool
+REMORA_ResultCache::load(
+        const std::string&   key,
+        REMORA_ForecastData& data)
+{
+    quint32 magic;
+    quint32 version;
+    quint32 numStrings;
+    qint32  numSpecies;
+    qint32  numYearsPerRun;
+    qint32  numRuns;
+    qint32  numRunsRequested;
+    bool    isConverged;
+    quint64 value;
+    QString fileKey;
+    QString hover;
+    REMORA_ForecastData cached;
+
+    if (m_Directory.isEmpty()) {
+        return false;
+    }
+    if (m_Memory.find(key) != m_Memory.end()) {
+        data = m_Memory[key];
+        return true;
+    }
+
+    QFile file(filename(key));
+    if (! file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+    stream >> magic >> version >> fileKey;
+    if ((magic != CacheFileMagic) || (version != CacheFileVersion) || (fileKey.toStdString() != key)) {
+        m_Logger->logMsg(nmfConstants::Warning,"REMORA_ResultCache: Ignoring stale cache file: " +
+                         file.fileName().toStdString());
+        return false;
+    }
+    stream >> numSpecies >> numYearsPerRun >> numRuns >> numRunsRequested >> isConverged >> value;
+    if ((stream.status() != QDataStream::Ok) || (numSpecies <= 0) || (numRuns < 0)) {
+        return false;
+    }
+    cached.NumSpecies         = numSpecies;
+    cached.NumYearsPerRun     = numYearsPerRun;
+    cached.NumRunsPerForecast = numRuns;
+    cached.NumRunsRequested   = numRunsRequested;
+    cached.IsConverged        = isConverged;
+    cached.BaseSeed           = value;
+    cached.Biomass.assign(1,boost::numeric::ublas::matrix<double>());
+    cached.Seeds.assign(numRuns,0);
+    for (uint64_t& seed : cached.Seeds) {
+        stream >> value;
+        seed = value;
+    }
+    if (! readMatrix(stream,cached.Biomass[0]) || ! readTensor(stream,cached.BiomassTensor)) {
+        return false;
+    }
+    stream >> numStrings;
+    cached.HoverData.assign((numStrings > 0) ? numSpecies : 0,std::vector<std::string>(numStrings));
+    for (std::vector<std::string>& speciesHover : cached.HoverData) {
+        for (std::string& runHover : speciesHover) {
+            stream >> hover;
+            runHover = hover.toStdString();
+        }
+    }
+    if ((stream.status() != QDataStream::Ok) || ! cached.isValid()) {
+        return false;
+    }
+
+    remember(key,cached);
+    data = cached;
+    return true;
+}
+
+void
+REMORA_ResultCache::pruneDisk()
+{
+    QFileInfoList files = QDir(m_Directory).entryInfoList(QStringList() << "*.rfc",QDir::Files,QDir::Time);
+
+    // Sorted newest first
+    for (int i=MaxDiskEntries; i<files.size(); ++i) {
+        QFile::remove(files[i].absoluteFilePath());
+    }
+}
+
+void
+REMORA_ResultCache::remember(
+        const std::string&         key,
+        const REMORA_ForecastData& data)
+{
+    if (m_Memory.find(key) == m_Memory.end()) {
+        m_MemoryOrder.push_back(key);
+    }
+    m_Memory[key] = data;
+    while (int(m_MemoryOrder.size()) > MaxMemoryEntries) {
+        m_Memory.erase(m_MemoryOrder.front());
+        m_MemoryOrder.pop_front();
+    }
+}
+
+bool
+REMORA_ResultCache::save(
+        const std::string&         key,
+        const REMORA_ForecastData& data)
+{
+    if (m_Directory.isEmpty() || ! data.isValid()) {
+        return false;
+    }
+    remember(key,data);
+
+    // Written to a temporary file and renamed so that a partial file is never read
+    QSaveFile file(filename(key));
+    if (! file.open(QIODevice::WriteOnly)) {
+        m_Logger->logMsg(nmfConstants::Warning,"REMORA_ResultCache: Couldn't write cache file: " +
+                         file.fileName().toStdString());
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+    stream << CacheFileMagic << CacheFileVersion << QString::fromStdString(key);
+    stream << qint32(data.NumSpecies) << qint32(data.NumYearsPerRun) << qint32(data.NumRunsPerForecast)
+           << qint32(data.NumRunsRequested) << data.IsConverged << quint64(data.BaseSeed);
+    for (int runNum=0; runNum<data.NumRunsPerForecast; ++runNum) {
+        stream << quint64((runNum < int(data.Seeds.size())) ? data.Seeds[runNum] : 0);
+    }
+    writeMatrix(stream,data.Biomass[0]);
+    writeTensor(stream,data.BiomassTensor);
+    stream << quint32(data.HoverData.empty() ? 0 : data.HoverData[0].size());
+    for (int species=0; species<data.NumSpecies && ! data.HoverData.empty(); ++species) {
+        for (const std::string& runHover : data.HoverData[species]) {
+            stream << QString::fromStdString(runHover);
+        }
+    }
+    if (! file.commit()) {
+        m_Logger->logMsg(nmfConstants::Warning,"REMORA_ResultCache: Couldn't write cache file: " +
+                         file.fileName().toStdString());
+        return false;
+    }
+
+    pruneDisk();
+    return true;
+}
+
+void
+REMORA_ResultCache::setDirectory(const QString& directory)
+{
+    if (directory == m_Directory) {
+        return;
+    }
+    m_Directory = directory;
+    m_Memory.clear();
+    m_MemoryOrder.clear();
+    if (! m_Directory.isEmpty() && ! QDir().mkpath(m_Directory)) {
+        m_Logger->logMsg(nmfConstants::Warning,"REMORA_ResultCache: Couldn't create cache directory: " +
+                         m_Directory.toStdString());
+        m_Directory.clear();
+    }
+}
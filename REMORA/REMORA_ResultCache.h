@@ -0,0 +1,114 @@
+/**
+ * @file REMORA_ResultCache.h
+ * @brief Definition for the REMORA forecast result cache
+ *
+ * This file contains the definition of the cache that stores finished forecasts on
+ * disk, keyed by a hash of everything that determines the forecast, so that a repeated
+ * run or a reloaded scenario may be restored without being simulated again.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+#ifndef REMORA_RESULTCACHE_H
+#define REMORA_RESULTCACHE_H
+
+#include <QString>
+
+#include "nmfLogger.h"
+#include "REMORA_ForecastData.h"
+#include "REMORA_ForecastEngine.h"
+
+#include <deque>
+#include <map>
+#include <string>
+
+/**
+ * @brief Content addressed cache of forecast results
+ *
+ * Each result is stored in its own file, named by its key, in the cache directory.
+ * The most recently used results are also kept in memory. The cache must only be
+ * used from a single thread.
+ */
+class REMORA_ResultCache
+{
+
+private:
+    static const int MaxMemoryEntries = 4;
+    static const int MaxDiskEntries   = 200;
+
+    nmfLogger*                                 m_Logger;
+    QString                                    m_Directory;
+    std::map<std::string, REMORA_ForecastData> m_Memory;
+    std::deque<std::string>                    m_MemoryOrder;
+
+    QString filename(const std::string& key);
+    void pruneDisk();
+    void remember(
+            const std::string&         key,
+            const REMORA_ForecastData& data);
+
+public:
+    /**
+     * @brief Class definition for the REMORA result cache
+     * @param logger : pointer to error logger API
+     */
+    REMORA_ResultCache(nmfLogger* logger);
+   ~REMORA_ResultCache();
+
+    /**
+     * @brief Computes the cache key of a forecast. The key covers the forecast and model
+     * identifiers, algorithm identifiers, model forms, species, years, runs, deterministic flag,
+     * uncertainties, harvest scale factors, and the estimated parameters and harvest, so that
+     * re-estimating the model or changing any control yields a different key.
+     * @param settings : the run settings
+     * @param parameters : the model parameters loaded for REMORA_ForecastEngine
+     * @return Hexadecimal SHA-256 digest
+     */
+    static std::string key(
+            const REMORA_RunSettings&     settings,
+            const REMORA_ModelParameters& parameters);
+    /**
+     * @brief Restores a forecast from the cache
+     * @param key : the cache key
+     * @param data : the forecast data
+     * @return true if found, false otherwise
+     */
+    bool load(const std::string&   key,
+              REMORA_ForecastData& data);
+    /**
+     * @brief Stores a forecast in the cache
+     * @param key : the cache key
+     * @param data : the forecast data
+     * @return true if written to disk, false otherwise
+     */
+    bool save(const std::string&         key,
+              const REMORA_ForecastData& data);
+    /**
+     * @brief Sets the directory in which the cache files are kept, creating it if needed.
+     * The in-memory entries are discarded if the directory changes.
+     * @param directory : the cache directory (empty disables the cache)
+     */
+    void setDirectory(const QString& directory);
+};
+
+#endif // REMORA_RESULTCACHE_H
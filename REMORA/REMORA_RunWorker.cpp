@@ -0,0 +1,496 @@
+#include "REMORA_RunWorker.h"
+
+#include "nmfConstants.h"
+#include "nmfConstantsMSSPM.h"
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <random>
+
+REMORA_RunWorker::REMORA_RunWorker(nmfLogger* logger) :
+    m_Cache(logger),
+    m_Store(logger)
+{
+    m_Logger = logger;
+    m_Cancel = false;
+}
+
+REMORA_RunWorker::~REMORA_RunWorker()
+{
+}
+
+void
+REMORA_RunWorker::cancel()
+{
+    m_Cancel = true;
+}
+
+void
+REMORA_RunWorker::clearCancel()
+{
+    m_Cancel = false;
+}
+
+bool
+REMORA_RunWorker::isCancelled()
+{
+    return m_Cancel;
+}
+
+QString
+REMORA_RunWorker::phaseDescription(const int& phase)
+{
+    switch (phase) {
+        case PhaseSaveForecastParameters:
+            return "Saving forecast parameters";
+        case PhaseSaveUncertaintyParameters:
+            return "Saving uncertainty parameters";
+        case PhaseSaveHarvestData:
+            return "Saving harvest data";
+        case PhaseSimulate:
+            return "Simulating forecast runs";
+        case PhaseLoadForecastData:
+            return "Loading forecast data";
+        case PhaseDraw:
+            return "Drawing";
+        default:
+            return "";
+    }
+}
+
+int
+REMORA_RunWorker::overallPercent(const int& phase, const int& phasePercent)
+{
+    return (100*phase + phasePercent)/NumPhases;
+}
+
+void
+REMORA_RunWorker::reportProgress(
+        const int&     phase,
+        const int&     phasePercent,
+        const QString& description)
+{
+    emit RunProgress(phase,overallPercent(phase,phasePercent),description);
+}
+
+bool
+REMORA_RunWorker::openDatabase(
+        const REMORA_RunSettings& settings,
+        std::string&              errorMsg)
+{
+    // A different connection holds different tables, so nothing saved in the last one is kept
+    if ((m_Database != nullptr) && (settings.ConnectionName != m_ConnectionName)) {
+        m_Storage.reset();
+        m_Database.reset();
+        m_LastSettings = REMORA_RunSettings();
+    }
+    if (m_Database == nullptr) {
+        m_Database.reset(new REMORA_Database(settings.ConnectionName,m_Logger));
+        m_ConnectionName = settings.ConnectionName;
+    }
+    m_Database->setProfiler(settings.QueryProfiler);
+    if (! m_Database->isOpen()) {
+        errorMsg = "REMORA_RunWorker: Couldn't open database connection: " +
+                    settings.ConnectionName.toStdString();
+        m_Storage.reset();
+        m_Database.reset();
+        return false;
+    }
+    if (m_Storage == nullptr) {
+        m_Storage = REMORA_Storage::create(m_Database.get(),m_Logger);
+    }
+    return true;
+}
+
+void
+REMORA_RunWorker::callback_RunSweep(
+        REMORA_RunSettings   settings,
+        REMORA_SweepSettings sweep)
+{
+    int lastPercent = -1;
+    int NumPoints   = sweep.XNumSteps*sweep.YNumSteps;
+    uint64_t baseSeed;
+    std::string errorMsg;
+    std::vector<double> lastYearsCatchValues;
+    boost::numeric::ublas::matrix<double> harvest;
+    REMORA_ModelParameters parameters;
+    REMORA_SweepResult result;
+    REMORA_SweepEngine engine;
+
+    if (! openDatabase(settings,errorMsg)) {
+        emit SweepFailed(QString::fromStdString(errorMsg));
+        return;
+    }
+    REMORA_ModelLoader loader(m_Database.get(),m_Logger);
+    if (! loader.getForecastHarvest(settings,lastYearsCatchValues,harvest,errorMsg) ||
+        ! loader.loadModelParameters(settings,lastYearsCatchValues,harvest,parameters,errorMsg)) {
+        emit SweepFailed(QString::fromStdString(errorMsg));
+        return;
+    }
+
+    if (settings.IsDeterministic) {
+        baseSeed = REMORA_ForecastEngine::DeterministicSeed;
+    } else {
+        std::random_device randomDevice;
+        baseSeed = (uint64_t(randomDevice()) << 32) | uint64_t(randomDevice());
+    }
+    m_Logger->logMsg(nmfConstants::Normal,"REMORA_RunWorker::callback_RunSweep: " +
+                     std::to_string(NumPoints) + " grid points of " +
+                     std::to_string(settings.NumRunsPerForecast) + " runs with base seed " +
+                     std::to_string(baseSeed));
+
+    emit SweepProgress(0);
+    bool finished = engine.run(parameters,settings,sweep,baseSeed,result,
+                               [&](int pointsCompleted) {
+        int percent = 100*pointsCompleted/std::max(1,NumPoints);
+        if (percent != lastPercent) {
+            lastPercent = percent;
+            emit SweepProgress(percent);
+        }
+        return ! isCancelled();
+    });
+    if (! finished) {
+        emit SweepCancelled();
+        return;
+    }
+
+    emit SweepFinished(result);
+}
+
+void
+REMORA_RunWorker::callback_SaveForecastConfiguration(REMORA_RunSettings settings)
+{
+    std::string errorMsg;
+    std::string unsupportedMsg;
+    std::vector<double> lastYearsCatchValues;
+    boost::numeric::ublas::matrix<double> harvest;
+    REMORA_ModelParameters parameters;
+
+    if (! openDatabase(settings,errorMsg)) {
+        emit RunFailed(QString::fromStdString(errorMsg));
+        return;
+    }
+    REMORA_ModelLoader loader(m_Database.get(),m_Logger);
+
+    // Only save what changed since the last completed run. Until this run completes
+    // the database may be partially updated, so the next run must save everything.
+    settings.markChanges(m_LastSettings);
+    m_LastSettings = REMORA_RunSettings();
+
+    if (! loader.getForecastHarvest(settings,lastYearsCatchValues,harvest,errorMsg)) {
+        emit RunFailed(QString::fromStdString(errorMsg));
+        return;
+    }
+
+    bool isSupported = loader.loadModelParameters(settings,lastYearsCatchValues,harvest,parameters,unsupportedMsg);
+    if (! saveForecastConfiguration(settings,harvest,errorMsg)) {
+        if (isCancelled()) {
+            emit RunCancelled();
+        } else {
+            emit RunFailed(QString::fromStdString(errorMsg));
+        }
+        return;
+    }
+    if (isCancelled()) {
+        emit RunCancelled();
+        return;
+    }
+
+    // Simulate the forecast here if the engine supports the model, else hand it to the host application.
+    // An identical forecast may have been simulated before. The parameters are part of the cache key,
+    // which is why the host application's forecasts, whose parameters aren't loaded, aren't cached.
+    if (isSupported) {
+        std::string cacheKey = REMORA_ResultCache::key(settings,parameters);
+        m_Cache.setDirectory(settings.CacheDir);
+        if (! restoreForecast(settings,parameters,cacheKey)) {
+            emit ModelParametersLoaded(parameters);
+            simulateForecast(settings,parameters,cacheKey);
+        }
+        return;
+    }
+    if (! m_Storage->sharesHostDatabase()) {
+        emit RunFailed(QString::fromStdString(unsupportedMsg +
+                       ". The host application can't simulate a forecast kept in a local database."));
+        return;
+    }
+    m_Logger->logMsg(nmfConstants::Warning,"REMORA_RunWorker: " + unsupportedMsg +
+                     ". Forecast will be simulated by the host application.");
+    if (settings.IsAdaptive) {
+        m_Logger->logMsg(nmfConstants::Warning,"REMORA_RunWorker: Adaptive mode isn't available to the "
+                         "host application. All " + std::to_string(settings.NumRunsPerForecast) + " runs will be simulated.");
+    }
+
+    // The store isn't kept in step with the host application's results, so the forecast is
+    // removed from it and drawn from the database instead
+    REMORA_ForecastData data;
+    setForecastIdentifiers(settings,data);
+    m_Store.setDirectory(settings.ForecastStoreDir);
+    m_Store.remove(data);
+
+    emit ForecastConfigurationSaved(settings);
+}
+
+bool
+REMORA_RunWorker::restoreForecast(
+        const REMORA_RunSettings&     settings,
+        const REMORA_ModelParameters& parameters,
+        const std::string&            cacheKey)
+{
+    REMORA_ForecastData data;
+
+    if (! m_Cache.load(cacheKey,data)) {
+        return false;
+    }
+    m_Logger->logMsg(nmfConstants::Normal,"REMORA_RunWorker::restoreForecast: Restored forecast " + cacheKey);
+
+    // An adaptive forecast keeps the number of runs it used
+    int NumRunsUsed = data.NumRunsPerForecast;
+    setForecastIdentifiers(settings,data);
+    data.NumRunsPerForecast = NumRunsUsed;
+    data.RecomputedSpecies.clear();
+    emit ModelParametersLoaded(parameters);
+    m_LastSettings   = settings;
+    m_LastParameters = parameters;
+    m_LastData       = data;
+    storeForecast(settings,data);
+
+    emit RunFinished(data);
+    return true;
+}
+
+void
+REMORA_RunWorker::simulateForecast(
+        const REMORA_RunSettings&     settings,
+        const REMORA_ModelParameters& parameters,
+        const std::string&            cacheKey)
+{
+    int lastPercent = -1;
+    int NumSpecies  = int(settings.SpeciesNames.size());
+    int NumRecomputed;
+    int batchStart  = 0;
+    int batchIntervalMSec = 100;
+    uint64_t baseSeed;
+    QElapsedTimer batchTimer;
+    std::vector<bool> recomputeSpecies(NumSpecies,true);
+    REMORA_ForecastData data;
+    REMORA_ForecastEngine engine;
+
+    setForecastIdentifiers(settings,data);
+
+    // If only scale factors changed, start from the last forecast and recompute only the
+    // changed species along with every species that interacts with them
+    bool isIncremental = ! settings.ForecastDirty && ! settings.isUncertaintyDirty() && ! settings.IsAdaptive &&
+                          m_LastData.matches(data.ProjectName,data.ModelName,data.ForecastName,
+                                             data.Algorithm,data.Minimizer,data.ObjectiveCriterion,data.Scaling,
+                                             data.NumSpecies,data.NumYearsPerRun,data.NumRunsRequested);
+    if (isIncremental) {
+        std::vector<bool> changedSpecies = REMORA_ForecastEngine::changedSpecies(m_LastParameters,parameters);
+        for (int species=0; species<NumSpecies; ++species) {
+            changedSpecies[species] = changedSpecies[species] || settings.DirtySpecies[species];
+        }
+        recomputeSpecies = REMORA_ForecastEngine::dependencyClosure(parameters,changedSpecies);
+        data     = m_LastData;
+        baseSeed = m_LastData.BaseSeed;
+    } else if (settings.IsDeterministic) {
+        // A deterministic forecast always uses the same seed so that its runs may be reproduced
+        baseSeed = REMORA_ForecastEngine::DeterministicSeed;
+    } else {
+        std::random_device randomDevice;
+        baseSeed = (uint64_t(randomDevice()) << 32) | uint64_t(randomDevice());
+    }
+    m_LastData.clear();
+
+    NumRecomputed = int(std::count(recomputeSpecies.begin(),recomputeSpecies.end(),true));
+    m_Logger->logMsg(nmfConstants::Normal,"REMORA_RunWorker::simulateForecast: " +
+                     std::to_string(settings.NumRunsPerForecast) + " runs of " +
+                     std::to_string(NumRecomputed) + " of " + std::to_string(NumSpecies) +
+                     " species with base seed " + std::to_string(baseSeed));
+
+    // Runs are sent to the GUI in batches as they complete, the first batch being sent
+    // immediately so that the forecast without uncertainty is drawn first. Incremental
+    // runs are quick and the previous forecast is already drawn, so they aren't streamed.
+    auto sendBatch = [&](int, int lastRun) {
+        REMORA_RunBatch batch;
+        if (isIncremental || isCancelled()) {
+            return;
+        }
+        if (batchTimer.isValid() && (lastRun < settings.NumRunsPerForecast) &&
+            (batchTimer.elapsed() < batchIntervalMSec)) {
+            return;
+        }
+        batch.ProjectName        = data.ProjectName;
+        batch.ModelName          = data.ModelName;
+        batch.ForecastName       = data.ForecastName;
+        batch.NumSpecies         = NumSpecies;
+        batch.NumYearsPerRun     = settings.NumYearsPerRun;
+        batch.NumRunsPerForecast = settings.NumRunsPerForecast;
+        batch.FirstRun           = batchStart;
+        batch.BiomassMonteCarlo.resize(lastRun-batchStart);
+        for (int runNum=batchStart; runNum<lastRun; ++runNum) {
+            data.BiomassTensor.getRun(runNum,batch.BiomassMonteCarlo[runNum-batchStart]);
+        }
+        if (batchStart == 0) {
+            batch.Biomass = data.Biomass;
+        }
+        batchStart = lastRun;
+        batchTimer.start();
+        emit RunBatchSimulated(batch);
+    };
+
+    reportProgress(PhaseSimulate,0,phaseDescription(PhaseSimulate));
+    bool finished = (NumRecomputed == 0) ||
+                    engine.run(parameters,settings,baseSeed,recomputeSpecies,data,
+                               [&](int runsCompleted) {
+        int percent = 100*runsCompleted/std::max(1,settings.NumRunsPerForecast);
+        if (percent != lastPercent) {
+            lastPercent = percent;
+            reportProgress(PhaseSimulate,percent,phaseDescription(PhaseSimulate));
+        }
+        return ! isCancelled();
+    },sendBatch);
+    if (! finished) {
+        emit RunCancelled();
+        return;
+    }
+    data.RecomputedSpecies = recomputeSpecies;
+    if (settings.IsAdaptive) {
+        m_Logger->logMsg(nmfConstants::Normal,"REMORA_RunWorker::simulateForecast: Adaptive forecast " +
+                         std::string(data.IsConverged ? "converged" : "didn't converge") + " after " +
+                         std::to_string(data.NumRunsPerForecast) + " of " +
+                         std::to_string(data.NumRunsRequested) + " runs");
+    }
+
+    m_LastSettings   = settings;
+    m_LastParameters = parameters;
+    m_LastData       = data;
+    m_Cache.save(cacheKey,data);
+    storeForecast(settings,data);
+
+    emit RunFinished(data);
+}
+
+void
+REMORA_RunWorker::setForecastIdentifiers(
+        const REMORA_RunSettings& settings,
+        REMORA_ForecastData&      data)
+{
+    data.ProjectName        = settings.ProjectName;
+    data.ModelName          = settings.ModelName;
+    data.ForecastName       = settings.ForecastName;
+    data.Algorithm          = settings.ForecastAlgorithm;
+    data.Minimizer          = settings.ForecastMinimizer;
+    data.ObjectiveCriterion = settings.ForecastObjectiveCriterion;
+    data.Scaling            = settings.ForecastScaling;
+    data.NumSpecies         = int(settings.SpeciesNames.size());
+    data.NumYearsPerRun     = settings.NumYearsPerRun;
+    data.NumRunsPerForecast = settings.NumRunsPerForecast;
+    data.NumRunsRequested   = settings.NumRunsPerForecast;
+}
+
+void
+REMORA_RunWorker::storeForecast(
+        const REMORA_RunSettings&  settings,
+        const REMORA_ForecastData& data)
+{
+    QElapsedTimer timer;
+
+    timer.start();
+    m_Store.setDirectory(settings.ForecastStoreDir);
+
+    // The host application's tables still hold any forecast it simulated under this name,
+    // which the mark keeps from being drawn should the file be missing
+    m_Store.markEngineForecast(data);
+    if (m_Store.save(data)) {
+        m_Logger->logMsg(nmfConstants::Normal,"REMORA_RunWorker::storeForecast: Wrote " +
+                         std::to_string(data.NumRunsPerForecast) + " runs in " +
+                         std::to_string(timer.elapsed()) + " ms");
+    }
+}
+
+void
+REMORA_RunWorker::callback_LoadForecastData(REMORA_RunSettings settings)
+{
+    std::string errorMsg;
+    REMORA_ForecastData data;
+
+    if (isCancelled()) {
+        emit RunCancelled();
+        return;
+    }
+    if (! openDatabase(settings,errorMsg)) {
+        emit RunFailed(QString::fromStdString(errorMsg));
+        return;
+    }
+
+    setForecastIdentifiers(settings,data);
+
+    reportProgress(PhaseLoadForecastData,0,phaseDescription(PhaseLoadForecastData));
+    auto progress = [this](int percent) {
+        reportProgress(PhaseLoadForecastData,90*percent/100,phaseDescription(PhaseLoadForecastData));
+        return ! isCancelled();
+    };
+    if (! m_Storage->loadForecastBiomassMonteCarlo(settings.SpeciesNames,-1,data,progress,errorMsg)) {
+        if (isCancelled()) {
+            emit RunCancelled();
+        } else {
+            emit RunFailed(QString::fromStdString(errorMsg));
+        }
+        return;
+    }
+    reportProgress(PhaseLoadForecastData,90,phaseDescription(PhaseLoadForecastData));
+    if (! m_Storage->loadForecastBiomass(settings.SpeciesNames,data,errorMsg)) {
+        emit RunFailed(QString::fromStdString(errorMsg));
+        return;
+    }
+    if (isCancelled()) {
+        emit RunCancelled();
+        return;
+    }
+    m_LastSettings = settings;
+
+    emit RunFinished(data);
+}
+
+bool
+REMORA_RunWorker::saveForecastConfiguration(
+        const REMORA_RunSettings&                    settings,
+        const boost::numeric::ublas::matrix<double>& harvest,
+        std::string&                                 errorMsg)
+{
+    // All of the configuration is committed together so that a failure or cancel
+    // part way through never leaves a half written scenario.
+    m_Database->setCallSite("REMORA_RunWorker::saveForecastConfiguration");
+    if (! m_Storage->transaction()) {
+        errorMsg = "Couldn't start a transaction to save the forecast configuration.";
+        return false;
+    }
+
+    reportProgress(PhaseSaveForecastParameters,0,phaseDescription(PhaseSaveForecastParameters));
+    if ((settings.ForecastDirty && ! m_Storage->saveForecastParameters(settings,errorMsg)) || isCancelled()) {
+        m_Storage->rollback();
+        return false;
+    }
+
+    reportProgress(PhaseSaveUncertaintyParameters,0,phaseDescription(PhaseSaveUncertaintyParameters));
+    if ((settings.isUncertaintyDirty() && ! m_Storage->saveUncertaintyParameters(settings,errorMsg)) || isCancelled()) {
+        m_Storage->rollback();
+        return false;
+    }
+
+    reportProgress(PhaseSaveHarvestData,0,phaseDescription(PhaseSaveHarvestData));
+    if (! m_Storage->saveHarvest(settings,harvest,errorMsg) || isCancelled()) {
+        m_Storage->rollback();
+        return false;
+    }
+    reportProgress(PhaseSaveHarvestData,100,phaseDescription(PhaseSaveHarvestData));
+
+    m_Database->setCallSite("REMORA_RunWorker::saveForecastConfiguration");
+    if (! m_Storage->commit()) {
+        m_Storage->rollback();
+        errorMsg = "Couldn't commit the forecast configuration.";
+        return false;
+    }
+    return true;
+}
+
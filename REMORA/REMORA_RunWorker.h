@@ -0,0 +1,244 @@
+/**
+ * @file REMORA_RunWorker.h
+ * @brief Definition for the REMORA run pipeline worker
+ *
+ * This file contains the definition of the worker object that performs the
+ * database intensive phases of a REMORA forecast run. The worker lives on its
+ * own thread so that the REMORA GUI stays responsive while a run is in progress.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+#ifndef REMORA_RUNWORKER_H
+#define REMORA_RUNWORKER_H
+
+#include <QObject>
+#include <QString>
+
+#include "nmfLogger.h"
+#include "REMORA_Database.h"
+#include "REMORA_ForecastData.h"
+#include "REMORA_ForecastEngine.h"
+#include "REMORA_ForecastStore.h"
+#include "REMORA_ModelLoader.h"
+#include "REMORA_ResultCache.h"
+#include "REMORA_Storage.h"
+#include "REMORA_Sweep.h"
+
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Worker that runs the phases of a REMORA forecast off of the GUI thread
+ *
+ * A run consists of the following phases, of which all but the drawing phase
+ * are performed by this worker:
+ *   -# save the forecast parameters
+ *   -# save the uncertainty parameters
+ *   -# save the harvest data (these three phases are committed in one transaction)
+ *   -# simulate (performed by REMORA_ForecastEngine, or by the host application on
+ *      the GUI thread if the engine doesn't support the model's forms and the data are
+ *      kept in the host application's database, unless an identical forecast is found
+ *      in REMORA_ResultCache)
+ *   -# load the forecast data (only if simulated by the host application)
+ *   -# draw (performed by REMORA_UI on the GUI thread)
+ *
+ * The configuration is saved and the forecast loaded through REMORA_Storage, so the data
+ * may be kept in the host application's database or in a local SQLite file.
+ *
+ * Each forecast simulated by the engine is also written to REMORA_ForecastStore, from
+ * which REMORA_UI memory-maps it when the forecast is next drawn without being run. A
+ * forecast simulated by the host application is removed from the store, so that
+ * REMORA_UI only draws a forecast from the database if the host simulated it.
+ */
+class REMORA_RunWorker : public QObject
+{
+    Q_OBJECT
+
+private:
+    std::atomic<bool>                m_Cancel;
+    nmfLogger*                       m_Logger;
+    std::unique_ptr<REMORA_Database> m_Database;
+    QString                          m_ConnectionName; // Connection m_Database was opened from
+    std::unique_ptr<REMORA_Storage>  m_Storage;        // Reads and writes the REMORA tables of m_Database
+    REMORA_RunSettings               m_LastSettings;   // Settings of the last completed run
+    REMORA_ModelParameters           m_LastParameters; // Parameters of the last forecast simulated by the engine
+    REMORA_ForecastData              m_LastData;       // Last forecast simulated by the engine
+    REMORA_ResultCache               m_Cache;
+    REMORA_ForecastStore             m_Store;
+
+    bool isCancelled();
+    bool openDatabase(
+            const REMORA_RunSettings& settings,
+            std::string&              errorMsg);
+    void reportProgress(
+            const int&     phase,
+            const int&     phasePercent,
+            const QString& description);
+    bool saveForecastConfiguration(
+            const REMORA_RunSettings&                    settings,
+            const boost::numeric::ublas::matrix<double>& harvest,
+            std::string&                                 errorMsg);
+    void storeForecast(
+            const REMORA_RunSettings&  settings,
+            const REMORA_ForecastData& data);
+    bool restoreForecast(
+            const REMORA_RunSettings&     settings,
+            const REMORA_ModelParameters& parameters,
+            const std::string&            cacheKey);
+    void simulateForecast(
+            const REMORA_RunSettings&     settings,
+            const REMORA_ModelParameters& parameters,
+            const std::string&            cacheKey);
+    void setForecastIdentifiers(
+            const REMORA_RunSettings& settings,
+            REMORA_ForecastData&      data);
+
+public:
+    /**
+     * @brief The phases of a REMORA run, in the order in which they're performed
+     */
+    enum Phase {
+        PhaseSaveForecastParameters = 0,
+        PhaseSaveUncertaintyParameters,
+        PhaseSaveHarvestData,
+        PhaseSimulate,
+        PhaseLoadForecastData,
+        PhaseDraw,
+        NumPhases
+    };
+
+    /**
+     * @brief Class definition for the REMORA run worker
+     * @param logger : pointer to error logger API
+     */
+    REMORA_RunWorker(nmfLogger* logger);
+   ~REMORA_RunWorker();
+
+    /**
+     * @brief Requests that the current run stop at the next opportunity. This may be
+     * called from any thread.
+     */
+    void cancel();
+    /**
+     * @brief Clears any previous cancel request. Called by the GUI thread prior to starting a run.
+     */
+    void clearCancel();
+    /**
+     * @brief Returns a short description of the passed phase suitable for a progress bar
+     * @param phase : the run phase
+     * @return Description of the phase
+     */
+    static QString phaseDescription(const int& phase);
+    /**
+     * @brief Converts a phase and a percentage within that phase into an overall run percentage
+     * @param phase : the run phase
+     * @param phasePercent : percentage complete (0-100) of the phase
+     * @return Overall percentage complete (0-100) of the run
+     */
+    static int overallPercent(const int& phase, const int& phasePercent);
+
+signals:
+    /**
+     * @brief Signal emitted when the forecast, uncertainty, and harvest data have been saved
+     * and the forecast must be simulated by the host application
+     * @param settings : the settings used for the run
+     */
+    void ForecastConfigurationSaved(REMORA_RunSettings settings);
+    /**
+     * @brief Signal emitted when the estimated model parameters for a forecast simulated
+     * by REMORA_ForecastEngine have been loaded
+     * @param parameters : the model parameters and forecast harvest
+     */
+    void ModelParametersLoaded(REMORA_ModelParameters parameters);
+    /**
+     * @brief Signal emitted when the user cancelled the run
+     */
+    void RunCancelled();
+    /**
+     * @brief Signal emitted when a phase of the run has failed
+     * @param msg : message describing the failure
+     */
+    void RunFailed(QString msg);
+    /**
+     * @brief Signal emitted when the forecast data have been simulated or loaded and are ready to be drawn
+     * @param data : the forecast data
+     */
+    void RunFinished(REMORA_ForecastData data);
+    /**
+     * @brief Signal emitted as the run progresses
+     * @param phase : the current run phase
+     * @param percent : overall percentage complete (0-100) of the run
+     * @param description : description of the current phase
+     */
+    void RunProgress(int phase, int percent, QString description);
+    /**
+     * @brief Signal emitted periodically while the engine simulates a forecast with the
+     * runs completed since the last batch, so that they may be drawn before the run finishes.
+     * Batches arrive in run order and the first one also holds the forecast without uncertainty.
+     * @param batch : the newly completed runs
+     */
+    void RunBatchSimulated(REMORA_RunBatch batch);
+    /**
+     * @brief Signal emitted when the user cancelled the sweep
+     */
+    void SweepCancelled();
+    /**
+     * @brief Signal emitted when the sweep couldn't be performed
+     * @param msg : message describing the failure
+     */
+    void SweepFailed(QString msg);
+    /**
+     * @brief Signal emitted when every point of the sweep grid has been simulated
+     * @param result : the sweep result
+     */
+    void SweepFinished(REMORA_SweepResult result);
+    /**
+     * @brief Signal emitted as the sweep progresses
+     * @param percent : percentage complete (0-100) of the sweep
+     */
+    void SweepProgress(int percent);
+
+public Q_SLOTS:
+    /**
+     * @brief Callback invoked to load the forecast data once the simulation has completed
+     * @param settings : the settings used for the run
+     */
+    void callback_LoadForecastData(REMORA_RunSettings settings);
+    /**
+     * @brief Callback invoked to save the forecast, uncertainty, and harvest data for a run
+     * and then simulate the forecast
+     * @param settings : snapshot of the REMORA controls
+     */
+    void callback_SaveForecastConfiguration(REMORA_RunSettings settings);
+    /**
+     * @brief Callback invoked to simulate the forecast over a grid of uncertainty or harvest
+     * values. Nothing is saved to the database.
+     * @param settings : snapshot of the REMORA controls
+     * @param sweep : the sweep grid and metric
+     */
+    void callback_RunSweep(REMORA_RunSettings   settings,
+                           REMORA_SweepSettings sweep);
+};
+
+#endif // REMORA_RUNWORKER_H
@@ -0,0 +1,350 @@
+#include "REMORA_SQLiteStorage.h"
+
+#include "nmfConstants.h"
+#include "nmfConstantsMSSPM.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QVariant>
+
+#include <map>
+
+// Identifiers of an estimation, and of a forecast of that estimation
+static const std::string AlgorithmKey = "ProjectName,ModelName,Algorithm,Minimizer,ObjectiveCriterion,Scaling";
+static const std::string ForecastKey  = "ProjectName,ModelName,ForecastName,Algorithm,Minimizer,ObjectiveCriterion,Scaling";
+
+static std::string
+keyColumns(const std::string& key)
+{
+    std::string columns;
+
+    for (const QString& name : QString::fromStdString(key).split(",")) {
+        columns += name.toStdString() + " TEXT NOT NULL,";
+    }
+    return columns;
+}
+
+REMORA_SQLiteStorage::REMORA_SQLiteStorage(
+        REMORA_Database* database,
+        nmfLogger*       logger) :
+    REMORA_SqlStorage(database,logger)
+{
+    // These settings belong to the connection rather than the file
+    m_Database->setCallSite("REMORA_SQLiteStorage::REMORA_SQLiteStorage");
+    m_Database->nmfUpdateDatabase("PRAGMA busy_timeout = " + std::to_string(BusyTimeout));
+    m_Database->nmfUpdateDatabase("PRAGMA synchronous = NORMAL");
+}
+
+REMORA_SQLiteStorage::~REMORA_SQLiteStorage()
+{
+}
+
+bool
+REMORA_SQLiteStorage::addConnection(
+        const QString& connectionName,
+        const QString& filename,
+        nmfLogger*     logger)
+{
+    if (QSqlDatabase::contains(connectionName)) {
+        return QSqlDatabase::database(connectionName,false).isOpen();
+    }
+    QDir().mkpath(QFileInfo(filename).absolutePath());
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE",connectionName);
+        db.setDatabaseName(filename);
+        if (! db.open()) {
+            logger->logMsg(nmfConstants::Error,"REMORA_SQLiteStorage: Couldn't open " + filename.toStdString() +
+                           ": " + db.lastError().text().toStdString());
+            db = QSqlDatabase();
+            QSqlDatabase::removeDatabase(connectionName);
+            return false;
+        }
+    }
+
+    // The journal mode is kept in the file, so it needn't be set by the cloned connections
+    REMORA_Database database(connectionName,logger);
+    database.setCallSite("REMORA_SQLiteStorage::addConnection");
+    database.nmfUpdateDatabase("PRAGMA journal_mode = WAL");
+    return createSchema(database,logger);
+}
+
+bool
+REMORA_SQLiteStorage::createSchema(
+        REMORA_Database& database,
+        nmfLogger*       logger)
+{
+    std::string errorMsg;
+    std::vector<std::string> statements;
+    std::string uncertaintyColumns;
+
+    for (const char* name : {"InitBiomass","GrowthRate","GrowthRateShape","CarryingCapacity","Catchability","Harvest",
+                                    "CompetitionAlpha","CompetitionBetaSpecies","CompetitionBetaGuilds","CompetitionBetaGuildsGuilds",
+                                    "PredationRho","PredationHandling","PredationExponent","SurveyQ",
+                                    "GrowthRateCovCoeff","CarryingCapacityCovCoeff","CatchabilityCovCoeff","SurveyQCovCoeff"}) {
+        uncertaintyColumns += std::string(name) + " REAL NOT NULL DEFAULT 0,";
+    }
+
+    // Model tables read by REMORA_ModelLoader and REMORA_UI
+    statements.push_back("CREATE TABLE IF NOT EXISTS " + nmfConstantsMSSPM::TableSpecies +
+                         " (SpeName TEXT NOT NULL PRIMARY KEY)");
+    statements.push_back("CREATE TABLE IF NOT EXISTS " + nmfConstantsMSSPM::TableModels +
+                         " (ProjectName TEXT NOT NULL, ModelName TEXT NOT NULL,"
+                         " StartYear INTEGER NOT NULL, RunLength INTEGER NOT NULL,"
+                         " PRIMARY KEY (ProjectName,ModelName))");
+    for (const std::string& table : {nmfConstantsMSSPM::TableOutputGrowthRate,
+                                     nmfConstantsMSSPM::TableOutputCarryingCapacity,
+                                     nmfConstantsMSSPM::TableOutputCatchability,
+                                     nmfConstantsMSSPM::TableOutputPredationExponent}) {
+        statements.push_back("CREATE TABLE IF NOT EXISTS " + table + " (" + keyColumns(AlgorithmKey) +
+                             " SpeName TEXT NOT NULL, Value REAL NOT NULL,"
+                             " PRIMARY KEY (" + AlgorithmKey + ",SpeName))");
+    }
+    statements.push_back("CREATE TABLE IF NOT EXISTS " + nmfConstantsMSSPM::TableOutputBiomass + " (" +
+                         keyColumns(AlgorithmKey) +
+                         " SpeName TEXT NOT NULL, Year INTEGER NOT NULL, Value REAL NOT NULL,"
+                         " PRIMARY KEY (" + AlgorithmKey + ",Year,SpeName)) WITHOUT ROWID");
+    for (const std::string& table : {nmfConstantsMSSPM::TableOutputCompetitionAlpha,
+                                     nmfConstantsMSSPM::TableOutputCompetitionBetaSpecies,
+                                     nmfConstantsMSSPM::TableOutputPredationRho,
+                                     nmfConstantsMSSPM::TableOutputPredationHandling}) {
+        statements.push_back("CREATE TABLE IF NOT EXISTS " + table + " (" + keyColumns(AlgorithmKey) +
+                             " SpeciesA TEXT NOT NULL, SpeciesB TEXT NOT NULL, Value REAL NOT NULL,"
+                             " PRIMARY KEY (" + AlgorithmKey + ",SpeciesA,SpeciesB))");
+    }
+    for (const std::string& table : {nmfConstantsMSSPM::TableOutputMSYBiomass,
+                                     nmfConstantsMSSPM::TableOutputMSYFishing}) {
+        statements.push_back("CREATE TABLE IF NOT EXISTS " + table + " (" + keyColumns(AlgorithmKey) +
+                             " isAggProd INTEGER NOT NULL, SpeName TEXT NOT NULL, Value REAL NOT NULL,"
+                             " PRIMARY KEY (" + AlgorithmKey + ",isAggProd,SpeName))");
+    }
+
+    // Forecast tables written by REMORA (the harvest table names are those built by REMORA_UI::setHarvestType)
+    statements.push_back("CREATE TABLE IF NOT EXISTS " + nmfConstantsMSSPM::TableForecasts +
+                         " (ProjectName TEXT NOT NULL, ForecastName TEXT NOT NULL, ModelName TEXT NOT NULL,"
+                         " Algorithm TEXT NOT NULL, Minimizer TEXT NOT NULL, ObjectiveCriterion TEXT NOT NULL,"
+                         " Scaling TEXT NOT NULL, GrowthForm TEXT NOT NULL, HarvestForm TEXT NOT NULL,"
+                         " WithinGuildCompetitionForm TEXT NOT NULL, PredationForm TEXT NOT NULL,"
+                         " NumRuns INTEGER NOT NULL DEFAULT 0, RunLength INTEGER NOT NULL DEFAULT 0,"
+                         " StartYear INTEGER NOT NULL DEFAULT 0, EndYear INTEGER NOT NULL DEFAULT 0,"
+                         " IsDeterministic INTEGER NOT NULL DEFAULT 0,"
+                         " PRIMARY KEY (ProjectName,ForecastName))");
+    statements.push_back("CREATE TABLE IF NOT EXISTS " + nmfConstantsMSSPM::TableForecastUncertainty + " (" +
+                         keyColumns(ForecastKey) + " SpeName TEXT NOT NULL," + uncertaintyColumns +
+                         " PRIMARY KEY (" + ForecastKey + ",SpeName))");
+    for (const std::string& harvestType : std::vector<std::string>{"Catch","Effort","Exploitation"}) {
+        statements.push_back("CREATE TABLE IF NOT EXISTS Harvest" + harvestType +
+                             " (ProjectName TEXT NOT NULL, ModelName TEXT NOT NULL,"
+                             " SpeName TEXT NOT NULL, Year INTEGER NOT NULL, Value REAL NOT NULL,"
+                             " PRIMARY KEY (ProjectName,ModelName,Year,SpeName)) WITHOUT ROWID");
+        statements.push_back("CREATE TABLE IF NOT EXISTS ForecastHarvest" + harvestType + " (" +
+                             keyColumns(ForecastKey) +
+                             " SpeName TEXT NOT NULL, Year INTEGER NOT NULL, Value REAL NOT NULL,"
+                             " PRIMARY KEY (" + ForecastKey + ",SpeName,Year)) WITHOUT ROWID");
+    }
+    statements.push_back("CREATE TABLE IF NOT EXISTS " + nmfConstantsMSSPM::TableForecastBiomass + " (" +
+                         keyColumns(ForecastKey) +
+                         " SpeName TEXT NOT NULL, Year INTEGER NOT NULL, Value REAL NOT NULL,"
+                         " PRIMARY KEY (" + ForecastKey + ",SpeName,Year)) WITHOUT ROWID");
+    statements.push_back("CREATE TABLE IF NOT EXISTS " + nmfConstantsMSSPM::TableForecastBiomassMonteCarlo + " (" +
+                         keyColumns(ForecastKey) +
+                         " RunNum INTEGER NOT NULL, SpeName TEXT NOT NULL, Year INTEGER NOT NULL, Value REAL NOT NULL,"
+                         " PRIMARY KEY (" + ForecastKey + ",RunNum,SpeName,Year)) WITHOUT ROWID");
+
+    if (! database.transaction()) {
+        return false;
+    }
+    for (const std::string& statement : statements) {
+        errorMsg = database.nmfUpdateDatabase(statement);
+        if (! errorMsg.empty()) {
+            logger->logMsg(nmfConstants::Error,"REMORA_SQLiteStorage::createSchema: " + errorMsg);
+            logger->logMsg(nmfConstants::Error,"cmd: " + statement);
+            database.rollback();
+            return false;
+        }
+    }
+    return database.commit();
+}
+
+bool
+REMORA_SQLiteStorage::isSeeded(
+        REMORA_Database&   local,
+        const std::string& projectName,
+        const std::string& modelName,
+        const std::string& forecastName)
+{
+    REMORA_QueryResult result;
+    std::string queryStr =
+            "SELECT (SELECT COUNT(*) FROM " + nmfConstantsMSSPM::TableSpecies + ") AS NumSpecies,"
+            " (SELECT COUNT(*) FROM " + nmfConstantsMSSPM::TableModels +
+            "  WHERE ProjectName = '" + projectName + "' AND ModelName = '" + modelName + "') AS NumModels,"
+            " (SELECT COUNT(*) FROM " + nmfConstantsMSSPM::TableForecasts +
+            "  WHERE ProjectName = '" + projectName + "' AND ForecastName = '" + forecastName + "') AS NumForecasts";
+
+    local.setCallSite("REMORA_SQLiteStorage::isSeeded");
+    if (! local.nmfQueryColumns(queryStr,{{"NumSpecies",  REMORA_Column::Integer},
+                                          {"NumModels",   REMORA_Column::Integer},
+                                          {"NumForecasts",REMORA_Column::Integer}},result) ||
+        (result.NumRows == 0)) {
+        return false;
+    }
+    return (result.Integer["NumSpecies"][0]   > 0) &&
+           (result.Integer["NumModels"][0]    > 0) &&
+           (result.Integer["NumForecasts"][0] > 0);
+}
+
+bool
+REMORA_SQLiteStorage::saveForecastParameters(
+        const REMORA_RunSettings& settings,
+        std::string&              errorMsg)
+{
+    // The forecast's row may not have been seeded, in which case it's added before being updated
+    std::string cmd =
+            "INSERT OR IGNORE INTO " +
+             nmfConstantsMSSPM::TableForecasts +
+            " (ProjectName,ForecastName,ModelName,Algorithm,Minimizer,ObjectiveCriterion,Scaling,"
+            "GrowthForm,HarvestForm,WithinGuildCompetitionForm,PredationForm,StartYear) VALUES ('" +
+             settings.ProjectName                + "','" +
+             settings.ForecastName               + "','" +
+             settings.ModelName                  + "','" +
+             settings.ForecastAlgorithm          + "','" +
+             settings.ForecastMinimizer          + "','" +
+             settings.ForecastObjectiveCriterion + "','" +
+             settings.ForecastScaling            + "','" +
+             settings.GrowthForm                 + "','" +
+             settings.HarvestForm                + "','" +
+             settings.CompetitionForm            + "','" +
+             settings.PredationForm              + "',"  +
+             std::to_string(settings.EndYear)    + ")";
+    m_Database->setCallSite("REMORA_SQLiteStorage::saveForecastParameters");
+    errorMsg = m_Database->nmfUpdateDatabase(cmd);
+    if (! errorMsg.empty()) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA_SQLiteStorage::saveForecastParameters: INSERT error: " + errorMsg);
+        m_Logger->logMsg(nmfConstants::Error,"cmd: " + cmd);
+        errorMsg = "Couldn't add the forecast to the " + nmfConstantsMSSPM::TableForecasts + " table.";
+        return false;
+    }
+    return REMORA_SqlStorage::saveForecastParameters(settings,errorMsg);
+}
+
+bool
+REMORA_SQLiteStorage::seed(
+        REMORA_Database&   host,
+        REMORA_Database&   local,
+        const std::string& projectName,
+        const std::string& modelName,
+        const std::string& forecastName,
+        std::string&       errorMsg)
+{
+    std::string modelClause    = " WHERE ProjectName = '" + projectName +
+                                 "' AND ModelName = '"    + modelName + "'";
+    std::string forecastClause = " WHERE ProjectName = '" + projectName +
+                                 "' AND ForecastName = '" + forecastName + "'";
+    std::vector<std::pair<std::string,std::string> > tables = {
+        {nmfConstantsMSSPM::TableSpecies,                      ""},
+        {nmfConstantsMSSPM::TableModels,                       modelClause},
+        {nmfConstantsMSSPM::TableOutputBiomass,                modelClause},
+        {nmfConstantsMSSPM::TableOutputGrowthRate,             modelClause},
+        {nmfConstantsMSSPM::TableOutputCarryingCapacity,       modelClause},
+        {nmfConstantsMSSPM::TableOutputCatchability,           modelClause},
+        {nmfConstantsMSSPM::TableOutputPredationExponent,      modelClause},
+        {nmfConstantsMSSPM::TableOutputCompetitionAlpha,       modelClause},
+        {nmfConstantsMSSPM::TableOutputCompetitionBetaSpecies, modelClause},
+        {nmfConstantsMSSPM::TableOutputPredationRho,           modelClause},
+        {nmfConstantsMSSPM::TableOutputPredationHandling,      modelClause},
+        {nmfConstantsMSSPM::TableOutputMSYBiomass,             modelClause},
+        {nmfConstantsMSSPM::TableOutputMSYFishing,             modelClause},
+        {nmfConstantsMSSPM::TableForecasts,                    forecastClause}};
+
+    // Named as REMORA_ModelLoader::getLastYearsCatchValues names them (SQLite table names aren't case sensitive)
+    for (const std::string& harvestType : std::vector<std::string>{"catch","effort","exploitation"}) {
+        tables.push_back({"harvest" + harvestType,modelClause});
+    }
+
+    host.setCallSite("REMORA_SQLiteStorage::seed");
+    local.setCallSite("REMORA_SQLiteStorage::seed");
+    if (! local.transaction()) {
+        errorMsg = "Couldn't start a transaction on the SQLite file";
+        return false;
+    }
+    for (const std::pair<std::string,std::string>& table : tables) {
+        if (! seedTable(host,local,table.first,table.second,errorMsg)) {
+            local.rollback();
+            return false;
+        }
+    }
+    if (! local.commit()) {
+        errorMsg = "Couldn't commit the seeded rows to the SQLite file";
+        return false;
+    }
+    return true;
+}
+
+bool
+REMORA_SQLiteStorage::seedTable(
+        REMORA_Database&   host,
+        REMORA_Database&   local,
+        const std::string& table,
+        const std::string& whereClause,
+        std::string&       errorMsg)
+{
+    std::string fieldList;
+    std::vector<std::string> fields;
+    std::vector<REMORA_Column> columns;
+    REMORA_QueryResult result;
+    QVariantList values;
+
+    // The file's tables have only the columns REMORA uses, so those are the ones copied
+    std::map<std::string, std::vector<std::string> > tableInfo =
+            local.nmfQueryDatabase("PRAGMA table_info(" + table + ")",{"name","type"});
+    for (unsigned i=0; i<tableInfo["name"].size(); ++i) {
+        const std::string& type = tableInfo["type"][i];
+        fields.push_back(tableInfo["name"][i]);
+        fieldList += ((i == 0) ? "" : ",") + fields.back();
+        columns.push_back({fields.back(),(type == "INTEGER") ? REMORA_Column::Integer :
+                                         (type == "REAL")    ? REMORA_Column::Real : REMORA_Column::Text});
+    }
+    if (fields.empty()) {
+        errorMsg = "No table " + table + " in the SQLite file";
+        return false;
+    }
+
+    if (! host.nmfQueryColumns("SELECT " + fieldList + " FROM " + table + whereClause,columns,result)) {
+        errorMsg = "Couldn't query table " + table + ": " + host.lastError();
+        return false;
+    }
+    values.reserve(result.NumRows*int(columns.size()));
+    for (int row=0; row<result.NumRows; ++row) {
+        for (const REMORA_Column& column : columns) {
+            switch (column.DataType) {
+                case REMORA_Column::Text:
+                    values << QString::fromStdString(result.Text[column.Name][row]);
+                    break;
+                case REMORA_Column::Integer:
+                    values << result.Integer[column.Name][row];
+                    break;
+                case REMORA_Column::Real:
+                    values << result.Real[column.Name][row];
+                    break;
+            }
+        }
+    }
+
+    errorMsg = local.nmfUpdateDatabase("DELETE FROM " + table + whereClause);
+    if (errorMsg.empty()) {
+        errorMsg = local.nmfInsertRows(table,fields,values);
+    }
+    if (! errorMsg.empty()) {
+        errorMsg = "Couldn't write table " + table + " to the SQLite file: " + errorMsg;
+        return false;
+    }
+    return true;
+}
+
+bool
+REMORA_SQLiteStorage::sharesHostDatabase()
+{
+    return false;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file REMORA_SQLiteStorage.h
+ * @brief Definition for the REMORA storage of an embedded SQLite database
+ *
+ * This file contains the definition of the storage that keeps the REMORA tables, and the
+ * model tables REMORA reads, in a local SQLite file for single user and offline use.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+
+#ifndef REMORA_SQLITESTORAGE_H
+#define REMORA_SQLITESTORAGE_H
+
+#include <QString>
+
+#include "REMORA_SqlStorage.h"
+
+/**
+ * @brief REMORA storage of an embedded SQLite database file
+ *
+ * The file is opened in write-ahead log mode so that the GUI thread may read while a
+ * worker thread writes. Each table is keyed on the fields by which REMORA looks up
+ * its rows, and the large forecast tables are stored WITHOUT ROWID so that the
+ * rows of one forecast are clustered in key order. Only the columns REMORA uses are
+ * created. The SQL is that of REMORA_SqlStorage.
+ *
+ * The file is seeded once from the host application's database with the rows REMORA
+ * reads of a model and its forecast (see seed), after which it's used without the host.
+ */
+class REMORA_SQLiteStorage : public REMORA_SqlStorage
+{
+
+private:
+    static bool createSchema(REMORA_Database& database,
+                             nmfLogger*       logger);
+    static bool seedTable(REMORA_Database&   host,
+                          REMORA_Database&   local,
+                          const std::string& table,
+                          const std::string& whereClause,
+                          std::string&       errorMsg);
+
+public:
+    /**
+     * @brief Milliseconds a connection waits for another connection's write lock
+     */
+    static const int BusyTimeout = 5000;
+
+    /**
+     * @brief Class definition for the REMORA SQLite storage
+     * @param database : an open connection to the SQLite file, which must outlive the storage
+     * @param logger : pointer to error logger API
+     */
+    REMORA_SQLiteStorage(REMORA_Database* database,
+                         nmfLogger*       logger);
+   ~REMORA_SQLiteStorage();
+
+    /**
+     * @brief Opens the SQLite file under the passed connection name on the calling thread,
+     * creating the file and any missing tables and indexes. Call once from the thread that
+     * owns the application's connections; REMORA_Database clones it into other threads.
+     * @param connectionName : the name of the connection to add
+     * @param filename : the SQLite database file
+     * @param logger : pointer to error logger API
+     * @return true if the connection is open, false otherwise
+     */
+    static bool addConnection(const QString& connectionName,
+                              const QString& filename,
+                              nmfLogger*     logger);
+
+    /**
+     * @brief Returns true if the SQLite file holds the species, the model, and the forecast
+     * @param local : an open connection to the SQLite file
+     * @param projectName : the project name
+     * @param modelName : the model name
+     * @param forecastName : the forecast name
+     * @return true if seeded, false otherwise
+     */
+    static bool isSeeded(REMORA_Database&   local,
+                         const std::string& projectName,
+                         const std::string& modelName,
+                         const std::string& forecastName);
+    /**
+     * @brief Copies the rows REMORA reads of a model and its forecast (the species, the model,
+     * its estimated parameters, MSY values, and observed harvest, and the forecast's row) from
+     * the host application's database into the SQLite file, replacing any such rows it had
+     * @param host : an open connection to the host application's database
+     * @param local : an open connection to the SQLite file
+     * @param projectName : the project name
+     * @param modelName : the model name
+     * @param forecastName : the forecast name
+     * @param errorMsg : the reason the file couldn't be seeded
+     * @return true if seeded, false otherwise
+     */
+    static bool seed(REMORA_Database&   host,
+                     REMORA_Database&   local,
+                     const std::string& projectName,
+                     const std::string& modelName,
+                     const std::string& forecastName,
+                     std::string&       errorMsg);
+
+    bool saveForecastParameters(
+            const REMORA_RunSettings& settings,
+            std::string&              errorMsg) override;
+    bool sharesHostDatabase() override;
+};
+
+#endif // REMORA_SQLITESTORAGE_H
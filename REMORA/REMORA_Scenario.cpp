@@ -0,0 +1,134 @@
+#include "REMORA_Scenario.h"
+
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+
+#include <algorithm>
+
+
+bool
+REMORA_Scenario::load(
+        const QString& filename,
+        std::string&   errorMsg)
+{
+    QString line;
+    QString controlName;
+    QString controlData;
+    QStringList parts;
+    QFile file(filename);
+
+    *this = REMORA_Scenario();
+    if (! file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        errorMsg = "Couldn't open scenario file: " + filename.toStdString();
+        return false;
+    }
+
+    QTextStream in(&file);
+    while (! in.atEnd()) {
+        line = in.readLine().trimmed();
+        if (line.isEmpty() || (line[0] == '#')) {
+            continue;
+        }
+        parts = line.split(":");
+        if (parts.size() < 2) {
+            errorMsg = "Malformed line in " + filename.toStdString() + ": " + line.toStdString();
+            return false;
+        }
+        controlName = parts[0].trimmed();
+        controlData = parts.mid(1).join(":").trimmed();
+        if (controlName == "Forecast") {
+            Name = controlData.toStdString();
+        } else if (controlName == "NumYearsPerRun") {
+            NumYearsPerRun = controlData.toInt();
+        } else if (controlName == "NumRunsPerForecast") {
+            NumRunsPerForecast = controlData.toInt();
+        } else if (controlName == "isDeterministic") {
+            IsDeterministic = (controlData == "1");
+        } else if (controlName == "SamplingMethod") {
+            SamplingMethod = controlData.toStdString();
+        } else if (controlName == "isAdaptive") {
+            IsAdaptive = (controlData == "1");
+        } else if (controlName == "ConvergenceTolerance") {
+            ConvergenceTolerance = controlData.toDouble();
+        } else if (controlName == "isSingleSpecies") {
+            IsSingleSpecies = (controlData == "1");
+        } else if (controlName == "isMultiPlot") {
+            IsMultiPlot = (controlData == "1");
+        } else if (controlName == "ForecastDataType") {
+            ForecastDataType = controlData.toStdString();
+        } else if (controlName == "isMSYLineVisible") {
+            IsMSYLineVisible = (controlData == "1");
+        } else if (controlName == "isFanChart") {
+            IsFanChart = (controlData == "1");
+        } else if (controlName == "r_Uncertainty") {
+            GrowthUncertainty = controlData.toDouble();
+        } else if (controlName == "K_Uncertainty") {
+            CarryingCapacityUncertainty = controlData.toDouble();
+        } else if (controlName == "HarvestType") {
+            HarvestType = controlData.toStdString();
+        } else if (controlName == "H_Uncertainty") {
+            HarvestUncertainty = controlData.toDouble();
+        } else if (controlName == "MaxYScaleFactor") {
+            MaxYScaleFactors.push_back(controlData.toDouble());
+        } else if (controlName == "NumScaleFactorPoints") {
+            ScaleFactorPoints.push_back({});
+        } else if (controlName == "point") {
+            parts = controlData.split(" ",Qt::SkipEmptyParts);
+            if (ScaleFactorPoints.empty() || (parts.size() != 2)) {
+                errorMsg = "Malformed scale factor point in " + filename.toStdString() + ": " + line.toStdString();
+                return false;
+            }
+            ScaleFactorPoints.back().push_back(std::make_pair(parts[0].toDouble(),parts[1].toDouble()));
+        }
+    }
+    file.close();
+
+    if ((NumYearsPerRun <= 0) || (NumRunsPerForecast <= 0)) {
+        errorMsg = "Missing number of years or runs in scenario file: " + filename.toStdString();
+        return false;
+    }
+    return true;
+}
+
+std::string
+REMORA_Scenario::harvestTable() const
+{
+    QString harvestType = QString::fromStdString(HarvestType);
+    return ("forecastharvest" + harvestType.split(" ")[0].toLower()).toStdString();
+}
+
+std::vector<std::vector<double> >
+REMORA_Scenario::scaleFactors(
+        const int& firstForecastYear,
+        const int& numSpecies) const
+{
+    double year;
+    std::vector<std::vector<double> > retv(numSpecies,std::vector<double>(NumYearsPerRun+1,1.0));
+
+    for (int species=0; species<std::min(numSpecies,int(ScaleFactorPoints.size())); ++species) {
+        std::vector<std::pair<double,double> > points = ScaleFactorPoints[species];
+        if (points.empty()) {
+            continue;
+        }
+        std::sort(points.begin(),points.end());
+        for (int yearNum=0; yearNum<=NumYearsPerRun; ++yearNum) {
+            year = firstForecastYear + yearNum;
+            if (year <= points.front().first) {
+                retv[species][yearNum] = points.front().second;
+            } else if (year >= points.back().first) {
+                retv[species][yearNum] = points.back().second;
+            } else {
+                for (unsigned i=1; i<points.size(); ++i) {
+                    if (year <= points[i].first) {
+                        const std::pair<double,double>& p0 = points[i-1];
+                        const std::pair<double,double>& p1 = points[i];
+                        retv[species][yearNum] = p0.second + (p1.second-p0.second)*(year-p0.first)/(p1.first-p0.first);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return retv;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file REMORA_Scenario.h
+ * @brief Definition for a REMORA forecast scenario file
+ *
+ * This file contains the definition of the structure that holds the contents of a
+ * REMORA forecast scenario (.scn) file as written by REMORA_UI::saveForecastScenario.
+ * It allows a scenario to be read without the REMORA GUI.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+#ifndef REMORA_SCENARIO_H
+#define REMORA_SCENARIO_H
+
+#include <QString>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The contents of a REMORA forecast scenario (.scn) file
+ */
+struct REMORA_Scenario {
+    std::string Name;
+    int    NumYearsPerRun              = 0;
+    int    NumRunsPerForecast          = 0;
+    bool   IsDeterministic             = false;
+    std::string SamplingMethod         = "Random";
+    bool   IsAdaptive                  = false;
+    double ConvergenceTolerance        = 1.0; ///< Adaptive forecast convergence tolerance as a percent
+    bool   IsSingleSpecies             = false;
+    bool   IsMultiPlot                 = false;
+    bool   IsMSYLineVisible            = false;
+    bool   IsFanChart                  = false;
+    std::string ForecastDataType;
+    std::string HarvestType;              ///< Harvest type as shown in the GUI (i.e., Catch)
+    double GrowthUncertainty           = 0.0; ///< Growth rate uncertainty as a percent
+    double CarryingCapacityUncertainty = 0.0; ///< Carrying capacity uncertainty as a percent
+    double HarvestUncertainty          = 0.0; ///< Harvest uncertainty as a percent
+    std::vector<double> MaxYScaleFactors;                                ///< Maximum scale factor plot y value, per species
+    std::vector<std::vector<std::pair<double,double> > > ScaleFactorPoints; ///< (year,scale factor) points, per species
+
+    /**
+     * @brief Reads a scenario file
+     * @param filename : the scenario file name
+     * @param errorMsg : description of any error
+     * @return true if the file was read, false otherwise
+     */
+    bool load(const QString& filename,
+              std::string&   errorMsg);
+    /**
+     * @brief Returns the name of the forecast harvest table that corresponds to the harvest type
+     * @return The table name (i.e., forecastharvestcatch)
+     */
+    std::string harvestTable() const;
+    /**
+     * @brief Interpolates the harvest scale factors for every forecast year from the scale factor points
+     * @param firstForecastYear : the first year of the forecast (i.e., the model's last observed year)
+     * @param numSpecies : number of species in the model
+     * @return Harvest scale factor per [species][year]. Species without any points are given a
+     * scale factor of 1.
+     */
+    std::vector<std::vector<double> > scaleFactors(
+            const int& firstForecastYear,
+            const int& numSpecies) const;
+};
+
+#endif // REMORA_SCENARIO_H
@@ -0,0 +1,424 @@
+#include "REMORA_SqlStorage.h"
+
+#include "nmfConstants.h"
+#include "nmfConstantsMSSPM.h"
+
+#include <QStringList>
+#include <QVariant>
+
+#include <map>
+
+static std::string
+quotedList(const std::vector<std::string>& values)
+{
+    std::string list;
+
+    for (const std::string& value : values) {
+        list += (list.empty() ? "'" : ",'") + value + "'";
+    }
+    return list;
+}
+
+REMORA_SqlStorage::REMORA_SqlStorage(
+        REMORA_Database* database,
+        nmfLogger*       logger)
+{
+    m_Database = database;
+    m_Logger   = logger;
+}
+
+REMORA_SqlStorage::~REMORA_SqlStorage()
+{
+}
+
+bool
+REMORA_SqlStorage::commit()
+{
+    return m_Database->commit();
+}
+
+REMORA_Database*
+REMORA_SqlStorage::database()
+{
+    return m_Database;
+}
+
+bool
+REMORA_SqlStorage::loadForecastBiomass(
+        const std::vector<std::string>& speciesNames,
+        REMORA_ForecastData&            data,
+        std::string&                    errorMsg)
+{
+    int year;
+    int NumSpecies = data.NumSpecies;
+    std::map<std::string,int> speciesIndex;
+    REMORA_QueryResult result;
+    std::string queryStr;
+    boost::numeric::ublas::matrix<double> Biomass(data.NumYearsPerRun+1,NumSpecies);
+
+    for (int i=0; i<NumSpecies && i<int(speciesNames.size()); ++i) {
+        speciesIndex[speciesNames[i]] = i;
+    }
+    Biomass.clear();
+
+    queryStr  = "SELECT SpeName,Year,Value FROM " +
+                 nmfConstantsMSSPM::TableForecastBiomass +
+                " WHERE ProjectName = '"       + data.ProjectName +
+                "' AND ModelName = '"          + data.ModelName +
+                "' AND ForecastName = '"       + data.ForecastName +
+                "' AND Algorithm = '"          + data.Algorithm +
+                "' AND Minimizer = '"          + data.Minimizer +
+                "' AND ObjectiveCriterion = '" + data.ObjectiveCriterion +
+                "' AND Scaling = '"            + data.Scaling +
+                "' ORDER BY SpeName,Year";
+    m_Database->setCallSite("REMORA_SqlStorage::loadForecastBiomass");
+    if (! m_Database->nmfQueryColumns(queryStr,{{"SpeName",REMORA_Column::Text},
+                                                {"Year",   REMORA_Column::Integer},
+                                                {"Value",  REMORA_Column::Real}},result)) {
+        errorMsg = "Couldn't query table " + nmfConstantsMSSPM::TableForecastBiomass + ": " + m_Database->lastError();
+        return false;
+    }
+    int NumRecords = result.NumRows;
+    if (NumRecords == 0) {
+        errorMsg = "No records found in table: " + nmfConstantsMSSPM::TableForecastBiomass;
+        m_Logger->logMsg(nmfConstants::Error,errorMsg);
+        m_Logger->logMsg(nmfConstants::Error,queryStr);
+        return false;
+    }
+    const std::vector<std::string>& SpeName = result.Text["SpeName"];
+    const std::vector<int>&         Year    = result.Integer["Year"];
+    const std::vector<double>&      Value   = result.Real["Value"];
+    for (int i=0; i<NumRecords; ++i) {
+        year = Year[i];
+        if ((year < 0) || (year > data.NumYearsPerRun) ||
+            (speciesIndex.find(SpeName[i]) == speciesIndex.end())) {
+            continue;
+        }
+        Biomass(year,speciesIndex[SpeName[i]]) = Value[i];
+    }
+    data.Biomass = {Biomass};
+    return true;
+}
+
+bool
+REMORA_SqlStorage::loadForecastBiomassMonteCarlo(
+        const std::vector<std::string>& speciesNames,
+        const int&                      speciesNum,
+        REMORA_ForecastData&            data,
+        const std::function<bool(int)>& progress,
+        std::string&                    errorMsg)
+{
+    int runNum;
+    int year;
+    int species;
+    int NumSpecies = data.NumSpecies;
+    bool isAllocated = (data.BiomassTensor.NumRuns    == data.NumRunsPerForecast) &&
+                       (data.BiomassTensor.NumSpecies == NumSpecies) &&
+                       (data.BiomassTensor.NumYears   == data.NumYearsPerRun+1);
+    std::map<std::string,int> speciesIndex;
+    std::map<std::string,int>::const_iterator speciesIt;
+    REMORA_QueryResult result;
+    std::string queryStr;
+
+    for (int i=0; i<NumSpecies && i<int(speciesNames.size()); ++i) {
+        speciesIndex[speciesNames[i]] = i;
+    }
+    if (! isAllocated) {
+        data.BiomassTensor.resize(data.NumYearsPerRun+1,NumSpecies,data.NumRunsPerForecast);
+    }
+    data.BiomassTensor.detach();
+
+    queryStr  = "SELECT RunNum,SpeName,Year,Value FROM " +
+                 nmfConstantsMSSPM::TableForecastBiomassMonteCarlo +
+                " WHERE ProjectName = '"       + data.ProjectName +
+                "' AND ModelName = '"          + data.ModelName +
+                "' AND ForecastName = '"       + data.ForecastName +
+                "' AND Algorithm = '"          + data.Algorithm +
+                "' AND Minimizer = '"          + data.Minimizer +
+                "' AND ObjectiveCriterion = '" + data.ObjectiveCriterion +
+                "' AND Scaling = '"            + data.Scaling + "'";
+    if ((speciesNum >= 0) && (speciesNum < int(speciesNames.size()))) {
+        queryStr += " AND SpeName = '" + speciesNames[speciesNum] + "'";
+    }
+    queryStr += " ORDER BY RunNum,SpeName,Year";
+    m_Database->setCallSite("REMORA_SqlStorage::loadForecastBiomassMonteCarlo");
+    if (! m_Database->nmfQueryColumns(queryStr,{{"RunNum", REMORA_Column::Integer},
+                                                {"SpeName",REMORA_Column::Text},
+                                                {"Year",   REMORA_Column::Integer},
+                                                {"Value",  REMORA_Column::Real}},result)) {
+        errorMsg = "Couldn't query table " + nmfConstantsMSSPM::TableForecastBiomassMonteCarlo + ": " + m_Database->lastError();
+        return false;
+    }
+    int NumRecords = result.NumRows;
+    if (NumRecords == 0) {
+        errorMsg = "No records found in table: " + nmfConstantsMSSPM::TableForecastBiomassMonteCarlo;
+        m_Logger->logMsg(nmfConstants::Error,errorMsg);
+        m_Logger->logMsg(nmfConstants::Error,queryStr);
+        return false;
+    }
+    const std::vector<int>&         RunNum  = result.Integer["RunNum"];
+    const std::vector<std::string>& SpeName = result.Text["SpeName"];
+    const std::vector<int>&         Year    = result.Integer["Year"];
+    const std::vector<double>&      Value   = result.Real["Value"];
+    species = -1;
+    for (int i=0; i<NumRecords; ++i) {
+        runNum = RunNum[i];
+        year   = Year[i];
+        // Rows are ordered by species within each run, so the lookup rarely changes
+        if ((i == 0) || (SpeName[i] != SpeName[i-1])) {
+            speciesIt = speciesIndex.find(SpeName[i]);
+            species   = (speciesIt == speciesIndex.end()) ? -1 : speciesIt->second;
+        }
+        if ((runNum  < 0) || (runNum >= data.NumRunsPerForecast) ||
+            (year    < 0) || (year   >  data.NumYearsPerRun)     ||
+            (species < 0)) {
+            continue;
+        }
+        data.BiomassTensor.runs(year,species)[runNum] = Value[i];
+        if ((i % 10000 == 0) && progress && ! progress(100*i/NumRecords)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+REMORA_SqlStorage::loadMSY(
+        const std::string&   table,
+        const std::string&   projectName,
+        const std::string&   modelName,
+        const std::string&   algorithm,
+        const std::string&   minimizer,
+        const std::string&   objectiveCriterion,
+        const std::string&   scaling,
+        const bool&          isAggProd,
+        std::vector<double>& values)
+{
+    REMORA_QueryResult result;
+    std::string queryStr;
+
+    queryStr   = "SELECT SpeName,Value FROM " +
+                  table +
+                 " WHERE ProjectName = '"       + projectName +
+                 "' AND ModelName = '"          + modelName +
+                 "' AND Algorithm = '"          + algorithm +
+                 "' AND Minimizer = '"          + minimizer +
+                 "' AND ObjectiveCriterion = '" + objectiveCriterion +
+                 "' AND Scaling = '"            + scaling +
+                 "' AND isAggProd = "           + std::string(isAggProd ? "1" : "0") +
+                 "  ORDER by SpeName";
+    m_Database->setCallSite("REMORA_SqlStorage::loadMSY");
+    if (! m_Database->nmfQueryColumns(queryStr,{{"SpeName",REMORA_Column::Text},
+                                                {"Value",  REMORA_Column::Real}},result)) {
+        return false;
+    }
+    if (result.NumRows == 0) {
+        m_Logger->logMsg(nmfConstants::Error, queryStr);
+        return false;
+    }
+    values = result.Real["Value"];
+    return true;
+}
+
+bool
+REMORA_SqlStorage::rollback()
+{
+    return m_Database->rollback();
+}
+
+bool
+REMORA_SqlStorage::saveForecastParameters(
+        const REMORA_RunSettings& settings,
+        std::string&              errorMsg)
+{
+    int endForecastYear = settings.EndYear + settings.NumYearsPerRun;
+
+    // Update forecast parameters in Forecasts file
+    std::string cmd =
+            "UPDATE " +
+             nmfConstantsMSSPM::TableForecasts +
+            " SET NumRuns = "      + std::to_string(settings.NumRunsPerForecast) +
+            ", RunLength = "       + std::to_string(settings.NumYearsPerRun) +
+            ", EndYear = "         + std::to_string(endForecastYear) +
+            ", IsDeterministic = " + std::to_string(settings.IsDeterministic) +
+            "  WHERE ProjectName = '" + settings.ProjectName +
+            "' AND ForecastName = '"  + settings.ForecastName + "'";
+    m_Database->setCallSite("REMORA_SqlStorage::saveForecastParameters");
+    errorMsg = m_Database->nmfUpdateDatabase(cmd);
+    if (! errorMsg.empty()) {
+        m_Logger->logMsg(nmfConstants::Error,"[Error 1] REMORA: UPDATE error: " + errorMsg);
+        m_Logger->logMsg(nmfConstants::Error,"cmd: " + cmd);
+        errorMsg = "Couldn't update forecast parameters in " + nmfConstantsMSSPM::TableForecasts + " table.";
+        return false;
+    }
+    return true;
+}
+
+bool
+REMORA_SqlStorage::saveHarvest(
+        const REMORA_RunSettings&                    settings,
+        const boost::numeric::ublas::matrix<double>& harvest,
+        std::string&                                 errorMsg)
+{
+    int NumSpecies = int(settings.SpeciesNames.size());
+    int NumDirty   = 0;
+    std::string cmd;
+    QVariantList values;
+    std::vector<std::string> dirtySpecies;
+    std::vector<std::string> fields = {"ProjectName","ModelName","ForecastName","Algorithm","Minimizer",
+                                       "ObjectiveCriterion","Scaling","SpeName","Year","Value"};
+
+    // Only the species whose scale factors changed need to be rewritten
+    for (int speciesNum=0; speciesNum<NumSpecies; ++speciesNum) {
+        if (settings.DirtySpecies[speciesNum]) {
+            dirtySpecies.push_back(settings.SpeciesNames[speciesNum]);
+        }
+    }
+    NumDirty = int(dirtySpecies.size());
+    if (NumDirty == 0) {
+        return true;
+    }
+    m_Database->setCallSite("REMORA_SqlStorage::saveHarvest");
+
+    // The dirty species' rows are replaced. If anything other than the scale factors changed,
+    // every species is dirty and all of the forecast's rows are replaced.
+    cmd = "DELETE FROM " +
+           settings.HarvestType +
+          " WHERE ProjectName = '" + settings.ProjectName +
+          "' AND ModelName = '"    + settings.ModelName +
+          "' AND ForecastName = '" + settings.ForecastName + "'";
+    if (NumDirty < NumSpecies) {
+        cmd += " AND SpeName IN (" + quotedList(dirtySpecies) + ")";
+    }
+    errorMsg = m_Database->nmfUpdateDatabase(cmd);
+    if (! errorMsg.empty()) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA::saveHarvestData: DELETE error: " + errorMsg);
+        m_Logger->logMsg(nmfConstants::Error,"cmd: " + cmd);
+        errorMsg = "Error(1) REMORA_SqlStorage::saveHarvest:  Couldn't delete all records from " +
+                    settings.HarvestType + " table.";
+        return false;
+    }
+
+    values.reserve(NumDirty*(settings.NumYearsPerRun+1)*int(fields.size()));
+    for (int speciesNum=0; speciesNum<NumSpecies; ++speciesNum) { // Species
+        if (! settings.DirtySpecies[speciesNum]) {
+            continue;
+        }
+        for (int yearNum=0; yearNum<=settings.NumYearsPerRun; ++yearNum) { // Time
+            values << QString::fromStdString(settings.ProjectName)
+                   << QString::fromStdString(settings.ModelName)
+                   << QString::fromStdString(settings.ForecastName)
+                   << QString::fromStdString(settings.Algorithm)
+                   << QString::fromStdString(settings.Minimizer)
+                   << QString::fromStdString(settings.ObjectiveCriterion)
+                   << QString::fromStdString(settings.Scaling)
+                   << QString::fromStdString(settings.SpeciesNames[speciesNum])
+                   << yearNum
+                   << harvest(yearNum,speciesNum);
+        }
+    }
+
+    errorMsg = m_Database->nmfInsertRows(settings.HarvestType,fields,values,settings.InsertChunkSize);
+    if (! errorMsg.empty()) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA::saveHarvestData: Write table error: " + errorMsg);
+        errorMsg = "Couldn't write harvest data to " + settings.HarvestType + " table.";
+        return false;
+    }
+    return true;
+}
+
+bool
+REMORA_SqlStorage::saveUncertaintyParameters(
+        const REMORA_RunSettings& settings,
+        std::string&              errorMsg)
+{
+    std::string cmd;
+    std::string ForecastName = settings.ForecastName;
+    std::vector<std::string> fields = {"ForecastName","Algorithm","Minimizer","ObjectiveCriterion","Scaling"};
+    std::string queryStr = "SELECT ForecastName,Algorithm,Minimizer,ObjectiveCriterion,Scaling FROM " +
+                            nmfConstantsMSSPM::TableForecasts +
+                           " WHERE ProjectName = '" + settings.ProjectName +
+                           "' AND ForecastName = '" + ForecastName  + "'";
+    m_Database->setCallSite("REMORA_SqlStorage::saveUncertaintyParameters");
+    std::map<std::string, std::vector<std::string> > dataMap = m_Database->nmfQueryDatabase(queryStr, fields);
+
+    int NumRecords = dataMap["ForecastName"].size();
+    if (NumRecords == 0) {
+        errorMsg = "REMORA::saveUncertaintyParameters: No records found in " + nmfConstantsMSSPM::TableForecasts;
+        m_Logger->logMsg(nmfConstants::Error,errorMsg);
+        m_Logger->logMsg(nmfConstants::Error,queryStr);
+        return false;
+    }
+
+    std::string Algorithm          = dataMap["Algorithm"][0];
+    std::string Minimizer          = dataMap["Minimizer"][0];
+    std::string ObjectiveCriterion = dataMap["ObjectiveCriterion"][0];
+    std::string Scaling            = dataMap["Scaling"][0];
+    double      InitBiomass        = 0.0; // May need to supply a dial widget for this later
+    double      GrowthRateShape    = 0.0;
+    double      Catchability       = 0.0;
+    QVariantList values;
+
+    cmd = "DELETE FROM " +
+           nmfConstantsMSSPM::TableForecastUncertainty +
+          " WHERE ProjectName = '" + settings.ProjectName +
+          "' AND ModelName = '"    + settings.ModelName +
+          "' AND ForecastName = '" + ForecastName + "'";
+    errorMsg = m_Database->nmfUpdateDatabase(cmd);
+    if (! errorMsg.empty()) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA::saveUncertaintyParameters: DELETE error: " + errorMsg);
+        m_Logger->logMsg(nmfConstants::Error,"cmd: " + cmd);
+        errorMsg = "Error(1) in REMORA_SqlStorage::saveUncertaintyParameters:  Couldn't delete all records from ForecastUncertainty table.";
+        return false;
+    }
+
+    QStringList ParameterNames = {"InitBiomass","GrowthRate","GrowthRateShape","CarryingCapacity","Catchability","Harvest",
+                                  "CompetitionAlpha","CompetitionBetaSpecies","CompetitionBetaGuilds","CompetitionBetaGuildsGuilds",
+                                  "PredationRho","PredationHandling","PredationExponent","SurveyQ",
+                                  "GrowthRateCovCoeff","CarryingCapacityCovCoeff","CatchabilityCovCoeff","SurveyQCovCoeff"};
+    fields = {"SpeName","ProjectName","ModelName","ForecastName",
+              "Algorithm","Minimizer","ObjectiveCriterion","Scaling"};
+    for (const QString& ParameterName : ParameterNames) {
+        fields.push_back(ParameterName.toStdString());
+    }
+    for (const std::string& SpeName : settings.SpeciesNames) {
+        values << QString::fromStdString(SpeName)
+               << QString::fromStdString(settings.ProjectName)
+               << QString::fromStdString(settings.ModelName)
+               << QString::fromStdString(ForecastName)
+               << QString::fromStdString(Algorithm)
+               << QString::fromStdString(Minimizer)
+               << QString::fromStdString(ObjectiveCriterion)
+               << QString::fromStdString(Scaling)
+               << InitBiomass
+               << settings.GrowthUncertainty
+               << GrowthRateShape   // 0 for now
+               << settings.CarryingCapacityUncertainty
+               << Catchability      // 0 for now
+               << settings.HarvestUncertainty;
+        // N.B. Next line will need to be modified once more parameters are used in the ForecastUncertainty calculations
+        for (int i=0;i<ParameterNames.size()-6;++i) { //-6 because we are supplying data for: InitBiomass, GrowthRate, GrowthRateShape, CarryingCapacity, Catchability, and Harvest
+            values << 0.0;
+        }
+    }
+
+    errorMsg = m_Database->nmfInsertRows(nmfConstantsMSSPM::TableForecastUncertainty,fields,values,settings.InsertChunkSize);
+    if (! errorMsg.empty()) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA::saveUncertaintyParameters: Write table error: " + errorMsg);
+        errorMsg = "Error(2) in REMORA_SqlStorage::saveUncertaintyParameters.  Check that all cells are populated.";
+        return false;
+    }
+    return true;
+}
+
+bool
+REMORA_SqlStorage::sharesHostDatabase()
+{
+    return true;
+}
+
+bool
+REMORA_SqlStorage::transaction()
+{
+    return m_Database->transaction();
+}
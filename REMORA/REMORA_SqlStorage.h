@@ -0,0 +1,97 @@
+/**
+ * @file REMORA_SqlStorage.h
+ * @brief Definition for the REMORA storage of the host application's database
+ *
+ * This file contains the definition of the storage that reads and writes the REMORA
+ * tables of the database shared with the host application.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+
+#ifndef REMORA_SQLSTORAGE_H
+#define REMORA_SQLSTORAGE_H
+
+#include "REMORA_Storage.h"
+
+/**
+ * @brief REMORA storage of the SQL tables of the host application's database
+ *
+ * A forecast's rows are replaced by deleting and inserting them within the
+ * transaction of the caller, so the tables need no unique keys.
+ */
+class REMORA_SqlStorage : public REMORA_Storage
+{
+
+protected:
+    REMORA_Database* m_Database;
+    nmfLogger*       m_Logger;
+
+public:
+    /**
+     * @brief Class definition for the REMORA SQL storage
+     * @param database : the open connection, which must outlive the storage
+     * @param logger : pointer to error logger API
+     */
+    REMORA_SqlStorage(REMORA_Database* database,
+                      nmfLogger*       logger);
+    virtual ~REMORA_SqlStorage();
+
+    bool commit() override;
+    REMORA_Database* database() override;
+    bool loadForecastBiomass(
+            const std::vector<std::string>& speciesNames,
+            REMORA_ForecastData&            data,
+            std::string&                    errorMsg) override;
+    bool loadForecastBiomassMonteCarlo(
+            const std::vector<std::string>& speciesNames,
+            const int&                      speciesNum,
+            REMORA_ForecastData&            data,
+            const std::function<bool(int)>& progress,
+            std::string&                    errorMsg) override;
+    bool loadMSY(
+            const std::string&   table,
+            const std::string&   projectName,
+            const std::string&   modelName,
+            const std::string&   algorithm,
+            const std::string&   minimizer,
+            const std::string&   objectiveCriterion,
+            const std::string&   scaling,
+            const bool&          isAggProd,
+            std::vector<double>& values) override;
+    bool rollback() override;
+    bool saveForecastParameters(
+            const REMORA_RunSettings& settings,
+            std::string&              errorMsg) override;
+    bool saveHarvest(
+            const REMORA_RunSettings&                    settings,
+            const boost::numeric::ublas::matrix<double>& harvest,
+            std::string&                                 errorMsg) override;
+    bool saveUncertaintyParameters(
+            const REMORA_RunSettings& settings,
+            std::string&              errorMsg) override;
+    bool sharesHostDatabase() override;
+    bool transaction() override;
+};
+
+#endif // REMORA_SQLSTORAGE_H
@@ -0,0 +1,58 @@
+#include "REMORA_Statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+
+namespace REMORA_Statistics {
+
+double
+mean(const std::vector<double>& values)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    return std::accumulate(values.begin(),values.end(),0.0) / double(values.size());
+}
+
+static double
+sortedQuantile(const std::vector<double>& sortedValues,
+               const double&              probability)
+{
+    double p    = std::min(1.0,std::max(0.0,probability));
+    double rank = p * double(sortedValues.size()-1);
+    int    lo   = int(std::floor(rank));
+    int    hi   = std::min(lo+1,int(sortedValues.size())-1);
+
+    return sortedValues[lo] + (rank-lo)*(sortedValues[hi]-sortedValues[lo]);
+}
+
+double
+quantile(std::vector<double>& values,
+         const double&        probability)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(),values.end());
+    return sortedQuantile(values,probability);
+}
+
+std::vector<double>
+quantiles(std::vector<double>&       values,
+          const std::vector<double>& probabilities)
+{
+    std::vector<double> retv(probabilities.size(),0.0);
+
+    if (values.empty()) {
+        return retv;
+    }
+    std::sort(values.begin(),values.end());
+    for (unsigned i=0; i<probabilities.size(); ++i) {
+        retv[i] = sortedQuantile(values,probabilities[i]);
+    }
+    return retv;
+}
+
+}
@@ -0,0 +1,64 @@
+/**
+ * @file REMORA_Statistics.h
+ * @brief Summary statistics of REMORA forecast runs
+ *
+ * This file contains the functions that REMORA uses to summarize the distribution of
+ * the Monte Carlo forecast runs.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+#ifndef REMORA_STATISTICS_H
+#define REMORA_STATISTICS_H
+
+#include <vector>
+
+namespace REMORA_Statistics {
+
+/**
+ * @brief Returns the arithmetic mean of the passed values
+ * @param values : the values
+ * @return The mean (0 if there are no values)
+ */
+double mean(const std::vector<double>& values);
+/**
+ * @brief Returns a quantile of the passed values, linearly interpolating between the closest ranks
+ * @param values : the values (sorted in place)
+ * @param probability : the quantile probability (i.e., 0.05 for the 5th percentile)
+ * @return The quantile (0 if there are no values)
+ */
+double quantile(std::vector<double>& values,
+                const double&        probability);
+/**
+ * @brief Returns several quantiles of the passed values, sorting them only once
+ * @param values : the values (sorted in place)
+ * @param probabilities : the quantile probabilities
+ * @return One quantile per probability
+ */
+std::vector<double> quantiles(
+        std::vector<double>&       values,
+        const std::vector<double>& probabilities);
+
+}
+
+#endif // REMORA_STATISTICS_H
@@ -0,0 +1,16 @@
+#include "REMORA_Storage.h"
+
+#include "REMORA_SQLiteStorage.h"
+#include "REMORA_SqlStorage.h"
+
+
+std::unique_ptr<REMORA_Storage>
+REMORA_Storage::create(
+        REMORA_Database* database,
+        nmfLogger*       logger)
+{
+    if (database->driverName() == "QSQLITE") {
+        return std::unique_ptr<REMORA_Storage>(new REMORA_SQLiteStorage(database,logger));
+    }
+    return std::unique_ptr<REMORA_Storage>(new REMORA_SqlStorage(database,logger));
+}
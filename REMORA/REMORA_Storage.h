@@ -0,0 +1,179 @@
+/**
+ * @file REMORA_Storage.h
+ * @brief Definition for the REMORA storage interface
+ *
+ * This file contains the definition of the interface through which REMORA reads and
+ * writes its forecast, harvest, uncertainty, and MSY data, so that the data may be kept
+ * in the host application's shared database or in an embedded database file.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+
+#ifndef REMORA_STORAGE_H
+#define REMORA_STORAGE_H
+
+#include "nmfLogger.h"
+#include "REMORA_Database.h"
+#include "REMORA_ForecastData.h"
+
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Interface to the tables REMORA reads and writes
+ *
+ * The forecast parameters, uncertainty parameters, and harvest are written within one
+ * transaction by REMORA_RunWorker; the forecast biomass and MSY values are read by the
+ * worker and by REMORA_UI. The model tables read by REMORA_ModelLoader are read through
+ * database(). Use create() to construct the implementation suited to a connection.
+ */
+class REMORA_Storage
+{
+
+public:
+    virtual ~REMORA_Storage() {}
+
+    /**
+     * @brief Constructs the storage implementation for the driver of the passed connection:
+     * REMORA_SQLiteStorage for an embedded SQLite file, else REMORA_SqlStorage
+     * @param database : the open connection, which must outlive the storage
+     * @param logger : pointer to error logger API
+     * @return The storage
+     */
+    static std::unique_ptr<REMORA_Storage> create(
+            REMORA_Database* database,
+            nmfLogger*       logger);
+
+    /**
+     * @brief Commits the transaction started with transaction()
+     * @return true if the transaction was committed
+     */
+    virtual bool commit() = 0;
+    /**
+     * @brief Returns the connection holding the storage's tables
+     * @return The database connection
+     */
+    virtual REMORA_Database* database() = 0;
+    /**
+     * @brief Reads the forecast biomass without uncertainty into data.Biomass
+     * @param speciesNames : the species of the forecast, in column order
+     * @param data : the forecast data, whose identifiers, number of species, and years per run must be set
+     * @param errorMsg : the reason for any failure
+     * @return true if found, false otherwise
+     */
+    virtual bool loadForecastBiomass(
+            const std::vector<std::string>& speciesNames,
+            REMORA_ForecastData&            data,
+            std::string&                    errorMsg) = 0;
+    /**
+     * @brief Reads the Monte Carlo biomass into data.BiomassTensor, which is allocated
+     * if it doesn't already hold every run
+     * @param speciesNames : the species of the forecast, in column order
+     * @param speciesNum : the only species to read, or -1 for every species
+     * @param data : the forecast data, whose identifiers and dimensions must be set
+     * @param progress : called periodically with the percentage read (0-100); returns false to cancel
+     * @param errorMsg : the reason for any failure
+     * @return true if found, false if not found or cancelled
+     */
+    virtual bool loadForecastBiomassMonteCarlo(
+            const std::vector<std::string>& speciesNames,
+            const int&                      speciesNum,
+            REMORA_ForecastData&            data,
+            const std::function<bool(int)>& progress,
+            std::string&                    errorMsg) = 0;
+    /**
+     * @brief Reads the MSY reference value of each species, in species name order
+     * @param table : the MSY table (biomass or fishing mortality)
+     * @param projectName : the project name
+     * @param modelName : the model name
+     * @param algorithm : the estimation algorithm
+     * @param minimizer : the estimation minimizer
+     * @param objectiveCriterion : the estimation objective criterion
+     * @param scaling : the estimation scaling
+     * @param isAggProd : true for the aggregate production values
+     * @param values : the MSY value of each species
+     * @return true if found, false otherwise
+     */
+    virtual bool loadMSY(
+            const std::string&   table,
+            const std::string&   projectName,
+            const std::string&   modelName,
+            const std::string&   algorithm,
+            const std::string&   minimizer,
+            const std::string&   objectiveCriterion,
+            const std::string&   scaling,
+            const bool&          isAggProd,
+            std::vector<double>& values) = 0;
+    /**
+     * @brief Rolls back the transaction started with transaction()
+     * @return true if the transaction was rolled back
+     */
+    virtual bool rollback() = 0;
+    /**
+     * @brief Writes the run length, number of runs, and end year of the forecast
+     * @param settings : the run settings
+     * @param errorMsg : the reason for any failure
+     * @return true if written, false otherwise
+     */
+    virtual bool saveForecastParameters(
+            const REMORA_RunSettings& settings,
+            std::string&              errorMsg) = 0;
+    /**
+     * @brief Writes the forecast harvest of each species flagged in settings.DirtySpecies
+     * @param settings : the run settings
+     * @param harvest : the (year x species) forecast harvest
+     * @param errorMsg : the reason for any failure
+     * @return true if written, false otherwise
+     */
+    virtual bool saveHarvest(
+            const REMORA_RunSettings&                    settings,
+            const boost::numeric::ublas::matrix<double>& harvest,
+            std::string&                                 errorMsg) = 0;
+    /**
+     * @brief Writes the uncertainty parameters of each species
+     * @param settings : the run settings
+     * @param errorMsg : the reason for any failure
+     * @return true if written, false otherwise
+     */
+    virtual bool saveUncertaintyParameters(
+            const REMORA_RunSettings& settings,
+            std::string&              errorMsg) = 0;
+    /**
+     * @brief Returns true if the storage is the host application's database, in which
+     * case forecasts the engine can't simulate may be simulated by the host application
+     * @return true if shared with the host application, false otherwise
+     */
+    virtual bool sharesHostDatabase() = 0;
+    /**
+     * @brief Starts a transaction
+     * @return true if the transaction was started
+     */
+    virtual bool transaction() = 0;
+};
+
+#endif // REMORA_STORAGE_H
@@ -0,0 +1,164 @@
+#include "REMORA_Sweep.h"
+#include "REMORA_Statistics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+
+REMORA_SweepEngine::REMORA_SweepEngine(int numThreads)
+{
+    if (numThreads <= 0) {
+        numThreads = int(std::thread::hardware_concurrency());
+    }
+    m_NumThreads = std::max(1,numThreads);
+}
+
+REMORA_SweepEngine::~REMORA_SweepEngine()
+{
+}
+
+void
+REMORA_SweepEngine::applyParameter(
+        const int&              sweepParameter,
+        const double&           value,
+        REMORA_RunSettings&     settings,
+        REMORA_ModelParameters& parameters)
+{
+    switch (sweepParameter) {
+        case REMORA_SweepSettings::GrowthUncertainty:
+            settings.GrowthUncertainty = value/100.0;
+            break;
+        case REMORA_SweepSettings::CarryingCapacityUncertainty:
+            settings.CarryingCapacityUncertainty = value/100.0;
+            break;
+        case REMORA_SweepSettings::HarvestUncertainty:
+            settings.HarvestUncertainty = value/100.0;
+            break;
+        case REMORA_SweepSettings::HarvestMultiplier:
+            parameters.Harvest *= value;
+            break;
+    }
+}
+
+bool
+REMORA_SweepEngine::isMetricAvailable(
+        const int&                    metric,
+        const REMORA_ModelParameters& parameters,
+        const int&                    species)
+{
+    // K is only loaded for the forms that use it, and is 0 otherwise
+    if (metric == REMORA_SweepSettings::ProbabilityBelowBMSY) {
+        return (parameters.CarryingCapacity[species] > 0);
+    }
+    return true;
+}
+
+void
+REMORA_SweepEngine::metricValues(
+        const REMORA_ModelParameters& parameters,
+        const REMORA_ForecastData&    data,
+        const int&                    species,
+        std::vector<double>&          values)
+{
+    int NumBelow = 0;
+    double BMSY  = parameters.CarryingCapacity[species]/2.0;
+    std::vector<double> endYearBiomass;
+
+    const double* runs = data.BiomassTensor.runs(data.NumYearsPerRun,species);
+    endYearBiomass.assign(runs,runs+data.BiomassTensor.NumRuns);
+    for (const double& biomass : endYearBiomass) {
+        NumBelow += (biomass < BMSY) ? 1 : 0;
+    }
+    values.assign(REMORA_SweepSettings::NumMetrics,0.0);
+    values[REMORA_SweepSettings::EndYearMeanBiomass]   = REMORA_Statistics::mean(endYearBiomass);
+    values[REMORA_SweepSettings::EndYearMedianBiomass] = REMORA_Statistics::quantile(endYearBiomass,0.5);
+    if (! endYearBiomass.empty() && (BMSY > 0)) {
+        values[REMORA_SweepSettings::ProbabilityBelowBMSY] = double(NumBelow)/endYearBiomass.size();
+    }
+}
+
+bool
+REMORA_SweepEngine::run(
+        const REMORA_ModelParameters&   parameters,
+        const REMORA_RunSettings&       settings,
+        const REMORA_SweepSettings&     sweep,
+        const uint64_t&                 baseSeed,
+        REMORA_SweepResult&             result,
+        const std::function<bool(int)>& progress)
+{
+    int NumSpecies = int(parameters.InitBiomass.size());
+    int NumPoints  = sweep.XNumSteps*sweep.YNumSteps;
+    int NumThreads = std::min(m_NumThreads,std::max(1,NumPoints));
+    std::atomic<int>  nextPoint(0);
+    std::atomic<int>  pointsCompleted(0);
+    std::atomic<bool> cancelled(false);
+    std::vector<std::thread> threads;
+
+    result.Sweep        = sweep;
+    result.SpeciesNames = settings.SpeciesNames;
+    result.XValues.resize(sweep.XNumSteps);
+    result.YValues.resize(sweep.YNumSteps);
+    for (int x=0; x<sweep.XNumSteps; ++x) {
+        result.XValues[x] = REMORA_SweepSettings::axisValue(sweep.XMin,sweep.XMax,sweep.XNumSteps,x);
+    }
+    for (int y=0; y<sweep.YNumSteps; ++y) {
+        result.YValues[y] = REMORA_SweepSettings::axisValue(sweep.YMin,sweep.YMax,sweep.YNumSteps,y);
+    }
+    result.Values.assign(REMORA_SweepSettings::NumMetrics,
+                         std::vector<boost::numeric::ublas::matrix<double> >(NumSpecies,
+                             boost::numeric::ublas::zero_matrix<double>(sweep.YNumSteps,sweep.XNumSteps)));
+    result.IsAvailable.assign(REMORA_SweepSettings::NumMetrics,std::vector<bool>(NumSpecies,true));
+    for (int metric=0; metric<REMORA_SweepSettings::NumMetrics; ++metric) {
+        for (int species=0; species<NumSpecies; ++species) {
+            result.IsAvailable[metric][species] = isMetricAvailable(metric,parameters,species);
+        }
+    }
+
+    // The grid points, rather than the runs of each point, are spread over the threads
+    auto simulatePoints = [&](bool reportProgress) {
+        int pointNum;
+        int x;
+        int y;
+        std::vector<double> values;
+        REMORA_ForecastEngine engine(1);
+        while (! cancelled) {
+            pointNum = nextPoint++;
+            if (pointNum >= NumPoints) {
+                break;
+            }
+            x = pointNum % sweep.XNumSteps;
+            y = pointNum / sweep.XNumSteps;
+            REMORA_RunSettings     pointSettings   = settings;
+            REMORA_ModelParameters pointParameters = parameters;
+            REMORA_ForecastData    pointData;
+            applyParameter(sweep.XParameter,result.XValues[x],pointSettings,pointParameters);
+            applyParameter(sweep.YParameter,result.YValues[y],pointSettings,pointParameters);
+            if (! engine.run(pointParameters,pointSettings,baseSeed,std::vector<bool>(NumSpecies,true),pointData,
+                             [&](int) { return ! cancelled.load(); })) {
+                cancelled = true;
+                break;
+            }
+            for (int species=0; species<NumSpecies; ++species) {
+                metricValues(pointParameters,pointData,species,values);
+                for (int metric=0; metric<REMORA_SweepSettings::NumMetrics; ++metric) {
+                    result.Values[metric][species](y,x) = values[metric];
+                }
+            }
+            ++pointsCompleted;
+            if (reportProgress && ! progress(pointsCompleted)) {
+                cancelled = true;
+            }
+        }
+    };
+
+    for (int i=1; i<NumThreads; ++i) {
+        threads.emplace_back(simulatePoints,false);
+    }
+    simulatePoints(true);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return ! cancelled && progress(pointsCompleted);
+}
@@ -0,0 +1,197 @@
+/**
+ * @file REMORA_Sweep.h
+ * @brief Definition for the REMORA uncertainty parameter sweep
+ *
+ * This file contains the definition of the sweep that evaluates a forecast over
+ * a grid of two of the uncertainty dials or of the harvest scale, so that the
+ * sensitivity of the forecast outcome may be shown as a response surface.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+#ifndef REMORA_SWEEP_H
+#define REMORA_SWEEP_H
+
+#include "REMORA_ForecastData.h"
+#include "REMORA_ForecastEngine.h"
+
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The grid of an uncertainty parameter sweep
+ */
+struct REMORA_SweepSettings {
+    /**
+     * @brief The quantities that may be varied along an axis of the sweep
+     */
+    enum Parameter {
+        GrowthUncertainty = 0,       ///< r uncertainty (%)
+        CarryingCapacityUncertainty, ///< K uncertainty (%)
+        HarvestUncertainty,          ///< H uncertainty (%)
+        HarvestMultiplier,           ///< Multiplier applied to the forecast harvest of every species and year
+        NumParameters
+    };
+    /**
+     * @brief The forecast outcomes that may be shown as the surface height
+     */
+    enum Metric {
+        EndYearMedianBiomass = 0,    ///< Median biomass of the runs in the last forecast year
+        EndYearMeanBiomass,          ///< Mean biomass of the runs in the last forecast year
+        ProbabilityBelowBMSY,        ///< Fraction of the runs whose last forecast year biomass is below K/2
+        NumMetrics
+    };
+
+    int    XParameter = GrowthUncertainty;
+    double XMin       = 0.0;
+    double XMax       = 50.0;
+    int    XNumSteps  = 11;
+    int    YParameter = HarvestMultiplier;
+    double YMin       = 0.5;
+    double YMax       = 1.5;
+    int    YNumSteps  = 11;
+
+    /**
+     * @brief Returns the axis label of a sweep parameter
+     * @param parameter : the sweep parameter
+     * @return The label
+     */
+    static std::string parameterName(const int& parameter) {
+        switch (parameter) {
+            case GrowthUncertainty:           return "r Uncertainty (%)";
+            case CarryingCapacityUncertainty: return "K Uncertainty (%)";
+            case HarvestUncertainty:          return "H Uncertainty (%)";
+            case HarvestMultiplier:           return "Harvest Multiplier";
+            default:                          return "";
+        }
+    }
+    /**
+     * @brief Returns the axis label of a sweep metric
+     * @param metric : the sweep metric
+     * @return The label
+     */
+    static std::string metricName(const int& metric) {
+        switch (metric) {
+            case EndYearMedianBiomass: return "End Year Median Biomass";
+            case EndYearMeanBiomass:   return "End Year Mean Biomass";
+            case ProbabilityBelowBMSY: return "Probability Below BMSY";
+            default:                   return "";
+        }
+    }
+    /**
+     * @brief Returns the value of an axis at a grid step
+     * @param min : the axis minimum
+     * @param max : the axis maximum
+     * @param numSteps : the number of grid steps along the axis
+     * @param step : the grid step
+     * @return The axis value
+     */
+    static double axisValue(const double& min, const double& max, const int& numSteps, const int& step) {
+        return (numSteps > 1) ? min + (max-min)*step/(numSteps-1) : min;
+    }
+};
+
+/**
+ * @brief The outcome of an uncertainty parameter sweep
+ */
+struct REMORA_SweepResult {
+    REMORA_SweepSettings     Sweep;
+    std::vector<std::string> SpeciesNames;
+    std::vector<double>      XValues;
+    std::vector<double>      YValues;
+    std::vector<std::vector<boost::numeric::ublas::matrix<double> > > Values; ///< One (y step x x step) matrix per [metric][species]
+    std::vector<std::vector<bool> > IsAvailable; ///< Per [metric][species], false if the model's forms don't define the metric
+
+    /**
+     * @brief Returns true if the result contains a complete sweep
+     */
+    bool isValid() const {
+        return ! SpeciesNames.empty() &&
+               (int(Values.size()) == REMORA_SweepSettings::NumMetrics) &&
+               (Values[0].size() == SpeciesNames.size()) &&
+               (IsAvailable.size() == Values.size());
+    }
+};
+
+Q_DECLARE_METATYPE(REMORA_SweepSettings)
+Q_DECLARE_METATYPE(REMORA_SweepResult)
+
+/**
+ * @brief Evaluates a forecast over a grid of uncertainty or harvest values in parallel
+ *
+ * Every grid point is simulated with the same base seed, so that the differences
+ * between neighboring points are due to the swept values alone and not to sampling noise.
+ */
+class REMORA_SweepEngine
+{
+
+private:
+    int m_NumThreads;
+
+    static void applyParameter(
+            const int&                sweepParameter,
+            const double&             value,
+            REMORA_RunSettings&       settings,
+            REMORA_ModelParameters&   parameters);
+    static bool isMetricAvailable(
+            const int&                    metric,
+            const REMORA_ModelParameters& parameters,
+            const int&                    species);
+    static void metricValues(
+            const REMORA_ModelParameters& parameters,
+            const REMORA_ForecastData&    data,
+            const int&                    species,
+            std::vector<double>&          values);
+
+public:
+    /**
+     * @brief Class definition for the REMORA sweep engine
+     * @param numThreads : number of threads to use (0 signifies use all available cores)
+     */
+    REMORA_SweepEngine(int numThreads = 0);
+   ~REMORA_SweepEngine();
+
+    /**
+     * @brief Simulates the forecast at every point of the sweep grid
+     * @param parameters : the estimated model parameters and forecast harvest
+     * @param settings : the forecast settings, of which the swept values are replaced at each grid point
+     * @param sweep : the sweep grid
+     * @param baseSeed : the base seed shared by all of the grid points
+     * @param result : every metric per species and grid point
+     * @param progress : function called periodically with the number of grid points completed;
+     * returning false cancels the sweep
+     * @return true if all grid points were simulated, false if cancelled
+     */
+    bool run(const REMORA_ModelParameters&   parameters,
+             const REMORA_RunSettings&       settings,
+             const REMORA_SweepSettings&     sweep,
+             const uint64_t&                 baseSeed,
+             REMORA_SweepResult&             result,
+             const std::function<bool(int)>& progress);
+};
+
+#endif // REMORA_SWEEP_H
@@ -0,0 +1,304 @@
+#include "REMORA_SweepDialog.h"
+
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLinearGradient>
+#include <QVBoxLayout>
+#include <QtDataVisualization/Q3DTheme>
+#include <QtDataVisualization/QValue3DAxis>
+
+#include <algorithm>
+
+using namespace QtDataVisualization;
+
+
+REMORA_SweepDialog::REMORA_SweepDialog(
+        QWidget*           parent,
+        const QStringList& speciesList) : QDialog(parent)
+{
+    QVBoxLayout* mainLayt     = new QVBoxLayout();
+    QHBoxLayout* axesLayt     = new QHBoxLayout();
+    QHBoxLayout* buttonLayt   = new QHBoxLayout();
+    QFormLayout* xLayt        = new QFormLayout();
+    QFormLayout* yLayt        = new QFormLayout();
+    QFormLayout* displayLayt  = new QFormLayout();
+    QLinearGradient gradient;
+
+    m_XParameterCMB = new QComboBox();
+    m_XMinSB        = new QDoubleSpinBox();
+    m_XMaxSB        = new QDoubleSpinBox();
+    m_XNumStepsSB   = new QSpinBox();
+    m_YParameterCMB = new QComboBox();
+    m_YMinSB        = new QDoubleSpinBox();
+    m_YMaxSB        = new QDoubleSpinBox();
+    m_YNumStepsSB   = new QSpinBox();
+    m_MetricCMB     = new QComboBox();
+    m_SpeciesCMB    = new QComboBox();
+    m_RunPB         = new QPushButton("Run");
+    m_CancelPB      = new QPushButton("Cancel");
+    m_ClosePB       = new QPushButton("Close");
+    m_ProgressBar   = new QProgressBar();
+    m_StatusLB      = new QLabel();
+    m_Surface       = new Q3DSurface();
+    m_Series        = new QSurface3DSeries();
+
+    for (int parameter=0; parameter<REMORA_SweepSettings::NumParameters; ++parameter) {
+        QString name = QString::fromStdString(REMORA_SweepSettings::parameterName(parameter));
+        m_XParameterCMB->addItem(name);
+        m_YParameterCMB->addItem(name);
+    }
+    for (int metric=0; metric<REMORA_SweepSettings::NumMetrics; ++metric) {
+        m_MetricCMB->addItem(QString::fromStdString(REMORA_SweepSettings::metricName(metric)));
+    }
+    for (QDoubleSpinBox* spinBox : {m_XMinSB,m_XMaxSB,m_YMinSB,m_YMaxSB}) {
+        spinBox->setDecimals(2);
+        spinBox->setRange(0.0,100.0);
+    }
+    for (QSpinBox* spinBox : {m_XNumStepsSB,m_YNumStepsSB}) {
+        spinBox->setRange(2,51);
+        spinBox->setToolTip("Number of values between the minimum and maximum, inclusive");
+        spinBox->setStatusTip("Number of values between the minimum and maximum, inclusive");
+    }
+    REMORA_SweepSettings defaults;
+    m_XParameterCMB->setCurrentIndex(defaults.XParameter);
+    m_YParameterCMB->setCurrentIndex(defaults.YParameter);
+    m_XMinSB->setValue(defaults.XMin);
+    m_XMaxSB->setValue(defaults.XMax);
+    m_XNumStepsSB->setValue(defaults.XNumSteps);
+    m_YMinSB->setValue(defaults.YMin);
+    m_YMaxSB->setValue(defaults.YMax);
+    m_YNumStepsSB->setValue(defaults.YNumSteps);
+    m_ProgressBar->setRange(0,100);
+    m_ProgressBar->hide();
+    m_CancelPB->setEnabled(false);
+    m_RunPB->setToolTip("Run the forecast at every point of the grid using the above settings");
+    m_RunPB->setStatusTip("Run the forecast at every point of the grid using the above settings");
+
+    xLayt->addRow("X Axis:",m_XParameterCMB);
+    xLayt->addRow("Minimum:",m_XMinSB);
+    xLayt->addRow("Maximum:",m_XMaxSB);
+    xLayt->addRow("Steps:",m_XNumStepsSB);
+    yLayt->addRow("Y Axis:",m_YParameterCMB);
+    yLayt->addRow("Minimum:",m_YMinSB);
+    yLayt->addRow("Maximum:",m_YMaxSB);
+    yLayt->addRow("Steps:",m_YNumStepsSB);
+    displayLayt->addRow("Surface:",m_MetricCMB);
+    displayLayt->addRow("Species:",m_SpeciesCMB);
+    axesLayt->addLayout(xLayt);
+    axesLayt->addLayout(yLayt);
+    axesLayt->addLayout(displayLayt);
+    buttonLayt->addWidget(m_ProgressBar);
+    buttonLayt->addStretch();
+    buttonLayt->addWidget(m_RunPB);
+    buttonLayt->addWidget(m_CancelPB);
+    buttonLayt->addWidget(m_ClosePB);
+
+    // The surface's vertical axis is the metric, its horizontal axes are the swept values
+    gradient.setColorAt(0.0,Qt::darkBlue);
+    gradient.setColorAt(0.33,Qt::cyan);
+    gradient.setColorAt(0.67,Qt::yellow);
+    gradient.setColorAt(1.0,Qt::darkRed);
+    m_Series->setDrawMode(QSurface3DSeries::DrawSurfaceAndWireframe);
+    m_Series->setFlatShadingEnabled(false);
+    m_Series->setBaseGradient(gradient);
+    m_Series->setColorStyle(Q3DTheme::ColorStyleRangeGradient);
+    m_Series->setItemLabelFormat("@xTitle: @xLabel  @zTitle: @zLabel  @yTitle: @yLabel");
+    m_Surface->addSeries(m_Series);
+    m_Surface->activeTheme()->setType(Q3DTheme::ThemeQt);
+    m_Surface->axisX()->setTitleVisible(true);
+    m_Surface->axisY()->setTitleVisible(true);
+    m_Surface->axisZ()->setTitleVisible(true);
+    m_Surface->axisX()->setLabelFormat("%.2f");
+    m_Surface->axisZ()->setLabelFormat("%.2f");
+    QWidget* surfaceContainer = QWidget::createWindowContainer(m_Surface,this);
+    surfaceContainer->setMinimumSize(640,480);
+    surfaceContainer->setSizePolicy(QSizePolicy::Expanding,QSizePolicy::Expanding);
+
+    mainLayt->addLayout(axesLayt);
+    mainLayt->addWidget(surfaceContainer,1);
+    mainLayt->addWidget(m_StatusLB);
+    mainLayt->addLayout(buttonLayt);
+    setLayout(mainLayt);
+    setWindowTitle("Sensitivity Surface");
+    setSpeciesList(speciesList);
+
+    connect(m_RunPB,         SIGNAL(clicked()),
+            this,            SLOT(callback_RunPB()));
+    connect(m_CancelPB,      SIGNAL(clicked()),
+            this,            SLOT(callback_CancelPB()));
+    connect(m_ClosePB,       SIGNAL(clicked()),
+            this,            SLOT(hide()));
+    connect(m_MetricCMB,     SIGNAL(currentIndexChanged(int)),
+            this,            SLOT(callback_MetricCMB(int)));
+    connect(m_SpeciesCMB,    SIGNAL(currentIndexChanged(int)),
+            this,            SLOT(callback_SpeciesCMB(int)));
+    connect(m_XParameterCMB, SIGNAL(currentIndexChanged(int)),
+            this,            SLOT(callback_XParameterCMB(int)));
+    connect(m_YParameterCMB, SIGNAL(currentIndexChanged(int)),
+            this,            SLOT(callback_YParameterCMB(int)));
+}
+
+REMORA_SweepDialog::~REMORA_SweepDialog()
+{
+}
+
+void
+REMORA_SweepDialog::drawSurface()
+{
+    int metric  = m_MetricCMB->currentIndex();
+    int species = m_SpeciesCMB->currentIndex();
+    QSurfaceDataArray* dataArray;
+
+    if (! m_Result.isValid() || (species < 0) || (species >= int(m_Result.SpeciesNames.size()))) {
+        m_Series->dataProxy()->resetArray(new QSurfaceDataArray());
+        return;
+    }
+    // The model's forms may not define the metric, which is then left empty rather than drawn as 0
+    if (! m_Result.IsAvailable[metric][species]) {
+        m_Series->dataProxy()->resetArray(new QSurfaceDataArray());
+        m_Surface->axisY()->setTitle(QString::fromStdString(REMORA_SweepSettings::metricName(metric)) +
+                                     " (not available for the model's growth and competition forms)");
+        return;
+    }
+    const boost::numeric::ublas::matrix<double>& values = m_Result.Values[metric][species];
+
+    dataArray = new QSurfaceDataArray();
+    dataArray->reserve(int(m_Result.YValues.size()));
+    for (unsigned y=0; y<m_Result.YValues.size(); ++y) {
+        QSurfaceDataRow* dataRow = new QSurfaceDataRow(int(m_Result.XValues.size()));
+        for (unsigned x=0; x<m_Result.XValues.size(); ++x) {
+            (*dataRow)[x].setPosition(QVector3D(m_Result.XValues[x],values(y,x),m_Result.YValues[y]));
+        }
+        dataArray->append(dataRow);
+    }
+    m_Series->dataProxy()->resetArray(dataArray);
+
+    m_Surface->axisX()->setTitle(QString::fromStdString(REMORA_SweepSettings::parameterName(m_Result.Sweep.XParameter)));
+    m_Surface->axisZ()->setTitle(QString::fromStdString(REMORA_SweepSettings::parameterName(m_Result.Sweep.YParameter)));
+    m_Surface->axisY()->setTitle(QString::fromStdString(REMORA_SweepSettings::metricName(metric)));
+    m_Surface->axisY()->setLabelFormat((metric == REMORA_SweepSettings::ProbabilityBelowBMSY) ? "%.2f" : "%.4g");
+    if (metric == REMORA_SweepSettings::ProbabilityBelowBMSY) {
+        m_Surface->axisY()->setRange(0.0,1.0);
+    } else {
+        m_Surface->axisY()->setAutoAdjustRange(true);
+    }
+}
+
+void
+REMORA_SweepDialog::setDefaultRange(
+        const int&      parameter,
+        QDoubleSpinBox* minSB,
+        QDoubleSpinBox* maxSB)
+{
+    if (parameter == REMORA_SweepSettings::HarvestMultiplier) {
+        minSB->setValue(0.5);
+        maxSB->setValue(1.5);
+        minSB->setSingleStep(0.1);
+        maxSB->setSingleStep(0.1);
+    } else {
+        minSB->setValue(0.0);
+        maxSB->setValue(50.0);
+        minSB->setSingleStep(5.0);
+        maxSB->setSingleStep(5.0);
+    }
+}
+
+void
+REMORA_SweepDialog::setProgress(const int& percent)
+{
+    m_ProgressBar->setValue(percent);
+}
+
+void
+REMORA_SweepDialog::setResult(const REMORA_SweepResult& result)
+{
+    m_Result = result;
+    drawSurface();
+}
+
+void
+REMORA_SweepDialog::setRunInProgress(
+        const bool&    inProgress,
+        const QString& status)
+{
+    m_RunPB->setEnabled(! inProgress);
+    m_CancelPB->setEnabled(inProgress);
+    m_ProgressBar->setVisible(inProgress);
+    m_ProgressBar->setValue(0);
+    m_StatusLB->setText(status);
+}
+
+void
+REMORA_SweepDialog::setSpeciesList(const QStringList& speciesList)
+{
+    QStringList currentList;
+
+    for (int i=0; i<m_SpeciesCMB->count(); ++i) {
+        currentList << m_SpeciesCMB->itemText(i);
+    }
+    if ((currentList == speciesList) && m_Result.isValid()) {
+        return;
+    }
+
+    m_SpeciesCMB->blockSignals(true);
+    m_SpeciesCMB->clear();
+    m_SpeciesCMB->addItems(speciesList);
+    m_SpeciesCMB->blockSignals(false);
+    m_Result = REMORA_SweepResult();
+    drawSurface();
+}
+
+void
+REMORA_SweepDialog::callback_CancelPB()
+{
+    m_CancelPB->setEnabled(false);
+    m_StatusLB->setText("Cancelling...");
+    emit CancelSweep();
+}
+
+void
+REMORA_SweepDialog::callback_MetricCMB(int index)
+{
+    (void)index;
+    drawSurface();
+}
+
+void
+REMORA_SweepDialog::callback_RunPB()
+{
+    REMORA_SweepSettings sweep;
+
+    if (m_XParameterCMB->currentIndex() == m_YParameterCMB->currentIndex()) {
+        m_StatusLB->setText("Please select different parameters for the x and y axes.");
+        return;
+    }
+    sweep.XParameter = m_XParameterCMB->currentIndex();
+    sweep.XMin       = std::min(m_XMinSB->value(),m_XMaxSB->value());
+    sweep.XMax       = std::max(m_XMinSB->value(),m_XMaxSB->value());
+    sweep.XNumSteps  = m_XNumStepsSB->value();
+    sweep.YParameter = m_YParameterCMB->currentIndex();
+    sweep.YMin       = std::min(m_YMinSB->value(),m_YMaxSB->value());
+    sweep.YMax       = std::max(m_YMinSB->value(),m_YMaxSB->value());
+    sweep.YNumSteps  = m_YNumStepsSB->value();
+
+    emit RunSweep(sweep);
+}
+
+void
+REMORA_SweepDialog::callback_SpeciesCMB(int index)
+{
+    (void)index;
+    drawSurface();
+}
+
+void
+REMORA_SweepDialog::callback_XParameterCMB(int index)
+{
+    setDefaultRange(index,m_XMinSB,m_XMaxSB);
+}
+
+void
+REMORA_SweepDialog::callback_YParameterCMB(int index)
+{
+    setDefaultRange(index,m_YMinSB,m_YMaxSB);
+}
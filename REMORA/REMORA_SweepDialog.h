@@ -0,0 +1,157 @@
+/**
+ * @file REMORA_SweepDialog.h
+ * @brief Definition for the REMORA sensitivity surface dialog
+ *
+ * This file contains the definition of the dialog in which the user defines a
+ * sweep over two of the uncertainty dials or the harvest scale and views the
+ * resulting forecast outcome as a 3d response surface.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+#ifndef REMORA_SWEEPDIALOG_H
+#define REMORA_SWEEPDIALOG_H
+
+#include <QComboBox>
+#include <QDialog>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QSpinBox>
+
+#include <QtDataVisualization/Q3DSurface>
+#include <QtDataVisualization/QSurface3DSeries>
+
+#include "REMORA_Sweep.h"
+
+/**
+ * @brief Dialog that defines an uncertainty parameter sweep and draws its response surface
+ */
+class REMORA_SweepDialog : public QDialog
+{
+    Q_OBJECT
+
+private:
+    QComboBox*      m_XParameterCMB;
+    QDoubleSpinBox* m_XMinSB;
+    QDoubleSpinBox* m_XMaxSB;
+    QSpinBox*       m_XNumStepsSB;
+    QComboBox*      m_YParameterCMB;
+    QDoubleSpinBox* m_YMinSB;
+    QDoubleSpinBox* m_YMaxSB;
+    QSpinBox*       m_YNumStepsSB;
+    QComboBox*      m_MetricCMB;
+    QComboBox*      m_SpeciesCMB;
+    QPushButton*    m_RunPB;
+    QPushButton*    m_CancelPB;
+    QPushButton*    m_ClosePB;
+    QProgressBar*   m_ProgressBar;
+    QLabel*         m_StatusLB;
+    QtDataVisualization::Q3DSurface*       m_Surface;
+    QtDataVisualization::QSurface3DSeries* m_Series;
+    REMORA_SweepResult m_Result;
+
+    void drawSurface();
+    void setDefaultRange(
+            const int&      parameter,
+            QDoubleSpinBox* minSB,
+            QDoubleSpinBox* maxSB);
+
+signals:
+    /**
+     * @brief Signal emitted when the user wants to cancel the sweep in progress
+     */
+    void CancelSweep();
+    /**
+     * @brief Signal emitted when the user wants to run a sweep
+     * @param sweep : the sweep grid
+     */
+    void RunSweep(REMORA_SweepSettings sweep);
+
+public:
+    /**
+     * @brief Class definition for the REMORA sweep dialog
+     * @param parent : parent widget of the dialog
+     * @param speciesList : list of species
+     */
+    REMORA_SweepDialog(QWidget*           parent,
+                       const QStringList& speciesList);
+   ~REMORA_SweepDialog();
+
+    /**
+     * @brief Updates the progress bar of the sweep in progress
+     * @param percent : percentage complete (0-100) of the sweep
+     */
+    void setProgress(const int& percent);
+    /**
+     * @brief Stores the result of a completed sweep and draws its surface
+     * @param result : the sweep result
+     */
+    void setResult(const REMORA_SweepResult& result);
+    /**
+     * @brief Toggles the dialog's controls between the running and idle states
+     * @param inProgress : true if a sweep is in progress, false otherwise
+     * @param status : message to show below the controls
+     */
+    void setRunInProgress(const bool&    inProgress,
+                          const QString& status);
+    /**
+     * @brief Replaces the list of species whose surface may be shown. The last sweep
+     * result is discarded if the list changed.
+     * @param speciesList : list of species
+     */
+    void setSpeciesList(const QStringList& speciesList);
+
+public Q_SLOTS:
+    /**
+     * @brief Callback invoked when the user presses the Cancel button
+     */
+    void callback_CancelPB();
+    /**
+     * @brief Callback invoked when the user selects a different metric
+     * @param index : index of the selected metric
+     */
+    void callback_MetricCMB(int index);
+    /**
+     * @brief Callback invoked when the user presses the Run button
+     */
+    void callback_RunPB();
+    /**
+     * @brief Callback invoked when the user selects a different species
+     * @param index : index of the selected species
+     */
+    void callback_SpeciesCMB(int index);
+    /**
+     * @brief Callback invoked when the user selects a different x axis parameter
+     * @param index : index of the selected parameter
+     */
+    void callback_XParameterCMB(int index);
+    /**
+     * @brief Callback invoked when the user selects a different y axis parameter
+     * @param index : index of the selected parameter
+     */
+    void callback_YParameterCMB(int index);
+};
+
+#endif // REMORA_SWEEPDIALOG_H
@@ -9,7 +9,8 @@ REMORA_UI::REMORA_UI(
         std::string&   projectDir,
         std::string&   projectName,
         std::string&   modelName,
-        QStringList&   SpeciesList)
+        QStringList&   SpeciesList) :
+    m_ForecastStore(logger)
 {
     m_DatabasePtr            = databasePtr;
     m_Logger                 = logger;
@@ -30,6 +31,8 @@ REMORA_UI::REMORA_UI(
 //  m_IsMultiRun             = false;
     m_UseLastSingleRun       = true;
     m_MultiRunType.clear();
+    m_InsertChunkSize        = REMORA_Database::DefaultInsertChunkSize;
+    m_IsQueryProfiling       = false;
     m_MainWindowWidth        = m_MainWindow->width();
     m_MainWindowHeight       = m_MainWindow->height();
     m_LineWidthData          = 2;
@@ -39,6 +42,18 @@ REMORA_UI::REMORA_UI(
     m_LineWidthAxes          = 2;
     m_LineColor              = 1;
     m_GridLines              = false;
+    m_RunInProgress          = false;
+    m_IsHostSimulated        = false;
+    m_WidgetsEnabledBeforeRun = false;
+    m_PreviewActive          = false;
+    m_NumDrawsRequested      = 0;
+    m_NumDrawsElided         = 0;
+    m_RunQueued              = false;
+    m_SweepDialog            = nullptr;
+    m_SweepInProgress        = false;
+    m_StreamedNoUncertaintySeries = nullptr;
+    m_StreamedRuns           = 0;
+    m_StreamedYMax           = 0;
 
     MModeYearsPerRunSL       = m_TopLevelWidget->findChild<QSlider*     >("MModeYearsPerRunSL");
     MModeRunsPerForecastSL   = m_TopLevelWidget->findChild<QSlider*     >("MModeRunsPerForecastSL");
@@ -62,15 +77,23 @@ REMORA_UI::REMORA_UI(
     MModeWidget              = m_TopLevelWidget->findChild<QWidget*     >("MModeWidget");
     MModeParentChartW        = m_TopLevelWidget->findChild<QWidget*     >("MModeParentChartW");
     MModeForecastRunPB       = m_TopLevelWidget->findChild<QPushButton* >("MModeForecastRunPB");
+    MModeForecastCancelPB    = m_TopLevelWidget->findChild<QPushButton* >("MModeForecastCancelPB");
+    MModeRunProgressBar      = m_TopLevelWidget->findChild<QProgressBar*>("MModeRunProgressBar");
     MModeForecastLoadPB      = m_TopLevelWidget->findChild<QPushButton* >("MModeForecastLoadPB");
     MModeForecastSavePB      = m_TopLevelWidget->findChild<QPushButton* >("MModeForecastSavePB");
+    MModeForecastSweepPB     = m_TopLevelWidget->findChild<QPushButton* >("MModeForecastSweepPB");
     MModeForecastDelPB       = m_TopLevelWidget->findChild<QPushButton* >("MModeForecastDelPB");
     MModeMultiPlotTypePB     = m_TopLevelWidget->findChild<QPushButton* >("MModeMultiPlotTypePB");
     MModeMaxScaleFactorSB    = m_TopLevelWidget->findChild<QSpinBox*    >("MModeMaxScaleFactorSB");
     MModeShowMSYCB           = m_TopLevelWidget->findChild<QCheckBox*   >("MModeShowMSYCB");
     MModePctMSYCB            = m_TopLevelWidget->findChild<QCheckBox*   >("MModePctMSYCB");
+    MModeFanChartCB          = m_TopLevelWidget->findChild<QCheckBox*   >("MModeFanChartCB");
     MModeDeterministicRB     = m_TopLevelWidget->findChild<QRadioButton*>("MModeDeterministicRB");
     MModeStochasticRB        = m_TopLevelWidget->findChild<QRadioButton*>("MModeStochasticRB");
+    MModeSamplingCMB         = m_TopLevelWidget->findChild<QComboBox*   >("MModeSamplingCMB");
+    MModeAdaptiveCB          = m_TopLevelWidget->findChild<QCheckBox*   >("MModeAdaptiveCB");
+    MModeConvergenceToleranceSB = m_TopLevelWidget->findChild<QDoubleSpinBox*>("MModeConvergenceToleranceSB");
+    MModeAdaptiveRunsLB      = m_TopLevelWidget->findChild<QLabel*      >("MModeAdaptiveRunsLB");
     MModePlotTypeSSRB        = m_TopLevelWidget->findChild<QRadioButton*>("MModePlotTypeSSRB");
     MModePlotTypeMSRB        = m_TopLevelWidget->findChild<QRadioButton*>("MModePlotTypeMSRB");
 //  MModeHarvestTypePB       = m_TopLevelWidget->findChild<QPushButton* >("MModeHarvestTypePB");
@@ -94,11 +117,18 @@ REMORA_UI::REMORA_UI(
 
     MModeDeterministicRB->setChecked(false);
     MModeStochasticRB->setChecked(true);
+    MModeSamplingCMB->setCurrentText("Random");
+    MModeAdaptiveCB->setChecked(false);
+    MModeConvergenceToleranceSB->setEnabled(false);
+    MModeFanChartCB->setChecked(false);
     MModePlotTypeSSRB->setChecked(true);
     MModePlotTypeMSRB->setChecked(false);
     MModeMultiPlotTypePB->setEnabled(false);
     MModeYearsPerRunSL->setPageStep(1);
     MModeRunsPerForecastSL->setPageStep(1);
+    MModeRunProgressBar->setRange(0,100);
+    MModeRunProgressBar->hide();
+    MModeForecastCancelPB->hide();
     MModeHParamDL->setPageStep(1);
     MModeRParamDL->setPageStep(1);
     MModeKParamDL->setPageStep(1);
@@ -149,22 +179,29 @@ REMORA_UI::REMORA_UI(
     m_GridVLayt->addLayout(m_GridLayt);
     m_GridParent->setLayout(m_GridVLayt);
     m_VLayt->addWidget(m_ChartView);
+    m_VLayt->addWidget(m_GridParent);
+    m_GridParent->hide();
     MModeUpperPlotWidget->setLayout(m_VLayt);
 
     // Setup Remora's forecast directory
     m_RemoraScenarioDir = QDir(QString::fromStdString(m_ProjectDir)).filePath(
                                QString::fromStdString(nmfConstantsMSSPM::OutputScenariosDirMMode));
     QDir().mkdir(m_RemoraScenarioDir); // Makes the directory if it doesn't already exist
+    m_ForecastStore.setDirectory(QDir(m_RemoraScenarioDir).filePath("forecasts"));
 
     // Setup function map for setters
     m_FunctionMap["Forecast"]             = &REMORA_UI::setScenarioName;
     m_FunctionMap["NumYearsPerRun"]       = &REMORA_UI::setNumYearsPerRun;
     m_FunctionMap["NumRunsPerForecast"]   = &REMORA_UI::setNumRunsPerForecast;
     m_FunctionMap["isDeterministic"]      = &REMORA_UI::setDeterministic;
+    m_FunctionMap["SamplingMethod"]       = &REMORA_UI::setSamplingMethod;
+    m_FunctionMap["isAdaptive"]           = &REMORA_UI::setAdaptive;
+    m_FunctionMap["ConvergenceTolerance"] = &REMORA_UI::setConvergenceTolerance;
     m_FunctionMap["isSingleSpecies"]      = &REMORA_UI::setSingleSpecies;
     m_FunctionMap["isMultiPlot"]          = &REMORA_UI::setMultiPlot;
     m_FunctionMap["ForecastDataType"]     = &REMORA_UI::setForecastPlotType;
     m_FunctionMap["isMSYLineVisible"]     = &REMORA_UI::setMSYLineVisible;
+    m_FunctionMap["isFanChart"]           = &REMORA_UI::setFanChart;
     m_FunctionMap["r_Uncertainty"]        = &REMORA_UI::setUncertaintyGrowth;
     m_FunctionMap["K_Uncertainty"]        = &REMORA_UI::setUncertaintyCarryingCapacity;
     m_FunctionMap["HarvestType"]          = &REMORA_UI::setHarvestType;
@@ -173,16 +210,34 @@ REMORA_UI::REMORA_UI(
     m_FunctionMap["NumScaleFactorPoints"] = &REMORA_UI::setNumScaleFactorPoints;
     m_FunctionMap["point"]                = &REMORA_UI::setAScaleFactorPoint;
 
+    readSettings();
     setupMovableLineCharts(SpeciesList);
     setupConnections();
+    setupRunThread();
     enableWidgets(false);
 
+    // Limit the forecast preview to the chart's frame rate while dragging
+    m_PreviewTimer = new QTimer(this);
+    m_PreviewTimer->setSingleShot(true);
+    m_PreviewTimer->setInterval(33);
+    connect(m_PreviewTimer, SIGNAL(timeout()),
+            this,           SLOT(callback_PreviewTimer()));
+
+    // Redraws requested by several controls at once (i.e., loading a scenario) are drawn once
+    m_DrawPlotTimer = new QTimer(this);
+    m_DrawPlotTimer->setSingleShot(true);
+    m_DrawPlotTimer->setInterval(0);
+    connect(m_DrawPlotTimer, SIGNAL(timeout()),
+            this,            SLOT(callback_DrawPlotTimer()));
+
 //qDebug() << "Win size(1): " << MModeWindowWidget->width() << MModeWindowWidget->height();
 }
 
 REMORA_UI::~REMORA_UI()
 {
-
+    m_RunWorker->cancel();
+    m_RunThread->quit();
+    m_RunThread->wait();
 }
 
 void
@@ -210,8 +265,6 @@ REMORA_UI::checkAlgorithmIdentifiersForMultiRun(
         std::string& ObjectiveCriterion,
         std::string& Scaling)
 {
-    readSettings();
-
     //if (m_IsMultiRun) {
     if (! m_UseLastSingleRun) {
         Algorithm          = m_MultiRunType;
@@ -221,10 +274,21 @@ REMORA_UI::checkAlgorithmIdentifiersForMultiRun(
     }
 }
 
+void
+REMORA_UI::clearMSYCache()
+{
+    m_MSYCache.clear();
+}
+
 void
 REMORA_UI::setModelName(std::string modelName)
 {
     m_ModelName = modelName;
+    m_PreviewParameters = REMORA_ModelParameters();
+    m_PreviewForecastName.clear();
+    invalidateModelMetadata();
+    invalidateForecastInfo();
+    clearMSYCache();
 }
 
 bool
@@ -233,6 +297,239 @@ REMORA_UI::couldShowMSYCB()
     return (isSingleSpecies() || (isMultiSpecies() && isMultiPlot()));
 }
 
+void
+REMORA_UI::drawFanChart(
+        QChart* chart,
+        const boost::numeric::ublas::matrix<double>& FanChartQuantiles,
+        int& StartForecastYear,
+        double& YMinVal,
+        double& YMaxVal,
+        std::string& MainTitle,
+        std::string& XLabel,
+        std::string& YLabel,
+        const QColor& BandColor)
+{
+    int Theme = 0;
+    int NumYears = FanChartQuantiles.size1();
+    std::string ChartType = "Line";
+    std::string LineStyle = "DashedLine";
+    QStringList RowLabelsForBars;
+    QStringList ColumnLabelsForLegend;
+    QAreaSeries* band;
+    QLineSeries* lower;
+    QLineSeries* upper;
+    QColor bandColor;
+    boost::numeric::ublas::matrix<double> Median(NumYears,1);
+    const int bandColumns[2][2] = {{0,4},{1,3}}; // 5-95 and 25-75 percentiles
+    const int bandAlphas[2]     = {90,150};
+
+    for (int time=0; time<NumYears; ++time) {
+        Median(time,0) = FanChartQuantiles(time,2);
+    }
+
+    // The median line sets up the chart and its axes
+    m_ForecastLineChartMonteCarlo->populateChart(
+                chart,
+                ChartType,
+                LineStyle,
+                m_LineWidthData,
+                nmfConstantsMSSPM::ShowFirstPoint,
+                nmfConstants::DontShowLegend,
+                StartForecastYear,
+                nmfConstantsMSSPM::DontApplyNiceNumbersXAxis,
+                nmfConstantsMSSPM::LabelXAxisAsInts,
+                YMinVal,YMaxVal,
+                nmfConstantsMSSPM::LeaveGapsWhereNegative,
+                Median,
+                RowLabelsForBars,
+                ColumnLabelsForLegend,
+                {"Median"},
+                MainTitle,
+                XLabel,
+                YLabel,
+                m_FontSizeLabel,
+                m_FontSizeNumber,
+                m_Font,
+                m_LineWidthAxes,
+                m_LineColor,
+                {m_GridLines,m_GridLines},
+                Theme,
+                BandColor.darker(200),
+                "MonteCarloMedian",
+                1.0);
+    if (chart->series().isEmpty() || chart->axes(Qt::Horizontal).isEmpty() || chart->axes(Qt::Vertical).isEmpty()) {
+        return;
+    }
+    QAbstractSeries* median = chart->series().back();
+    QAbstractAxis*   axisX  = chart->axes(Qt::Horizontal).back();
+    QAbstractAxis*   axisY  = chart->axes(Qt::Vertical).back();
+
+    // Shaded bands between the percentiles, skipping years with gaps
+    for (int i=0; i<2; ++i) {
+        band  = new QAreaSeries();
+        lower = new QLineSeries(band);
+        upper = new QLineSeries(band);
+        for (int time=0; time<NumYears; ++time) {
+            if (FanChartQuantiles(time,bandColumns[i][0]) >= 0) {
+                lower->append(StartForecastYear+time,FanChartQuantiles(time,bandColumns[i][0]));
+                upper->append(StartForecastYear+time,FanChartQuantiles(time,bandColumns[i][1]));
+            }
+        }
+        bandColor = BandColor;
+        bandColor.setAlpha(bandAlphas[i]);
+        band->setLowerSeries(lower);
+        band->setUpperSeries(upper);
+        band->setName("MonteCarloBand");
+        band->setPen(Qt::NoPen);
+        band->setBrush(bandColor);
+        chart->addSeries(band);
+        band->attachAxis(axisX);
+        band->attachAxis(axisY);
+    }
+
+    // Keep the median on top of the bands
+    chart->removeSeries(median);
+    chart->addSeries(median);
+    median->attachAxis(axisX);
+    median->attachAxis(axisY);
+}
+
+void
+REMORA_UI::drawForecastPreview(const int& SpeciesNum)
+{
+    bool isFishingMortality = isFishingMortalityPlotType();
+    bool isRelativeBiomass  = isRelativeBiomassPlotType();
+    int StartYear;
+    int EndYear;
+    int NumSpecies         = int(m_PreviewParameters.InitBiomass.size());
+    int NumYearsPerRun     = getNumYearsPerRun();
+    int Theme              = 0;
+    double YMinVal         = 0;
+    double YMaxVal         = nmfConstants::NoValueDouble;
+    double ScaleVal        = getPlotScaleFactor();
+    double brightnessFactor = 0.2;
+    double time0Value      = 0;
+    std::string ChartType  = "Line";
+    std::string LineStyle  = "SolidLine";
+    std::string MainTitle  = "Forecast Preview for Species: " + getCurrentSpecies();
+    std::string XLabel     = "Year";
+    std::string YLabel     = "Biomass (" + getYLBLPlotScaleFactor(ScaleVal).toStdString() + "metric tons)";
+    QStringList RowLabelsForBars;
+    QStringList ColumnLabelsForLegend;
+    boost::numeric::ublas::matrix<double> PreviewBiomass;
+    boost::numeric::ublas::matrix<double> ChartLine;
+    std::vector<boost::numeric::ublas::matrix<double> > ChartLines;
+    REMORA_ModelParameters parameters = m_PreviewParameters;
+    REMORA_ForecastEngine engine(1);
+    QColor dimmedColor = QColor(255-brightnessFactor*255,
+                                255-brightnessFactor*255,
+                                255-brightnessFactor*255);
+
+    getYearRange(StartYear,EndYear);
+    if (isFishingMortality) {
+        YLabel = nmfConstantsMSSPM::OutputChartExploitationCatchTitle.toStdString();
+    } else if (isRelativeBiomass) {
+        YLabel = "Relative Biomass";
+    }
+
+    // Simulate all species without uncertainty using their current scale factors
+    for (int species=0; species<NumSpecies; ++species) {
+        for (int time=0; time<=NumYearsPerRun; ++time) {
+            parameters.Harvest(time,species) = getScaleValueFromPlot(species,time) *
+                                               parameters.LastHarvest[species];
+        }
+    }
+    engine.simulate(parameters,NumYearsPerRun,PreviewBiomass);
+
+    // The previewed line and, for reference, the last run's line without uncertainty
+    const boost::numeric::ublas::matrix<double>* lineBiomass[2] = {&PreviewBiomass,     &m_ForecastData.Biomass[0]};
+    const boost::numeric::ublas::matrix<double>* lineHarvest[2] = {&parameters.Harvest, &m_PreviewParameters.Harvest};
+    for (int line=0; line<2; ++line) {
+        ChartLine.resize(NumYearsPerRun+1,1);
+        for (int time=0; time<=NumYearsPerRun; ++time) {
+            double biomass = (*lineBiomass[line])(time,SpeciesNum);
+            if (isFishingMortality) {
+                ChartLine(time,0) = (nmfUtils::isNearlyZero(biomass)) ? nmfConstantsMSSPM::NoFishingMortality :
+                                                                        (*lineHarvest[line])(time,SpeciesNum)/biomass;
+            } else {
+                ChartLine(time,0) = biomass/ScaleVal;
+                if (time == 0) {
+                    time0Value = ChartLine(0,0);
+                }
+                if (isRelativeBiomass) {
+                    ChartLine(time,0) = (nmfUtils::isNearlyZero(time0Value)) ? 0 : ChartLine(time,0)/time0Value;
+                }
+            }
+        }
+        ChartLines.push_back(ChartLine);
+    }
+
+    m_GridParent->hide();
+    m_ChartView->show();
+    m_ForecastBiomassLineChart->clear(m_ChartWidget);
+    m_ForecastLineChartMonteCarlo->clear(m_ChartWidget);
+    m_ChartWidget->removeAllSeries();
+
+    m_ForecastLineChartMonteCarlo->populateChart(
+                m_ChartWidget,
+                ChartType,
+                LineStyle,
+                m_LineWidthData,
+                nmfConstantsMSSPM::ShowFirstPoint,
+                nmfConstants::DontShowLegend,
+                EndYear,
+                nmfConstantsMSSPM::DontApplyNiceNumbersXAxis,
+                nmfConstantsMSSPM::LabelXAxisAsInts,
+                YMinVal,YMaxVal,
+                nmfConstantsMSSPM::LeaveGapsWhereNegative,
+                ChartLines[1],
+                RowLabelsForBars,
+                ColumnLabelsForLegend,
+                {"Last Run"},
+                MainTitle,
+                XLabel,
+                YLabel,
+                m_FontSizeLabel,
+                m_FontSizeNumber,
+                m_Font,
+                m_LineWidthAxes,
+                m_LineColor,
+                {m_GridLines,m_GridLines},
+                Theme,
+                dimmedColor,
+                "Last Run",
+                1.0);
+    m_ForecastBiomassLineChart->populateChart(
+                m_ChartWidget,
+                ChartType,
+                LineStyle,
+                m_LineWidthData,
+                nmfConstantsMSSPM::ShowFirstPoint,
+                nmfConstants::DontShowLegend,
+                EndYear,
+                nmfConstantsMSSPM::DontApplyNiceNumbersXAxis,
+                nmfConstantsMSSPM::LabelXAxisAsInts,
+                YMinVal,YMaxVal,
+                nmfConstantsMSSPM::LeaveGapsWhereNegative,
+                ChartLines[0],
+                RowLabelsForBars,
+                ColumnLabelsForLegend,
+                {"Preview"},
+                MainTitle,
+                XLabel,
+                YLabel,
+                m_FontSizeLabel,
+                m_FontSizeNumber,
+                m_Font,
+                m_LineWidthAxes,
+                m_LineColor,
+                {m_GridLines,m_GridLines},
+                Theme,
+                QColor(nmfConstants::LineColors[0].c_str()),
+                "Preview",
+                1.0);
+}
+
 void
 REMORA_UI::drawMultiSpeciesChart()
 {
@@ -241,11 +538,7 @@ REMORA_UI::drawMultiSpeciesChart()
     bool isRelativeBiomass  = isRelativeBiomassPlotType();
 
     int StartForecastYear;
-    int StartYear;
-    int EndYear;
     int NumSpecies;
-    int NumObservedYears;
-    int LastHarvestYear    = 0;
     int NumYearsPerRun     = getNumYearsPerRun();
     int NumRunsPerForecast = getNumRunsPerForecast();
     int SpeciesNum         =  -1;
@@ -265,26 +558,18 @@ REMORA_UI::drawMultiSpeciesChart()
     std::string MainTitle = "Forecast Runs for All Species";
     std::string XLabel    = "Year";
     std::string YLabel;
-    std::string ForecastHarvestType;
-    std::string GrowthForm,HarvestForm,CompetitionForm,PredationForm;
     QStringList RowLabelsForBars;
     QStringList ColumnLabelsForLegend;
     QStringList ColumnLabelsForLegendMSY;
     QStringList HoverLabels;
     boost::numeric::ublas::matrix<double> ChartLine;
-    boost::numeric::ublas::matrix<double> Harvest;
     std::vector<std::string> SpeNames;
     std::vector<bool> GridLines = {true,true};
-    std::vector<boost::numeric::ublas::matrix<double> > ForecastBiomass;
     QList<QColor> LineColors;
 
     LineColors.append(QColor(nmfConstants::LineColors[0].c_str()));
 
-    getYearRange(StartYear,EndYear);
-    NumObservedYears  = EndYear - StartYear;
-    StartForecastYear = EndYear;
-
-    m_DatabasePtr->getSpecies(m_Logger,SpeNames);
+    SpeNames = getModelMetadata().SpeciesNames;
     for (std::string species : SpeNames) {
         ColumnLabelsForLegend    << QString::fromStdString(species);
         HoverLabels              << QString::fromStdString(species);
@@ -295,46 +580,44 @@ REMORA_UI::drawMultiSpeciesChart()
 
     if (isFishingMortality) {
         YLabel = nmfConstantsMSSPM::OutputChartExploitationCatchTitle.toStdString();
-        if (! m_DatabasePtr->getTimeSeriesData(
-                    m_TopLevelWidget,m_Logger,m_ProjectName,m_ModelName,"",
-                    QString::fromStdString(m_HarvestType).replace("forecast","").toStdString(),
-                    NumSpecies,NumObservedYears,Harvest)) {
-            return;
-        }
-        LastHarvestYear = Harvest.size1()-1;
     } else if (isAbsoluteBiomass) {
         YLabel = "Biomass (" + getYLBLPlotScaleFactor(ScaleVal).toStdString() + "metric tons)";
     } else if (isRelativeBiomass) {
         YLabel = "Relative Biomass";
     }
 
-    ChartLine.resize(NumYearsPerRun+1,NumSpecies);
-    ChartLine.clear();
-
-    if (! m_DatabasePtr->getForecastInfo(
-                m_ProjectName,m_ModelName,m_ForecastName,NumYearsPerRun,StartForecastYear,
-                Algorithm,Minimizer,ObjectiveCriterion,Scaling,
-                GrowthForm,HarvestForm,CompetitionForm,PredationForm,
-                ForecastHarvestType,NumRunsPerForecast)) {
+    // Read once per forecast, see drawSingleSpeciesChart
+    const REMORA_ForecastInfo& ForecastInfo = getForecastInfo();
+    if (! ForecastInfo.IsForecastFound) {
         return;
     }
+    if (isFishingMortality && ! getLastCatch(NumSpecies)) {
+        return;
+    }
+    NumYearsPerRun     = ForecastInfo.NumYearsPerRun;
+    NumRunsPerForecast = ForecastInfo.NumRunsPerForecast;
+    StartForecastYear  = ForecastInfo.StartForecastYear;
+    Algorithm          = ForecastInfo.Algorithm;
+    Minimizer          = ForecastInfo.Minimizer;
+    ObjectiveCriterion = ForecastInfo.ObjectiveCriterion;
+    Scaling            = ForecastInfo.Scaling;
     checkAlgorithmIdentifiersForMultiRun(Algorithm,Minimizer,ObjectiveCriterion,Scaling);
 
+    ChartLine.resize(NumYearsPerRun+1,NumSpecies);
+    ChartLine.clear();
+
     // Plot ForecastBiomass data
-    if (! m_DatabasePtr->getForecastBiomass(
-                m_TopLevelWidget,m_Logger,
-                m_ProjectName,m_ModelName,m_ForecastName,
-                NumSpecies,NumYearsPerRun,
-                Algorithm,Minimizer,ObjectiveCriterion,Scaling,
-                ForecastBiomass)) {
+    if (! getForecastBiomass(NumSpecies,NumYearsPerRun,NumRunsPerForecast,
+                             Algorithm,Minimizer,ObjectiveCriterion,Scaling,false)) {
         return;
     }
+    const std::vector<boost::numeric::ublas::matrix<double> >& ForecastBiomass = m_ForecastData.Biomass;
 
     // Get ChartLine Data (Forecast Biomass data without any stochasticity)
     for (int species=0; species<NumSpecies; ++species) {
         for (int time=0; time<=NumYearsPerRun; ++time) {
             if (isFishingMortality) {
-                HarvestValue = m_MovableLineCharts[species]->getYValue(time) * Harvest(LastHarvestYear,species);
+                HarvestValue = m_MovableLineCharts[species]->getYValue(time) * ForecastInfo.LastCatch[species];
                 if (nmfUtils::isNearlyZero(ForecastBiomass[0](time,species))) {
                     ChartLine(time,species) = nmfConstantsMSSPM::NoFishingMortality;
 //                  msg = "Found MS Biomass = 0, setting F to 0 for Species: " +
@@ -419,8 +702,6 @@ qDebug() << "species,rem0: " << species << remTime0Value;
 void
 REMORA_UI::drawMSYLines()
 {
-    int StartYear;
-    int EndYear;
     int NumSpecies;
     int StartForecastYear;
     double YMinVal         = 0;
@@ -435,8 +716,6 @@ REMORA_UI::drawMSYLines()
     std::string Minimizer;
     std::string ObjectiveCriterion;
     std::string Scaling;
-    std::string ForecastHarvestType;
-    std::string GrowthForm,HarvestForm,CompetitionForm,PredationForm;
     std::vector<std::string> SpeNames;
     QStringList RowLabelsForBars;
     QStringList HoverLabels;
@@ -444,21 +723,21 @@ REMORA_UI::drawMSYLines()
     QStringList ColumnLabelsForLegendMSY;
     QStringList ColumnLabelsForLegendPctMSY;
 
-    getYearRange(StartYear,EndYear);
-    StartForecastYear = EndYear;
-
-    m_DatabasePtr->getSpecies(m_Logger,SpeNames);
+    SpeNames = getModelMetadata().SpeciesNames;
     NumSpecies = SpeNames.size();
     MainTitle += SpeNames[SpeciesNum];
 
-    if (! m_DatabasePtr->getForecastInfo(
-                m_ProjectName,m_ModelName,m_ForecastName,
-                NumYearsPerRun,StartForecastYear,
-                Algorithm,Minimizer,ObjectiveCriterion,Scaling,
-                GrowthForm,HarvestForm,CompetitionForm,PredationForm,
-                ForecastHarvestType,NumRunsPerForecast)) {
+    const REMORA_ForecastInfo& ForecastInfo = getForecastInfo();
+    if (! ForecastInfo.IsForecastFound) {
         return;
     }
+    NumYearsPerRun     = ForecastInfo.NumYearsPerRun;
+    NumRunsPerForecast = ForecastInfo.NumRunsPerForecast;
+    StartForecastYear  = ForecastInfo.StartForecastYear;
+    Algorithm          = ForecastInfo.Algorithm;
+    Minimizer          = ForecastInfo.Minimizer;
+    ObjectiveCriterion = ForecastInfo.ObjectiveCriterion;
+    Scaling            = ForecastInfo.Scaling;
     checkAlgorithmIdentifiersForMultiRun(Algorithm,Minimizer,ObjectiveCriterion,Scaling);
 
     if (isSingleSpecies()) {
@@ -575,13 +854,9 @@ REMORA_UI::drawMSYLines(
     int Theme = 0;
     double MSYValue;
     double ScaleVal = getPlotScaleFactor(); // 1.0
-    std::string queryStr;
     std::string LineStyle    = "DashedLine";
     std::string ChartType    = "Line";
-    std::string isAggProdStr = "0";
     boost::numeric::ublas::matrix<double> ChartMSYData;
-    std::map<std::string, std::vector<std::string> > dataMap;
-    std::vector<std::string> fields;
     std::vector<bool> GridLines = {true,true};
     QColor LineColor = QColor(nmfConstants::LineColors[0].c_str());
 
@@ -598,26 +873,24 @@ REMORA_UI::drawMSYLines(
     }
     ChartMSYData.clear();
 
-    fields     = {"Algorithm","Minimizer","ObjectiveCriterion","Scaling","isAggProd","SpeName","Value"};
-    queryStr   = "SELECT Algorithm,Minimizer,ObjectiveCriterion,Scaling,isAggProd,SpeName,Value FROM " +
-                  TableName +
-                 " WHERE ProjectName = '"       + m_ProjectName +
-                 "' AND ModelName = '"          + m_ModelName +
-                 "' AND Algorithm = '"          + Algorithm +
-                 "' AND Minimizer = '"          + Minimizer +
-                 "' AND ObjectiveCriterion = '" + ObjectiveCriterion +
-                 "' AND Scaling = '"            + Scaling +
-                 "' AND isAggProd = "           + isAggProdStr +
-                 "  ORDER by SpeName";
-    dataMap = m_DatabasePtr->nmfQueryDatabase(queryStr, fields);
-    int NumRecords = dataMap["SpeName"].size();
-    if (NumRecords == 0) {
-        m_Logger->logMsg(nmfConstants::Error, queryStr);
-        return;
+    // The MSY values only change with a new estimation, so the % MSY dial just rescales the cached values
+    std::string cacheKey = TableName + '\n' + m_ProjectName + '\n' + m_ModelName + '\n' + Algorithm + '\n' +
+                           Minimizer + '\n' + ObjectiveCriterion + '\n' + Scaling;
+    if (m_MSYCache.find(cacheKey) == m_MSYCache.end()) {
+        REMORA_Database database(REMORA_Database::hostConnectionName(),m_Logger,queryProfiler());
+        std::unique_ptr<REMORA_Storage> storage = REMORA_Storage::create(&database,m_Logger);
+        if (! storage->loadMSY(TableName,m_ProjectName,m_ModelName,Algorithm,Minimizer,
+                               ObjectiveCriterion,Scaling,false,m_MSYCache[cacheKey])) {
+            m_MSYCache.erase(cacheKey);
+            return;
+        }
     }
+    const std::vector<double>& Value = m_MSYCache[cacheKey];
+    int NumRecords = int(Value.size());
+
     // Draw the MSY line
-    for (int i=0; i<NumSpecies; ++i) {
-        MSYValue = Pct*std::stod(dataMap["Value"][i])/ScaleVal;
+    for (int i=0; i<NumSpecies && i<NumRecords; ++i) {
+        MSYValue = Pct*Value[i]/ScaleVal;
         if (SpeciesNum == -1) {
             for (int j=0; j<=NumYearsPerRun; ++j) {
                 ChartMSYData(j,i) = MSYValue;
@@ -664,34 +937,48 @@ REMORA_UI::drawMSYLines(
 void
 REMORA_UI::drawPlot()
 {
-    m_ForecastBiomassLineChart->clear(m_ChartWidget);
-    m_ForecastHarvestLineChart->clear(m_ChartWidget);
-    m_ForecastLineChartMonteCarlo->clear(m_ChartWidget);
+    // Drawing now makes any pending redraw redundant
+    if (m_DrawPlotTimer->isActive()) {
+        m_DrawPlotTimer->stop();
+        m_NumDrawsElided += m_NumDrawsRequested;
+    }
+    m_NumDrawsRequested = 0;
 
     // These are necessary to prevent the window from resizing
     m_MainWindow->setMinimumSize(m_MainWindowWidth,m_MainWindowHeight);
     MModeFrame->setMinimumSize(m_FrameWidth,m_FrameHeight);
 
+    // The single species charts clear themselves only if they can't be updated in place
     if (couldShowMSYCB()) {
-        drawSingleSpeciesChart();
+        if (! drawSingleSpeciesChart()) {
+            m_ForecastBiomassLineChart->clear(m_ChartWidget);
+            m_ForecastHarvestLineChart->clear(m_ChartWidget);
+            m_ForecastLineChartMonteCarlo->clear(m_ChartWidget);
+        }
     } else {
+        m_ForecastBiomassLineChart->clear(m_ChartWidget);
+        m_ForecastHarvestLineChart->clear(m_ChartWidget);
+        m_ForecastLineChartMonteCarlo->clear(m_ChartWidget);
         drawMultiSpeciesChart();
     }
 
+    // A run only provides the preview's parameters if it simulated the forecast here
+    if (m_ForecastData.isValid() && (m_PreviewForecastName != m_ForecastName)) {
+        loadPreviewParameters();
+    }
+
     // Rescale axes of plot(s)
 //    resetXAxis();
 //    resetYAxis();
 
 }
 
-void
+bool
 REMORA_UI::drawSingleSpeciesChart()
 {
     bool isFishingMortality  = isFishingMortalityPlotType();
     bool isAbsoluteBiomass   = isAbsoluteBiomassPlotType();
     bool isRelativeBiomass   = isRelativeBiomassPlotType();
-    int StartYear;
-    int EndYear;
     int NumSpecies;
     int StartForecastYear;
     double YMinVal         = 0;
@@ -700,8 +987,6 @@ REMORA_UI::drawSingleSpeciesChart()
     int NumRunsPerForecast = getNumRunsPerForecast();
     int SpeciesNum         = getSpeciesNum();
     int Theme = 0;
-    int LastCatchYear      = 0;
-    int NumObservedYears;
     double ScaleVal         = getPlotScaleFactor();
     double brightnessFactor = 0.2;
     double CatchValue;
@@ -719,8 +1004,6 @@ REMORA_UI::drawSingleSpeciesChart()
     std::string msg;
     std::string MainTitleMultiPlot;
     std::string YLabelMultiPlot;
-    std::string GrowthForm,HarvestForm,CompetitionForm,PredationForm;
-    std::string ForecastHarvestType;
     QStringList RowLabelsForBars;
     QStringList ColumnLabelsForLegend;
     QStringList HoverData;
@@ -733,10 +1016,8 @@ REMORA_UI::drawSingleSpeciesChart()
     std::vector<boost::numeric::ublas::matrix<double> > ChartLineMultiPlot;
     std::vector<boost::numeric::ublas::matrix<double> > ChartLinesMonteCarloMultiPlot;
     std::vector<boost::numeric::ublas::matrix<double> > ChartLineSpans;
-    boost::numeric::ublas::matrix<double> Harvest;
+    std::vector<boost::numeric::ublas::matrix<double> > FanChartQuantilesMultiPlot;
     std::vector<bool> GridLines = {true,true};
-    std::vector<boost::numeric::ublas::matrix<double> > ForecastBiomass;
-    std::vector<boost::numeric::ublas::matrix<double> > ForecastBiomassMonteCarlo;
     std::vector<std::string> SpeNames;
     QList<QColor> LineColors;
     QColor dimmedColor = QColor(255-brightnessFactor*255,
@@ -744,94 +1025,79 @@ REMORA_UI::drawSingleSpeciesChart()
                                 255-brightnessFactor*255);
     LineColors.append(QColor(nmfConstants::LineColors[0].c_str()));
 
-    m_DatabasePtr->getSpecies(m_Logger,SpeNames);
+    SpeNames = getModelMetadata().SpeciesNames;
     NumSpecies = SpeNames.size();
     CurrentSpecies = SpeNames[SpeciesNum];
     MainTitle += " for Species: " + CurrentSpecies;
 
-    getYearRange(StartYear,EndYear);
-    StartForecastYear = EndYear;
-    NumObservedYears = EndYear-StartYear;
-
     if (isFishingMortality) {
         YLabel = nmfConstantsMSSPM::OutputChartExploitationCatchTitle.toStdString();
-        if (! m_DatabasePtr->getTimeSeriesData(
-                    m_TopLevelWidget,m_Logger,m_ProjectName,m_ModelName,"",
-                    QString::fromStdString(m_HarvestType).replace("forecast","").toStdString(),
-                    NumSpecies,NumObservedYears,Harvest)) {
-            return;
-        }
-        LastCatchYear = Harvest.size1()-1;
     } else if (isRelativeBiomass) {
         YLabel = "Relative Biomass";
     }
 
-    if (! m_DatabasePtr->getForecastInfo(
-                m_ProjectName,m_ModelName,m_ForecastName,
-                NumYearsPerRun,StartForecastYear,
-                Algorithm,Minimizer,ObjectiveCriterion,Scaling,
-                GrowthForm,HarvestForm,CompetitionForm,PredationForm,
-                ForecastHarvestType,NumRunsPerForecast)) {
-        return;
+    // The forecast's saved settings and the last observed catch are only read once per forecast,
+    // so changing the plot type or scale just transforms the forecast data in memory
+    const REMORA_ForecastInfo& ForecastInfo = getForecastInfo();
+    if (! ForecastInfo.IsForecastFound) {
+        return false;
     }
-    checkAlgorithmIdentifiersForMultiRun(Algorithm,Minimizer,ObjectiveCriterion,Scaling);
-
-    if (! m_DatabasePtr->getForecastBiomassMonteCarlo(
-                m_TopLevelWidget,m_Logger,m_ProjectName,
-                m_ModelName,m_ForecastName,
-                NumSpecies,NumYearsPerRun,NumRunsPerForecast,
-                Algorithm,Minimizer,ObjectiveCriterion,Scaling,
-                ForecastBiomassMonteCarlo)) {
-        return;
+    if (isFishingMortality && ! getLastCatch(NumSpecies)) {
+        return false;
     }
+    NumYearsPerRun     = ForecastInfo.NumYearsPerRun;
+    NumRunsPerForecast = ForecastInfo.NumRunsPerForecast;
+    StartForecastYear  = ForecastInfo.StartForecastYear;
+    Algorithm          = ForecastInfo.Algorithm;
+    Minimizer          = ForecastInfo.Minimizer;
+    ObjectiveCriterion = ForecastInfo.ObjectiveCriterion;
+    Scaling            = ForecastInfo.Scaling;
+    checkAlgorithmIdentifiersForMultiRun(Algorithm,Minimizer,ObjectiveCriterion,Scaling);
 
-    // Plot ForecastBiomass data
-    if (! m_DatabasePtr->getForecastBiomass(
-                m_TopLevelWidget,m_Logger,
-                m_ProjectName,m_ModelName,m_ForecastName,
-                NumSpecies,NumYearsPerRun,
-                Algorithm,Minimizer,ObjectiveCriterion,Scaling,
-                ForecastBiomass)) {
-        return;
+    // Use the forecast data handed over by the run if it's current, else read it from the
+    // database. Only the species drawn are read and transformed; the rest are read on demand.
+    bool isMultiPlotGrid = (isMultiSpecies() && isMultiPlot());
+    int FirstSpecies = (isMultiPlotGrid) ? 0          : SpeciesNum;
+    int LastSpecies  = (isMultiPlotGrid) ? NumSpecies : SpeciesNum+1;
+    if (! getForecastBiomass(NumSpecies,NumYearsPerRun,NumRunsPerForecast,
+                             Algorithm,Minimizer,ObjectiveCriterion,Scaling,true,
+                             (isMultiPlotGrid) ? -1 : SpeciesNum)) {
+        return false;
     }
+    const std::vector<boost::numeric::ublas::matrix<double> >& ForecastBiomass           = m_ForecastData.Biomass;
 
-    std::string currentSpecies = getCurrentSpecies();
-    if (! m_DatabasePtr->getForecastMonteCarloHoverData(
-                m_TopLevelWidget,m_Logger,currentSpecies,
-                m_ProjectName,m_ModelName,m_ForecastName,
-                Algorithm,Minimizer,ObjectiveCriterion,Scaling,
-                HoverData)) {
-        return;
+    if (! getForecastHoverData(SpeciesNum,Algorithm,Minimizer,ObjectiveCriterion,Scaling,HoverData)) {
+        return false;
     }
 
-    ChartLinesMonteCarlo.resize(NumYearsPerRun+1,ForecastBiomassMonteCarlo.size());
+    ChartLinesMonteCarlo.resize(NumYearsPerRun+1,NumRunsPerForecast);
     ChartLinesMonteCarlo.clear();
     ChartLine.resize(NumYearsPerRun+1,ForecastBiomass.size());
     ChartLine.clear();
     // NoUncertaintyRun = ForecastBiomass.size();
 
-    // Get ChartLinesMonteCarlo Data
-    std::vector<double> ymax = {};
-    for (int species=0; species<NumSpecies; ++species) {
-        ymax.push_back(0);
-        for (int line=0; line<NumRunsPerForecast; ++line) {
-            for (int time=0; time<=NumYearsPerRun; ++time) {
+    // Get ChartLinesMonteCarlo Data. The runs of each year are contiguous in the biomass tensor.
+    const REMORA_BiomassTensor& ForecastBiomassTensor = m_ForecastData.BiomassTensor;
+    std::vector<double> ymax(NumSpecies,0);
+    ChartLinesMonteCarloMultiPlot.resize(NumSpecies);
+    for (int species=FirstSpecies; species<LastSpecies; ++species) {
+        const double* time0Runs = ForecastBiomassTensor.runs(0,species);
+        for (int time=0; time<=NumYearsPerRun; ++time) {
+            const double* runs = ForecastBiomassTensor.runs(time,species);
+            if (isFishingMortality) {
+                CatchValue = m_MovableLineCharts[species/*SpeciesNum*/]->getYValue(time) * ForecastInfo.LastCatch[species];
+            }
+            for (int line=0; line<NumRunsPerForecast; ++line) {
                 if (isFishingMortality) {
-                    CatchValue = m_MovableLineCharts[species/*SpeciesNum*/]->getYValue(time) * Harvest(LastCatchYear,species);
-                    if (nmfUtils::isNearlyZero(ForecastBiomassMonteCarlo[line](time,species))) {
+                    if (nmfUtils::isNearlyZero(runs[line])) {
                         ChartLinesMonteCarlo(time,line) = nmfConstantsMSSPM::NoFishingMortality;
-//                       msg = "Found Monte Carlo Biomass = 0, setting F to 0 for Species: " +
-//                              SpeNames[species] + " at Year = " + std::to_string(time+StartForecastYear);
-//                       m_Logger->logMsg(nmfConstants::Warning,msg);
                     } else {
-                        ChartLinesMonteCarlo(time,line) = CatchValue/(ForecastBiomassMonteCarlo[line](time,species));
+                        ChartLinesMonteCarlo(time,line) = CatchValue/runs[line];
                     }
                 } else {
-                    ChartLinesMonteCarlo(time,line) = ForecastBiomassMonteCarlo[line](time,species)/ScaleVal;
-                    if (time == 0) {
-                        remTime0Value = ChartLinesMonteCarlo(0,line);
-                    }
+                    ChartLinesMonteCarlo(time,line) = runs[line]/ScaleVal;
                     if (isRelativeBiomass) {
+                        remTime0Value = time0Runs[line]/ScaleVal;
                         if (nmfUtils::isNearlyZero(remTime0Value)) {
                             ChartLinesMonteCarlo(time,line) = 0;
                         } else {
@@ -847,14 +1113,15 @@ REMORA_UI::drawSingleSpeciesChart()
         if (species == SpeciesNum) {
             ChartLinesMonteCarloSinglePlot = ChartLinesMonteCarlo;
         }
-        ChartLinesMonteCarloMultiPlot.push_back(ChartLinesMonteCarlo);
+        ChartLinesMonteCarloMultiPlot[species] = ChartLinesMonteCarlo;
     }
 
     // Get ChartLineMultiPlot Data
-    for (int species=0; species<NumSpecies; ++species) {
+    ChartLineMultiPlot.resize(NumSpecies);
+    for (int species=FirstSpecies; species<LastSpecies; ++species) {
             for (int time=0; time<=NumYearsPerRun; ++time) {
                 if (isFishingMortality) {
-                    CatchValue = m_MovableLineCharts[species]->getYValue(time) * Harvest(LastCatchYear,species);
+                    CatchValue = m_MovableLineCharts[species]->getYValue(time) * ForecastInfo.LastCatch[species];
                     if (nmfUtils::isNearlyZero(ForecastBiomass[0](time,species))) {
                         ChartLine(time,0) = nmfConstantsMSSPM::NoFishingMortality;
 //                      msg = "Found Biomass = 0, setting F to 0 for Species: " +
@@ -880,45 +1147,60 @@ REMORA_UI::drawSingleSpeciesChart()
             if (species == SpeciesNum) {
                 ChartLineSinglePlot = ChartLine;
             }
-            ChartLineMultiPlot.push_back(ChartLine);
+            ChartLineMultiPlot[species] = ChartLine;
     }
 
-    if (isMultiSpecies() && isMultiPlot()) {
-
-        m_ChartView->hide();
-        m_GridParent->show();
-
-        m_Charts.clear();
-        m_Views.clear();
-        for (int i=0; i<NumSpecies; ++i) {
-            m_Charts.append(new QChart());
-            m_Views.append( new QChartView(m_Charts[i]));
+    // In fan chart mode the runs are drawn as their per-year percentiles
+    bool isFan = isFanChart();
+    if (isFan) {
+        FanChartQuantilesMultiPlot.resize(NumSpecies);
+        for (int species=FirstSpecies; species<LastSpecies; ++species) {
+            getFanChartQuantiles(ChartLinesMonteCarloMultiPlot[species],ChartLineMultiPlot[species],
+                                 FanChartQuantilesMultiPlot[species],ymax[species]);
         }
+        YMaxVal = ymax[SpeciesNum];
+    }
 
-        // Test if perfect square
-        long double root = sqrt(NumSpecies);
-        bool perfectSquare = nmfUtils::isNearlyZero(root-std::floor(root));
-        if (! perfectSquare) {
-            root = std::floor(root+1);
-        }
-        int m = 0;
-        bool done = false;
-        for (int row=0; row<int(root); ++row) {
-            if (done) break;
-            m_GridLayt->setRowStretch(row,1);
-            for (int col=0; col<int(root); ++col) {
-                if (done) break;
-                if (m < NumSpecies) {
-                    if (row == 0) {
-                        m_GridLayt->setColumnStretch(col,1);
-                    }
-                    m_GridLayt->addWidget(m_Views[m++],row,col);
-                } else {
-                    done = true;
+    // A species' forecast series in the order they're drawn: the runs (or the fan chart's bands
+    // and median) followed by the forecast without uncertainty
+    auto toChartData = [&](const int& species) {
+        boost::numeric::ublas::matrix<double> ChartData;
+        const std::vector<int> fanColumns = {0,4,1,3,2};
+        if (isFan) {
+            ChartData.resize(NumYearsPerRun+1,fanColumns.size()+1);
+            for (int time=0; time<=NumYearsPerRun; ++time) {
+                for (unsigned col=0; col<fanColumns.size(); ++col) {
+                    ChartData(time,col) = FanChartQuantilesMultiPlot[species](time,fanColumns[col]);
+                }
+            }
+        } else {
+            ChartData.resize(NumYearsPerRun+1,NumRunsPerForecast+1);
+            for (int time=0; time<=NumYearsPerRun; ++time) {
+                for (int line=0; line<NumRunsPerForecast; ++line) {
+                    ChartData(time,line) = ChartLinesMonteCarloMultiPlot[species](time,line);
                 }
             }
         }
-        m_VLayt->addWidget(m_GridParent);
+        for (int time=0; time<=NumYearsPerRun; ++time) {
+            ChartData(time,ChartData.size2()-1) = ChartLineMultiPlot[species](time,0);
+        }
+        return ChartData;
+    };
+    QStringList SeriesNames = HoverData;
+    if (isFan) {
+        SeriesNames = QStringList() << "" << "" << "Median" << HoverData[NumRunsPerForecast];
+    }
+    std::string Layout = std::string(isFan ? "Fan " : "Lines ") + std::to_string(NumRunsPerForecast) + " " +
+                         std::to_string(NumYearsPerRun) + " " + std::to_string(StartForecastYear) + " " +
+                         std::to_string(m_LineWidthData) + " " + std::to_string(m_GridLines) + "\n";
+
+    if (isMultiPlotGrid) {
+
+        m_ChartView->hide();
+        m_GridParent->show();
+
+        resizeChartGrid(NumSpecies);
+
         int species = 0;
         if (isFishingMortality) {
             YLabelMultiPlot = "F Mortality (C/Bc)";
@@ -929,6 +1211,9 @@ REMORA_UI::drawSingleSpeciesChart()
             YLabelMultiPlot = "Rel Biomass";
         }
         QChart *chart;
+        QMargins chartMargins(8, 10, 20, 10);
+        m_ChartWidget->setMargins(chartMargins);
+        m_ChartWidget->removeAllSeries();
         for (int i=0; i<m_Charts.size(); ++i) {
 
             chart = m_Charts[i];
@@ -936,78 +1221,81 @@ REMORA_UI::drawSingleSpeciesChart()
             // This will set a chart background to a color. Revisit this logic if want to change the dark settings for a chart
             //chart->setBackgroundBrush(QBrush(QColor(100,100,100)));
 
-            QMargins chartMargins(8, 10, 20, 10);
-            m_ChartWidget->setMargins(chartMargins);
-
-            // Draw forecast line(s)
-            m_ChartWidget->removeAllSeries();
-
             // Draw stochastic forecast lines
             MainTitleMultiPlot =  SpeNames[species];
-            m_ForecastLineChartMonteCarlo->clear(chart);
+            if (! updateChartInPlace(chart,Layout+YLabelMultiPlot,toChartData(species),SeriesNames,
+                                     StartForecastYear,YMinVal,ymax[i],MainTitleMultiPlot)) {
+                m_ForecastLineChartMonteCarlo->clear(chart);
 
-            // Split curve up into spans.  Gaps are where yvalue = -1.
-            // Then iterate and call populateChart for each span.
-            m_ForecastLineChartMonteCarlo->populateChart(
-                        chart,
-                        ChartType,
-                        LineStyle,
-                        m_LineWidthData,
-                        nmfConstantsMSSPM::ShowFirstPoint,
-                        nmfConstants::DontShowLegend,
-                        StartForecastYear,
-                        nmfConstantsMSSPM::DontApplyNiceNumbersXAxis,
-                        nmfConstantsMSSPM::LabelXAxisAsInts,
-                        YMinVal, ymax[i], // YMaxVal,
-                        nmfConstantsMSSPM::LeaveGapsWhereNegative,
-                        ChartLinesMonteCarloMultiPlot[species],
-                        RowLabelsForBars,
-                        ColumnLabelsForLegend,
-                        HoverData,
-                        MainTitleMultiPlot,
-                        XLabel,
-                        YLabelMultiPlot,
-                        m_FontSizeLabel,
-                        m_FontSizeNumber,
-                        m_Font,
-                        m_LineWidthAxes,
-                        m_LineColor,
-                        {m_GridLines,m_GridLines},
-                        Theme,
-                        dimmedColor,
-                        "MonteCarloSimulation",
-                        1.0);
+                if (isFan) {
+                    drawFanChart(chart,FanChartQuantilesMultiPlot[species],StartForecastYear,
+                                 YMinVal,ymax[i],MainTitleMultiPlot,XLabel,YLabelMultiPlot,dimmedColor);
+                } else {
+                    // Split curve up into spans.  Gaps are where yvalue = -1.
+                    // Then iterate and call populateChart for each span.
+                    m_ForecastLineChartMonteCarlo->populateChart(
+                                chart,
+                                ChartType,
+                                LineStyle,
+                                m_LineWidthData,
+                                nmfConstantsMSSPM::ShowFirstPoint,
+                                nmfConstants::DontShowLegend,
+                                StartForecastYear,
+                                nmfConstantsMSSPM::DontApplyNiceNumbersXAxis,
+                                nmfConstantsMSSPM::LabelXAxisAsInts,
+                                YMinVal, ymax[i], // YMaxVal,
+                                nmfConstantsMSSPM::LeaveGapsWhereNegative,
+                                ChartLinesMonteCarloMultiPlot[species],
+                                RowLabelsForBars,
+                                ColumnLabelsForLegend,
+                                HoverData,
+                                MainTitleMultiPlot,
+                                XLabel,
+                                YLabelMultiPlot,
+                                m_FontSizeLabel,
+                                m_FontSizeNumber,
+                                m_Font,
+                                m_LineWidthAxes,
+                                m_LineColor,
+                                {m_GridLines,m_GridLines},
+                                Theme,
+                                dimmedColor,
+                                "MonteCarloSimulation",
+                                1.0);
+                }
 
-            // Draw single line without any uncertainty variation
-            m_ForecastBiomassLineChart->populateChart(
-                        chart,
-                        ChartType,
-                        LineStyle,
-                        m_LineWidthData,
-                        nmfConstantsMSSPM::ShowFirstPoint,
-                        nmfConstants::DontShowLegend,
-                        StartForecastYear,
-                        nmfConstantsMSSPM::DontApplyNiceNumbersXAxis,
-                        nmfConstantsMSSPM::LabelXAxisAsInts,
-                        YMinVal, ymax[i], // YMaxVal,
-                        nmfConstantsMSSPM::LeaveGapsWhereNegative,
-                        ChartLineMultiPlot[species],
-                        RowLabelsForBars,
-                        ColumnLabelsForLegend,
-                        {HoverData[NumRunsPerForecast]},
-                        MainTitleMultiPlot,
-                        XLabel,
-                        YLabelMultiPlot,
-                        m_FontSizeLabel,
-                        m_FontSizeNumber,
-                        m_Font,
-                        m_LineWidthAxes,
-                        m_LineColor,
-                        {m_GridLines,m_GridLines},
-                        Theme,
-                        LineColors[0],
-                        "No Uncertainty Variations",
-                        1.0);
+                // Draw single line without any uncertainty variation
+                m_ForecastBiomassLineChart->populateChart(
+                            chart,
+                            ChartType,
+                            LineStyle,
+                            m_LineWidthData,
+                            nmfConstantsMSSPM::ShowFirstPoint,
+                            nmfConstants::DontShowLegend,
+                            StartForecastYear,
+                            nmfConstantsMSSPM::DontApplyNiceNumbersXAxis,
+                            nmfConstantsMSSPM::LabelXAxisAsInts,
+                            YMinVal, ymax[i], // YMaxVal,
+                            nmfConstantsMSSPM::LeaveGapsWhereNegative,
+                            ChartLineMultiPlot[species],
+                            RowLabelsForBars,
+                            ColumnLabelsForLegend,
+                            {HoverData[NumRunsPerForecast]},
+                            MainTitleMultiPlot,
+                            XLabel,
+                            YLabelMultiPlot,
+                            m_FontSizeLabel,
+                            m_FontSizeNumber,
+                            m_Font,
+                            m_LineWidthAxes,
+                            m_LineColor,
+                            {m_GridLines,m_GridLines},
+                            Theme,
+                            LineColors[0],
+                            "No Uncertainty Variations",
+                            1.0);
+                rememberChartLayout(chart,Layout+YLabelMultiPlot);
+            }
 
             removeMSYLines(chart,{"MSY = r/2","MSY = K/2"});
             removeMSYLines(chart,{"MSY = % of r/2","MSY = % of K/2"});
@@ -1059,70 +1347,82 @@ REMORA_UI::drawSingleSpeciesChart()
         QMargins chartMargins(8, 10, 20, 10);
         m_ChartWidget->setMargins(chartMargins);
 
-        // Draw forecast line(s)
-        m_ChartWidget->removeAllSeries();
+        // Draw forecast line(s), replacing the data of the ones already drawn if the layout is the same
+        if (! updateChartInPlace(m_ChartWidget,Layout+YLabel,toChartData(SpeciesNum),SeriesNames,
+                                 StartForecastYear,YMinVal,YMaxVal,MainTitle)) {
+            m_ForecastBiomassLineChart->clear(m_ChartWidget);
+            m_ForecastHarvestLineChart->clear(m_ChartWidget);
+            m_ForecastLineChartMonteCarlo->clear(m_ChartWidget);
+            m_ChartWidget->removeAllSeries();
 
-        // Draw stochastic forecast lines
-        m_ForecastLineChartMonteCarlo->populateChart(
-                    m_ChartWidget,
-                    ChartType,
-                    LineStyle,
-                    m_LineWidthData,
-                    nmfConstantsMSSPM::ShowFirstPoint,
-                    nmfConstants::DontShowLegend,
-                    StartForecastYear,
-                    nmfConstantsMSSPM::DontApplyNiceNumbersXAxis,
-                    nmfConstantsMSSPM::LabelXAxisAsInts,
-                    YMinVal,YMaxVal,
-                    nmfConstantsMSSPM::LeaveGapsWhereNegative,
-                    ChartLinesMonteCarloSinglePlot,
-                    RowLabelsForBars,
-                    ColumnLabelsForLegend,
-                    HoverData,
-                    MainTitle,
-                    XLabel,
-                    YLabel,
-                    m_FontSizeLabel,
-                    m_FontSizeNumber,
-                    m_Font,
-                    m_LineWidthAxes,
-                    m_LineColor,
-                    {m_GridLines,m_GridLines},
-                    Theme,
-                    dimmedColor,
-                    "MonteCarloSimulation",
-                    1.0);
+            // Draw stochastic forecast lines, or their percentiles in fan chart mode
+            if (isFan) {
+                drawFanChart(m_ChartWidget,FanChartQuantilesMultiPlot[SpeciesNum],StartForecastYear,
+                             YMinVal,YMaxVal,MainTitle,XLabel,YLabel,dimmedColor);
+            } else {
+                m_ForecastLineChartMonteCarlo->populateChart(
+                            m_ChartWidget,
+                            ChartType,
+                            LineStyle,
+                            m_LineWidthData,
+                            nmfConstantsMSSPM::ShowFirstPoint,
+                            nmfConstants::DontShowLegend,
+                            StartForecastYear,
+                            nmfConstantsMSSPM::DontApplyNiceNumbersXAxis,
+                            nmfConstantsMSSPM::LabelXAxisAsInts,
+                            YMinVal,YMaxVal,
+                            nmfConstantsMSSPM::LeaveGapsWhereNegative,
+                            ChartLinesMonteCarloSinglePlot,
+                            RowLabelsForBars,
+                            ColumnLabelsForLegend,
+                            HoverData,
+                            MainTitle,
+                            XLabel,
+                            YLabel,
+                            m_FontSizeLabel,
+                            m_FontSizeNumber,
+                            m_Font,
+                            m_LineWidthAxes,
+                            m_LineColor,
+                            {m_GridLines,m_GridLines},
+                            Theme,
+                            dimmedColor,
+                            "MonteCarloSimulation",
+                            1.0);
+            }
 
-        // Draw single line without any uncertainty variation
-        m_ForecastBiomassLineChart->populateChart(
-                    m_ChartWidget,
-                    ChartType,
-                    LineStyle,
-                    m_LineWidthData,
-                    nmfConstantsMSSPM::ShowFirstPoint,
-                    nmfConstants::DontShowLegend,
-                    StartForecastYear,
-                    nmfConstantsMSSPM::DontApplyNiceNumbersXAxis,
-                    nmfConstantsMSSPM::LabelXAxisAsInts,
-                    YMinVal,YMaxVal,
-                    nmfConstantsMSSPM::LeaveGapsWhereNegative,
-                    ChartLineSinglePlot,
-                    RowLabelsForBars,
-                    ColumnLabelsForLegend,
-                    {HoverData[NumRunsPerForecast]},
-                    MainTitle,
-                    XLabel,
-                    YLabel,
-                    m_FontSizeLabel,
-                    m_FontSizeNumber,
-                    m_Font,
-                    m_LineWidthAxes,
-                    m_LineColor,
-                    {m_GridLines,m_GridLines},
-                    Theme,
-                    LineColors[0],
-                    "No Uncertainty Variations",
-                    1.0);
+            // Draw single line without any uncertainty variation
+            m_ForecastBiomassLineChart->populateChart(
+                        m_ChartWidget,
+                        ChartType,
+                        LineStyle,
+                        m_LineWidthData,
+                        nmfConstantsMSSPM::ShowFirstPoint,
+                        nmfConstants::DontShowLegend,
+                        StartForecastYear,
+                        nmfConstantsMSSPM::DontApplyNiceNumbersXAxis,
+                        nmfConstantsMSSPM::LabelXAxisAsInts,
+                        YMinVal,YMaxVal,
+                        nmfConstantsMSSPM::LeaveGapsWhereNegative,
+                        ChartLineSinglePlot,
+                        RowLabelsForBars,
+                        ColumnLabelsForLegend,
+                        {HoverData[NumRunsPerForecast]},
+                        MainTitle,
+                        XLabel,
+                        YLabel,
+                        m_FontSizeLabel,
+                        m_FontSizeNumber,
+                        m_Font,
+                        m_LineWidthAxes,
+                        m_LineColor,
+                        {m_GridLines,m_GridLines},
+                        Theme,
+                        LineColors[0],
+                        "No Uncertainty Variations",
+                        1.0);
+            rememberChartLayout(m_ChartWidget,Layout+YLabel);
+        }
 
         // Remove any existing MSY series
         removeMSYLines(m_ChartWidget,{"MSY = r/2","MSY = K/2"});
@@ -1162,6 +1462,7 @@ REMORA_UI::drawSingleSpeciesChart()
 
         qobject_cast<QValueAxis*>(m_ChartWidget->axes(Qt::Vertical).back())->setTickCount(5);
     }
+    return true;
 }
 
 void
@@ -1184,6 +1485,7 @@ REMORA_UI::enableWidgets(bool enable)
     MModeMaxScaleFactorSB->setEnabled(enable);
     MModeShowMSYCB->setEnabled(enable);
     MModePctMSYCB->setEnabled(enable);
+    MModeFanChartCB->setEnabled(enable);
     MModePlotTypeSSRB->setEnabled(enable);
     MModePlotTypeMSRB->setEnabled(enable);
     MModePctMSYLBL->setEnabled(enable);
@@ -1206,18 +1508,215 @@ REMORA_UI::getCarryingCapacityUncertainty()
     return MModeKParamLE->text();
 }
 
+bool
+REMORA_UI::getForecastBiomass(
+        int& NumSpecies,
+        int& NumYearsPerRun,
+        int& NumRunsPerForecast,
+        std::string& Algorithm,
+        std::string& Minimizer,
+        std::string& ObjectiveCriterion,
+        std::string& Scaling,
+        const bool& includeMonteCarlo,
+        const int& monteCarloSpeciesNum)
+{
+    bool isLoadNeeded = false;
+
+    if (! m_ForecastData.matches(m_ProjectName,m_ModelName,m_ForecastName,
+                                 Algorithm,Minimizer,ObjectiveCriterion,Scaling,
+                                 NumSpecies,NumYearsPerRun,NumRunsPerForecast)) {
+        m_ForecastData.clear();
+        m_ForecastData.ProjectName        = m_ProjectName;
+        m_ForecastData.ModelName          = m_ModelName;
+        m_ForecastData.ForecastName       = m_ForecastName;
+        m_ForecastData.Algorithm          = Algorithm;
+        m_ForecastData.Minimizer          = Minimizer;
+        m_ForecastData.ObjectiveCriterion = ObjectiveCriterion;
+        m_ForecastData.Scaling            = Scaling;
+        m_ForecastData.NumSpecies         = NumSpecies;
+        m_ForecastData.NumYearsPerRun     = NumYearsPerRun;
+        m_ForecastData.NumRunsPerForecast = NumRunsPerForecast;
+        m_ForecastData.NumRunsRequested   = NumRunsPerForecast;
+
+        // The binary forecast store is mapped without reading the runs. Failing that, the
+        // Monte Carlo runs are read from the database only for the species that are drawn,
+        // unless REMORA simulated the forecast, in which case the database holds another.
+        if (! m_ForecastStore.load(m_ForecastData)) {
+            if (m_ForecastStore.isEngineForecast(m_ForecastData)) {
+                m_Logger->logMsg(nmfConstants::Warning,"REMORA_UI::getForecastBiomass: Forecast " +
+                                 m_ForecastName + " must be run again");
+                return false;
+            }
+            REMORA_QueryTimer biomassTimer(queryProfiler(),"REMORA_UI::getForecastBiomass",
+                                           "SELECT nmfDatabase::getForecastBiomass");
+            bool isBiomassFound = m_DatabasePtr->getForecastBiomass(
+                        m_TopLevelWidget,m_Logger,
+                        m_ProjectName,m_ModelName,m_ForecastName,
+                        NumSpecies,NumYearsPerRun,
+                        Algorithm,Minimizer,ObjectiveCriterion,Scaling,
+                        m_ForecastData.Biomass);
+            biomassTimer.stop(NumYearsPerRun+1,sizeof(double)*(NumYearsPerRun+1)*NumSpecies);
+            if (! isBiomassFound) {
+                return false;
+            }
+            m_ForecastData.BiomassTensor.resize(NumYearsPerRun+1,NumSpecies,NumRunsPerForecast);
+            m_ForecastData.MonteCarloSpeciesLoaded.assign(NumSpecies,false);
+        }
+    }
+
+    // An adaptive forecast may have used fewer runs than were requested
+    NumRunsPerForecast = m_ForecastData.NumRunsPerForecast;
+
+    if (includeMonteCarlo) {
+        for (int species=0; species<NumSpecies; ++species) {
+            if (((monteCarloSpeciesNum == -1) || (species == monteCarloSpeciesNum)) &&
+                ! m_ForecastData.isMonteCarloLoaded(species)) {
+                isLoadNeeded = true;
+            }
+        }
+        if (isLoadNeeded && ! loadForecastBiomassMonteCarlo(monteCarloSpeciesNum)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+REMORA_UI::getForecastHoverData(
+        const int&         SpeciesNum,
+        const std::string& Algorithm,
+        const std::string& Minimizer,
+        const std::string& ObjectiveCriterion,
+        const std::string& Scaling,
+        QStringList&       HoverData)
+{
+    std::string Species = getCurrentSpecies();
+
+    HoverData.clear();
+
+    // Forecasts simulated by REMORA carry their own hover data
+    if (int(m_ForecastData.HoverData.size()) == getNumSpecies()) {
+        for (const std::string& hover : m_ForecastData.HoverData[SpeciesNum]) {
+            HoverData << QString::fromStdString(hover);
+        }
+        return true;
+    }
+
+    std::vector<std::string>& CachedHoverData = m_ForecastInfo.HoverData[Species];
+    if (CachedHoverData.empty()) {
+        REMORA_QueryTimer hoverTimer(queryProfiler(),"REMORA_UI::getForecastHoverData",
+                                     "SELECT nmfDatabase::getForecastMonteCarloHoverData");
+        bool isHoverFound = m_DatabasePtr->getForecastMonteCarloHoverData(
+                    m_TopLevelWidget,m_Logger,Species,
+                    m_ProjectName,m_ModelName,m_ForecastName,
+                    Algorithm,Minimizer,ObjectiveCriterion,Scaling,
+                    HoverData);
+        hoverTimer.stop(HoverData.size(),HoverData.join("").size());
+        if (! isHoverFound) {
+            m_ForecastInfo.HoverData.erase(Species);
+            return false;
+        }
+        for (const QString& hover : HoverData) {
+            CachedHoverData.push_back(hover.toStdString());
+        }
+        return true;
+    }
+    for (const std::string& hover : CachedHoverData) {
+        HoverData << QString::fromStdString(hover);
+    }
+    return true;
+}
+
+const REMORA_ForecastInfo&
+REMORA_UI::getForecastInfo()
+{
+    int StartYear;
+    int EndYear;
+
+    if (m_ForecastInfo.IsLoaded &&
+        (m_ForecastInfo.ProjectName  == m_ProjectName) &&
+        (m_ForecastInfo.ModelName    == m_ModelName)   &&
+        (m_ForecastInfo.ForecastName == m_ForecastName)) {
+        return m_ForecastInfo;
+    }
+    invalidateForecastInfo();
+    clearMSYCache();
+    m_ForecastInfo.ProjectName  = m_ProjectName;
+    m_ForecastInfo.ModelName    = m_ModelName;
+    m_ForecastInfo.ForecastName = m_ForecastName;
+
+    // The number of years and runs and the first year are overwritten with the saved values
+    getYearRange(StartYear,EndYear);
+    m_ForecastInfo.NumYearsPerRun     = getNumYearsPerRun();
+    m_ForecastInfo.NumRunsPerForecast = getNumRunsPerForecast();
+    m_ForecastInfo.StartForecastYear  = EndYear;
+    REMORA_QueryTimer forecastInfoTimer(queryProfiler(),"REMORA_UI::getForecastInfo",
+                                        "SELECT nmfDatabase::getForecastInfo");
+    m_ForecastInfo.IsForecastFound = m_DatabasePtr->getForecastInfo(
+                m_ProjectName,m_ModelName,m_ForecastName,
+                m_ForecastInfo.NumYearsPerRun,m_ForecastInfo.StartForecastYear,
+                m_ForecastInfo.Algorithm,m_ForecastInfo.Minimizer,
+                m_ForecastInfo.ObjectiveCriterion,m_ForecastInfo.Scaling,
+                m_ForecastInfo.GrowthForm,m_ForecastInfo.HarvestForm,
+                m_ForecastInfo.CompetitionForm,m_ForecastInfo.PredationForm,
+                m_ForecastInfo.ForecastHarvestType,m_ForecastInfo.NumRunsPerForecast);
+    forecastInfoTimer.stop(m_ForecastInfo.IsForecastFound ? 1 : 0,0);
+
+    m_ForecastInfo.IsLoaded = true;
+    return m_ForecastInfo;
+}
+
 QString
 REMORA_UI::getForecastPlotType()
 {
     return MModeForecastPlotTypeCMB->currentText();
 }
 
+QString
+REMORA_UI::getConvergenceTolerance()
+{
+    return QString::number(MModeConvergenceToleranceSB->value());
+}
+
 QString
 REMORA_UI::getGrowthUncertainty()
 {
     return MModeRParamLE->text();
 }
 
+bool
+REMORA_UI::getLastCatch(const int& NumSpecies)
+{
+    int StartYear;
+    int EndYear;
+    std::string CatchType = QString::fromStdString(m_HarvestType).replace("forecast","").toStdString();
+    boost::numeric::ublas::matrix<double> Harvest;
+
+    // Kept with the forecast info, so getForecastInfo must be called first
+    if ((m_ForecastInfo.CatchType == CatchType) && (int(m_ForecastInfo.LastCatch.size()) == NumSpecies)) {
+        return true;
+    }
+    m_ForecastInfo.CatchType.clear();
+    m_ForecastInfo.LastCatch.clear();
+
+    getYearRange(StartYear,EndYear);
+    REMORA_QueryTimer harvestTimer(queryProfiler(),"REMORA_UI::getLastCatch",
+                                   "SELECT nmfDatabase::getTimeSeriesData");
+    bool isHarvestFound = m_DatabasePtr->getTimeSeriesData(
+                m_TopLevelWidget,m_Logger,m_ProjectName,m_ModelName,"",CatchType,
+                NumSpecies,EndYear-StartYear,Harvest);
+    harvestTimer.stop(Harvest.size1(),sizeof(double)*Harvest.size1()*Harvest.size2());
+    if (! isHarvestFound || (Harvest.size1() == 0) || (int(Harvest.size2()) < NumSpecies)) {
+        return false;
+    }
+    for (int species=0; species<NumSpecies; ++species) {
+        m_ForecastInfo.LastCatch.push_back(Harvest(Harvest.size1()-1,species));
+    }
+    m_ForecastInfo.CatchType = CatchType;
+    return true;
+}
+
 QString
 REMORA_UI::getHarvestType()
 {
@@ -1230,41 +1729,6 @@ REMORA_UI::getHarvestUncertainty()
     return MModeHParamLE->text();
 }
 
-bool
-REMORA_UI::getLastYearsCatchValues(
-        int& lastYear,
-        std::vector<double>& lastYearsCatchValues)
-{
-    bool retv = true;
-    std::vector<std::string> fields;
-    std::map<std::string, std::vector<std::string> > dataMap;
-    std::string queryStr;
-    std::string lastYearHarvestTable = QString::fromStdString(m_HarvestType).replace("forecast","").toStdString();
-    lastYearsCatchValues.clear();
-
-    // Get last year's catch data
-    fields    = {"Value"};
-    queryStr  = "SELECT Value FROM " +
-                 lastYearHarvestTable +
-                " WHERE ProjectName = '" + m_ProjectName +
-                "' AND ModelName = '"    + m_ModelName +
-                "' AND Year = " + std::to_string(lastYear-1);
-
-    dataMap  = m_DatabasePtr->nmfQueryDatabase(queryStr, fields);
-    int NumRecords = int(dataMap["Value"].size());
-    if (NumRecords > 0) {
-        for (int i=0; i<NumRecords; ++i) {
-            lastYearsCatchValues.push_back(std::stod(dataMap["Value"][i]));
-        }
-    } else {
-        std::string msg = "No entries found in table: " + lastYearHarvestTable;
-        m_Logger->logMsg(nmfConstants::Error,msg);
-        m_Logger->logMsg(nmfConstants::Error,queryStr);
-        retv = false;
-    }
-    return retv;
-}
-
 int
 REMORA_UI::getMaxYScaleFactor(const int& speciesNum)
 {
@@ -1303,6 +1767,46 @@ REMORA_UI::getCurrentSpecies()
     return MModeSpeciesCMB->currentText().toStdString();
 }
 
+void
+REMORA_UI::getFanChartQuantiles(
+        const boost::numeric::ublas::matrix<double>& ChartLinesMonteCarlo,
+        const boost::numeric::ublas::matrix<double>& ChartLine,
+        boost::numeric::ublas::matrix<double>& FanChartQuantiles,
+        double& YMaxVal)
+{
+    // Columns are the 5th, 25th, 50th, 75th, and 95th percentiles
+    const std::vector<double> probabilities = {0.05,0.25,0.50,0.75,0.95};
+    int NumYears = ChartLinesMonteCarlo.size1();
+    int NumRuns  = ChartLinesMonteCarlo.size2();
+    std::vector<double> values;
+    std::vector<double> quantiles;
+
+    YMaxVal = 0;
+    values.reserve(NumRuns);
+    FanChartQuantiles.resize(NumYears,probabilities.size());
+    for (int time=0; time<NumYears; ++time) {
+        // Negative values are gaps (i.e., no fishing mortality) and aren't part of the distribution
+        values.clear();
+        for (int line=0; line<NumRuns; ++line) {
+            if (ChartLinesMonteCarlo(time,line) >= 0) {
+                values.push_back(ChartLinesMonteCarlo(time,line));
+            }
+        }
+        if (values.empty()) {
+            quantiles.assign(probabilities.size(),nmfConstantsMSSPM::NoFishingMortality);
+        } else {
+            quantiles = REMORA_Statistics::quantiles(values,probabilities);
+        }
+        for (unsigned col=0; col<probabilities.size(); ++col) {
+            FanChartQuantiles(time,col) = quantiles[col];
+        }
+        YMaxVal = std::max(YMaxVal,quantiles.back());
+        if (time < int(ChartLine.size1())) {
+            YMaxVal = std::max(YMaxVal,ChartLine(time,0));
+        }
+    }
+}
+
 int
 REMORA_UI::getNumYearsPerRun()
 {
@@ -1316,6 +1820,89 @@ REMORA_UI::getPctMSYValue()
     return MModePctMSYDL->value()/100.0;
 }
 
+bool
+REMORA_UI::getRunSettings(REMORA_RunSettings& settings)
+{
+    int NumSpecies;
+    int NumYearsPerRun = getNumYearsPerRun();
+    int ForecastYearsPerRun;
+    int ForecastRunsPerForecast;
+    int StartForecastYear;
+    std::string ForecastHarvestType;
+
+    settings.ConnectionName     = REMORA_Database::hostConnectionName();
+    settings.CacheDir           = QDir(m_RemoraScenarioDir).filePath("cache");
+    settings.ForecastStoreDir   = QDir(m_RemoraScenarioDir).filePath("forecasts");
+    settings.QueryProfiler      = queryProfiler();
+    settings.ProjectName        = m_ProjectName;
+    settings.ModelName          = m_ModelName;
+    settings.ForecastName       = m_ForecastName;
+    settings.HarvestType        = m_HarvestType;
+    settings.NumYearsPerRun     = NumYearsPerRun;
+    settings.NumRunsPerForecast = getNumRunsPerForecast();
+    settings.IsDeterministic    = isDeterministic();
+    settings.SamplingMethod     = getSamplingMethod().toStdString();
+    settings.IsAdaptive         = isAdaptive();
+    settings.InsertChunkSize    = m_InsertChunkSize;
+    settings.ConvergenceTolerance        = MModeConvergenceToleranceSB->value()/100.0;
+    settings.GrowthUncertainty           = MModeRParamLE->text().toDouble()/100.0;
+    settings.CarryingCapacityUncertainty = MModeKParamLE->text().toDouble()/100.0;
+    settings.HarvestUncertainty          = MModeHParamLE->text().toDouble()/100.0;
+
+    const REMORA_ModelMetadata& metadata = getModelMetadata();
+    settings.Algorithm          = metadata.Algorithm;
+    settings.Minimizer          = metadata.Minimizer;
+    settings.ObjectiveCriterion = metadata.ObjectiveCriterion;
+    settings.Scaling            = metadata.Scaling;
+    if (! metadata.IsModelFound) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA::getRunSettings: No models found");
+        return false;
+    }
+    checkAlgorithmIdentifiersForMultiRun(settings.Algorithm,settings.Minimizer,
+                                         settings.ObjectiveCriterion,settings.Scaling);
+
+    getYearRange(settings.StartYear,settings.EndYear);
+
+    // The forecast's model forms and the estimation it's based upon. (N.B. getForecastInfo
+    // overwrites the year and run arguments with the previously saved values.)
+    StartForecastYear = settings.EndYear;
+    REMORA_QueryTimer forecastInfoTimer(queryProfiler(),"REMORA_UI::getRunSettings",
+                                        "SELECT nmfDatabase::getForecastInfo");
+    bool isForecastFound = m_DatabasePtr->getForecastInfo(
+                m_ProjectName,m_ModelName,m_ForecastName,
+                ForecastYearsPerRun,StartForecastYear,
+                settings.ForecastAlgorithm,settings.ForecastMinimizer,
+                settings.ForecastObjectiveCriterion,settings.ForecastScaling,
+                settings.GrowthForm,settings.HarvestForm,
+                settings.CompetitionForm,settings.PredationForm,
+                ForecastHarvestType,ForecastRunsPerForecast);
+    forecastInfoTimer.stop(isForecastFound ? 1 : 0,0);
+    if (! isForecastFound) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA::getRunSettings: No forecast found: " + m_ForecastName);
+        return false;
+    }
+    checkAlgorithmIdentifiersForMultiRun(settings.ForecastAlgorithm,settings.ForecastMinimizer,
+                                         settings.ForecastObjectiveCriterion,settings.ForecastScaling);
+
+    settings.SpeciesNames = getModelMetadata().SpeciesNames;
+    NumSpecies = int(settings.SpeciesNames.size());
+    if (NumSpecies > int(m_MovableLineCharts.size())) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA::getRunSettings: Found " + std::to_string(NumSpecies) +
+                         " species but only " + std::to_string(m_MovableLineCharts.size()) + " scale factor plots");
+        return false;
+    }
+
+    // Read the harvest scale factors now as the plots may only be accessed from the GUI thread
+    settings.ScaleFactors.assign(NumSpecies,std::vector<double>(NumYearsPerRun+1,0.0));
+    for (int speciesNum=0; speciesNum<NumSpecies; ++speciesNum) {
+        for (int yearNum=0; yearNum<=NumYearsPerRun; ++yearNum) {
+            settings.ScaleFactors[speciesNum][yearNum] = getScaleValueFromPlot(speciesNum,yearNum);
+        }
+    }
+
+    return true;
+}
+
 QList<QPointF>
 REMORA_UI::getScaleFactorPoints(const int& speciesNum)
 {
@@ -1346,6 +1933,12 @@ REMORA_UI::getScaleValueFromPlot(int speciesNum, int year)
     return scaleValue;
 }
 
+QString
+REMORA_UI::getSamplingMethod()
+{
+    return MModeSamplingCMB->currentText();
+}
+
 QString
 REMORA_UI::getScenarioName()
 {
@@ -1393,6 +1986,48 @@ REMORA_UI::getYLBLPlotScaleFactor(double scaleFactor)
     return scaleStr;
 }
 
+const REMORA_ModelMetadata&
+REMORA_UI::getModelMetadata()
+{
+    REMORA_QueryResult result;
+    REMORA_Database database(REMORA_Database::hostConnectionName(),m_Logger,queryProfiler());
+    std::string queryStr;
+
+    if (m_ModelMetadata.IsLoaded) {
+        return m_ModelMetadata;
+    }
+    database.setCallSite("REMORA_UI::getModelMetadata");
+
+    queryStr = "SELECT StartYear,RunLength from " +
+                nmfConstantsMSSPM::TableModels +
+               " WHERE ProjectName = '" + m_ProjectName +
+               "' AND ModelName = '"    + m_ModelName   + "'";
+    database.nmfQueryColumns(queryStr,{{"StartYear",REMORA_Column::Integer},
+                                       {"RunLength",REMORA_Column::Integer}},result);
+    if (result.NumRows != 0) {
+        m_ModelMetadata.IsYearRangeFound = true;
+        m_ModelMetadata.StartYear        = result.Integer["StartYear"][0];
+        m_ModelMetadata.EndYear          = m_ModelMetadata.StartYear + result.Integer["RunLength"][0];
+    }
+
+    REMORA_QueryTimer speciesTimer(queryProfiler(),"REMORA_UI::getModelMetadata",
+                                   "SELECT nmfDatabase::getSpecies");
+    m_DatabasePtr->getSpecies(m_Logger,m_ModelMetadata.SpeciesNames);
+    speciesTimer.stop(m_ModelMetadata.SpeciesNames.size(),0);
+
+    REMORA_QueryTimer algorithmTimer(queryProfiler(),"REMORA_UI::getModelMetadata",
+                                     "SELECT nmfDatabase::getAlgorithmIdentifiers");
+    m_ModelMetadata.IsModelFound = m_DatabasePtr->getAlgorithmIdentifiers(
+                m_TopLevelWidget,m_Logger,m_ProjectName,m_ModelName,
+                m_ModelMetadata.Algorithm,m_ModelMetadata.Minimizer,
+                m_ModelMetadata.ObjectiveCriterion,m_ModelMetadata.Scaling,
+                m_ModelMetadata.CompetitionForm,nmfConstantsMSSPM::DontShowPopupError);
+    algorithmTimer.stop(m_ModelMetadata.IsModelFound ? 1 : 0,0);
+
+    m_ModelMetadata.IsLoaded = true;
+    return m_ModelMetadata;
+}
+
 QWidget*
 REMORA_UI::getTopLevelWidget()
 {
@@ -1402,29 +2037,20 @@ REMORA_UI::getTopLevelWidget()
 void
 REMORA_UI::getYearRange(int& firstYear, int& lastYear)
 {
-    int StartYear = 0;
-    int NumYears  = 0;
-    std::vector<std::string> fields;
-    std::map<std::string, std::vector<std::string> > dataMap;
-    std::string queryStr;
+    const REMORA_ModelMetadata& metadata = getModelMetadata();
 
-    fields   = {"StartYear","RunLength"};
-    queryStr = "SELECT StartYear,RunLength from " +
-                nmfConstantsMSSPM::TableModels +
-               " WHERE ProjectName = '" + m_ProjectName +
-               "' AND ModelName = '"    + m_ModelName   + "'";
-    dataMap  = m_DatabasePtr->nmfQueryDatabase(queryStr, fields);
-    if (dataMap["RunLength"].size() != 0) {
-        StartYear = std::stoi(dataMap["StartYear"][0]);
-        NumYears  = std::stoi(dataMap["RunLength"][0]);
-        firstYear = StartYear;
-        lastYear  = firstYear + NumYears;
+    if (metadata.IsYearRangeFound) {
+        firstYear = metadata.StartYear;
+        lastYear  = metadata.EndYear;
     }
 }
 
 void
 REMORA_UI::grabImage(QPixmap& pm)
 {
+    if (m_DrawPlotTimer->isActive()) {
+        drawPlot();
+    }
     if (isSingleSpecies()) {
         // This will grab the Harvest Scale Factor plot as well as the Model plot(s)
         pm = MModeParentChartW->grab();
@@ -1445,31 +2071,77 @@ REMORA_UI::isAbsoluteBiomassPlotType()
 }
 
 bool
-REMORA_UI::isDeterministic()
+REMORA_UI::isAdaptive()
 {
-    return MModeDeterministicRB->isChecked();
+    return MModeAdaptiveCB->isChecked();
 }
 
 bool
-REMORA_UI::isFishingMortalityPlotType()
+REMORA_UI::isFanChart()
 {
-    return (MModeForecastPlotTypeCMB->currentText() == nmfConstantsMSSPM::OutputChartExploitation);
+    return MModeFanChartCB->isChecked();
 }
 
 bool
-REMORA_UI::isMultiPlot()
+REMORA_UI::isDeterministic()
 {
-    return (MModeMultiPlotTypePB->text() == "1+");
+    return MModeDeterministicRB->isChecked();
 }
 
 bool
-REMORA_UI::isMultiSpecies()
+REMORA_UI::isFishingMortalityPlotType()
 {
-    return MModePlotTypeMSRB->isChecked();
+    return (MModeForecastPlotTypeCMB->currentText() == nmfConstantsMSSPM::OutputChartExploitation);
 }
 
 bool
-REMORA_UI::isMSYBoxChecked()
+REMORA_UI::isForecastRedrawNeeded(const REMORA_ForecastData& data)
+{
+    int SpeciesNum = getSpeciesNum();
+
+    // The displayed forecast is only current if it came from the same forecast
+    if (data.RecomputedSpecies.empty() ||
+        ! m_ForecastData.matches(data.ProjectName,data.ModelName,data.ForecastName,
+                                 data.Algorithm,data.Minimizer,data.ObjectiveCriterion,data.Scaling,
+                                 data.NumSpecies,data.NumYearsPerRun,data.NumRunsRequested) ||
+        (m_ForecastData.BaseSeed != data.BaseSeed)) {
+        return true;
+    }
+    if (isSingleSpecies() && (SpeciesNum >= 0) && (SpeciesNum < int(data.RecomputedSpecies.size()))) {
+        return data.RecomputedSpecies[SpeciesNum];
+    }
+    return std::find(data.RecomputedSpecies.begin(),data.RecomputedSpecies.end(),true) != data.RecomputedSpecies.end();
+}
+
+bool
+REMORA_UI::isPreviewAvailable()
+{
+    int NumSpecies = getNumSpecies();
+
+    // The preview uses the parameters of the drawn forecast so it must be the current one
+    return (int(m_PreviewParameters.InitBiomass.size()) == NumSpecies) &&
+           (int(m_PreviewParameters.LastHarvest.size()) == NumSpecies) &&
+           (int(m_PreviewParameters.Harvest.size1())    == getNumYearsPerRun()+1) &&
+           (m_ForecastData.ProjectName  == m_ProjectName)  &&
+           (m_ForecastData.ModelName    == m_ModelName)    &&
+           (m_ForecastData.ForecastName == m_ForecastName) &&
+            m_ForecastData.isValid();
+}
+
+bool
+REMORA_UI::isMultiPlot()
+{
+    return (MModeMultiPlotTypePB->text() == "1+");
+}
+
+bool
+REMORA_UI::isMultiSpecies()
+{
+    return MModePlotTypeMSRB->isChecked();
+}
+
+bool
+REMORA_UI::isMSYBoxChecked()
 {
     return MModeShowMSYCB->isChecked();
 }
@@ -1498,6 +2170,29 @@ REMORA_UI::isYAxisLocked()
     return MModeYAxisLockCB->isChecked();
 }
 
+bool
+REMORA_UI::loadForecastBiomassMonteCarlo(const int& speciesNum)
+{
+    int NumSpecies = m_ForecastData.NumSpecies;
+    int species;
+    std::string errorMsg;
+    REMORA_Database database(REMORA_Database::hostConnectionName(),m_Logger,queryProfiler());
+    std::unique_ptr<REMORA_Storage> storage = REMORA_Storage::create(&database,m_Logger);
+
+    if (! storage->loadForecastBiomassMonteCarlo(getModelMetadata().SpeciesNames,speciesNum,
+                                                 m_ForecastData,nullptr,errorMsg)) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA::loadForecastBiomassMonteCarlo: " + errorMsg);
+        return false;
+    }
+
+    for (species=0; species<NumSpecies; ++species) {
+        if ((speciesNum == -1) || (species == speciesNum)) {
+            m_ForecastData.MonteCarloSpeciesLoaded[species] = true;
+        }
+    }
+    return true;
+}
+
 void
 REMORA_UI::loadForecastScenario(QString filename)
 {
@@ -1530,6 +2225,35 @@ REMORA_UI::loadForecastScenario(QString filename)
     MModeMaxScaleFactorSB->setValue(m_MaxYAxisValues[0]);
 }
 
+void
+REMORA_UI::loadPreviewParameters()
+{
+    std::string errorMsg;
+    std::vector<double> lastYearsCatchValues;
+    boost::numeric::ublas::matrix<double> harvest;
+    REMORA_RunSettings settings;
+    REMORA_ModelParameters parameters;
+
+    // Only attempted once per forecast as its model may not be supported
+    m_PreviewParameters   = REMORA_ModelParameters();
+    m_PreviewForecastName = m_ForecastName;
+
+    updateYearlyScaleFactorPoints();
+    if (! getRunSettings(settings)) {
+        return;
+    }
+    REMORA_Database database(REMORA_Database::hostConnectionName(),m_Logger,queryProfiler());
+    REMORA_ModelLoader loader(&database,m_Logger);
+    if (! loader.getForecastHarvest(settings,lastYearsCatchValues,harvest,errorMsg) ||
+        ! loader.loadModelParameters(settings,lastYearsCatchValues,harvest,parameters,errorMsg)) {
+        m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::loadPreviewParameters: No preview for forecast " +
+                         m_ForecastName + ": " + errorMsg);
+        return;
+    }
+    m_PreviewParameters   = parameters;
+    m_PreviewScaleFactors = settings.ScaleFactors;
+}
+
 QWidget*
 REMORA_UI::loadUI(QWidget* parentW)
 {
@@ -1544,6 +2268,12 @@ REMORA_UI::loadUI(QWidget* parentW)
     return widget;
 }
 
+REMORA_QueryProfiler*
+REMORA_UI::queryProfiler()
+{
+    return (m_IsQueryProfiling) ? &m_QueryProfiler : nullptr;
+}
+
 void
 REMORA_UI::removeMSYLines(
         QChart*             chart,
@@ -1562,6 +2292,19 @@ REMORA_UI::removeMSYLines(
     }
 }
 
+void
+REMORA_UI::rememberChartLayout(
+        QChart*            chart,
+        const std::string& layout)
+{
+    // Called after the forecast series are drawn and before any MSY lines
+    m_ChartLayouts[chart] = layout;
+    m_ChartDataSeries[chart].clear();
+    for (QAbstractSeries* series : chart->series()) {
+        m_ChartDataSeries[chart].append(series);
+    }
+}
+
 void
 REMORA_UI::removeAllMSYLines(QString type)
 {
@@ -1580,6 +2323,50 @@ REMORA_UI::removeAllMSYLines(QString type)
     }
 }
 
+void
+REMORA_UI::resizeChartGrid(const int& numCharts)
+{
+    int numColumns;
+    int numRows;
+
+    // The charts are kept between draws, so the grid is only laid out again if the number of species changed
+    if (m_Views.size() == numCharts) {
+        return;
+    }
+    for (QChartView* view : m_Views) {
+        m_GridLayt->removeWidget(view);
+    }
+    while (m_Views.size() > numCharts) {
+        m_ChartLayouts.erase(m_Charts.last());
+        m_ChartDataSeries.erase(m_Charts.last());
+        delete m_Views.takeLast(); // Also deletes its chart
+        m_Charts.removeLast();
+    }
+    while (m_Views.size() < numCharts) {
+        m_Charts.append(new QChart());
+        m_Views.append( new QChartView(m_Charts.last(),m_GridParent));
+    }
+    for (int row=0; row<m_GridLayt->rowCount(); ++row) {
+        m_GridLayt->setRowStretch(row,0);
+    }
+    for (int col=0; col<m_GridLayt->columnCount(); ++col) {
+        m_GridLayt->setColumnStretch(col,0);
+    }
+
+    // Smallest square grid that holds every chart, filled row by row
+    numColumns = int(std::ceil(std::sqrt(double(numCharts))));
+    numRows    = (numColumns == 0) ? 0 : (numCharts+numColumns-1)/numColumns;
+    for (int i=0; i<numCharts; ++i) {
+        m_GridLayt->addWidget(m_Views[i],i/numColumns,i%numColumns);
+    }
+    for (int row=0; row<numRows; ++row) {
+        m_GridLayt->setRowStretch(row,1);
+    }
+    for (int col=0; col<numColumns; ++col) {
+        m_GridLayt->setColumnStretch(col,1);
+    }
+}
+
 void
 REMORA_UI::resetControls()
 {
@@ -1605,36 +2392,6 @@ REMORA_UI::resetScenarioName()
     setScenarioName(scenarioName);
 }
 
-void
-REMORA_UI::saveForecastParameters()
-{
-    int startYear;
-    int endYear;
-    std::string errorMsg;
-
-    getYearRange(startYear,endYear);
-    int endForecastYear = endYear + m_NumYearsPerRun;
-
-    // Update forecast parameters in Forecasts file
-    std::string cmd =
-            "UPDATE " +
-             nmfConstantsMSSPM::TableForecasts +
-            " SET NumRuns = "      + std::to_string(getNumRunsPerForecast()) +
-            ", RunLength = "       + std::to_string(getNumYearsPerRun()) +
-            ", EndYear = "         + std::to_string(endForecastYear) +
-            ", IsDeterministic = " + std::to_string(isDeterministic()) +
-            "  WHERE ProjectName = '" + m_ProjectName +
-            "' AND ForecastName = '"  + m_ForecastName + "'";
-    errorMsg = m_DatabasePtr->nmfUpdateDatabase(cmd);
-    if (nmfUtilsQt::isAnError(errorMsg)) {
-        m_Logger->logMsg(nmfConstants::Error,"[Error 1] REMORA: DELETE error: " + errorMsg);
-        m_Logger->logMsg(nmfConstants::Error,"cmd: " + cmd);
-    }
-
-    // Update seed value in main
-    emit UpdateSeedValue(isDeterministic());
-}
-
 bool
 REMORA_UI::saveForecastScenario(QString filename)
 {
@@ -1654,10 +2411,14 @@ REMORA_UI::saveForecastScenario(QString filename)
         stream << "NumYearsPerRun:       " << getNumYearsPerRun()       << '\n';
         stream << "NumRunsPerForecast:   " << getNumRunsPerForecast()   << '\n';
         stream << "isDeterministic:      " << isDeterministic()         << '\n';
+        stream << "SamplingMethod:       " << getSamplingMethod()       << '\n';
+        stream << "isAdaptive:           " << isAdaptive()              << '\n';
+        stream << "ConvergenceTolerance: " << getConvergenceTolerance() << '\n';
         stream << "isSingleSpecies:      " << isSingleSpecies()         << '\n';
         stream << "isMultiPlot:          " << isMultiPlot()             << '\n';
         stream << "ForecastDataType:     " << getForecastPlotType()     << '\n';
         stream << "isMSYLineVisible:     " << isMSYBoxChecked()         << '\n';
+        stream << "isFanChart:           " << isFanChart()              << '\n';
         stream << "r_Uncertainty:        " << getGrowthUncertainty()    << '\n';
         stream << "K_Uncertainty:        " << getCarryingCapacityUncertainty()  << '\n';
         stream << "HarvestType:          " << getHarvestType()          << '\n';
@@ -1694,92 +2455,36 @@ REMORA_UI::readSettings()
     m_UseLastSingleRun = settings->value("LastRunTypeForecast",false).toBool();
     settings->endGroup();
 
+    settings->beginGroup("REMORA");
+    m_InsertChunkSize  = settings->value("InsertChunkSize",REMORA_Database::DefaultInsertChunkSize).toInt();
+    if (m_InsertChunkSize <= 0) {
+        m_InsertChunkSize = REMORA_Database::DefaultInsertChunkSize;
+    }
+    m_IsQueryProfiling = settings->value("QueryProfiling",false).toBool();
+    m_QueryProfileFile = settings->value("QueryProfileFile","").toString();
+    settings->endGroup();
+
     delete settings;
 }
 
-bool
-REMORA_UI::saveHarvestData()
+void
+REMORA_UI::reportQueryProfile(const std::string& title)
 {
-    int NumYears = 0;
-    int startYear;
-    int endYear;
-    int NumYearsInForecast = getNumYearsPerRun();
-    std::string cmd;
-    std::string errorMsg;
-    double finalValue;
-    std::vector<std::string> SpeNames;
-    std::string Algorithm;
-    std::string Minimizer;
-    std::string ObjectiveCriterion;
-    std::string Scaling;
-    std::string CompetitionForm;
-    std::vector<double> lastYearsCatchValues;
+    QString filename;
 
-    bool modelFound = m_DatabasePtr->getAlgorithmIdentifiers(
-                m_TopLevelWidget,m_Logger,m_ProjectName,m_ModelName,
-                Algorithm,Minimizer,ObjectiveCriterion,Scaling,
-                CompetitionForm,nmfConstantsMSSPM::DontShowPopupError);
-    if (! modelFound) {
-        m_Logger->logMsg(nmfConstants::Error,"REMORA::saveHarvestData: No models found");
-        return false;
-    }
-    checkAlgorithmIdentifiersForMultiRun(Algorithm,Minimizer,ObjectiveCriterion,Scaling);
-
-    getYearRange(startYear,endYear);
-    NumYears = endYear-startYear+1;
-
-    m_DatabasePtr->getSpecies(m_Logger,SpeNames);
-
-    cmd = "DELETE FROM " +
-           m_HarvestType +
-          " WHERE ProjectName = '" + m_ProjectName +
-          "' AND ModelName = '"    + m_ModelName +
-          "' AND ForecastName = '" + m_ForecastName + "'";
-    errorMsg = m_DatabasePtr->nmfUpdateDatabase(cmd);
-    if (nmfUtilsQt::isAnError(errorMsg)) {
-        m_Logger->logMsg(nmfConstants::Error,"REMORA::saveHarvestData: DELETE error: " + errorMsg);
-        m_Logger->logMsg(nmfConstants::Error,"cmd: " + cmd);
-        QMessageBox::warning(m_TopLevelWidget, "Error",
-                             "\nError(1) REMORA_UI::saveHarvestData:  Couldn't delete all records from " +
-                             QString::fromStdString(m_HarvestType) + " table.\n",
-                             QMessageBox::Ok);
-        QApplication::restoreOverrideCursor();
-        return false;
+    if (! m_IsQueryProfiling || m_QueryProfiler.isEmpty()) {
+        return;
     }
+    m_QueryProfiler.writeToLog(m_Logger,title);
 
-    bool ok = getLastYearsCatchValues(NumYears,lastYearsCatchValues);
-    if (! ok) {
-        return false;
-    }
-    cmd = "INSERT INTO " +
-           m_HarvestType +
-          " (ProjectName,ModelName,ForecastName,Algorithm,Minimizer,ObjectiveCriterion,Scaling,SpeName,Year,Value) VALUES ";
-    for (unsigned speciesNum=0; speciesNum<SpeNames.size(); ++speciesNum) { // Species
-        for (int yearNum=0; yearNum<=NumYearsInForecast; ++yearNum) { // Time
-            finalValue = getScaleValueFromPlot(speciesNum,yearNum) * lastYearsCatchValues[speciesNum];
-            cmd += "('"   + m_ProjectName +
-                    "','" + m_ModelName +
-                    "','" + m_ForecastName +
-                    "','" + Algorithm +
-                    "','" + Minimizer +
-                    "','" + ObjectiveCriterion +
-                    "','" + Scaling +
-                    "','" + SpeNames[speciesNum] +
-                    "',"  + std::to_string(yearNum) +
-                    ", "  + std::to_string(finalValue) + "),";
+    // A relative file name is kept with the scenarios
+    if (! m_QueryProfileFile.isEmpty()) {
+        filename = QDir(m_RemoraScenarioDir).filePath(m_QueryProfileFile);
+        if (! m_QueryProfiler.writeJson(filename,title)) {
+            m_Logger->logMsg(nmfConstants::Warning,"REMORA_UI::reportQueryProfile: Couldn't write " +
+                             filename.toStdString());
         }
     }
-//std::cout << "ccmd:\n" << cmd << std::endl;
-    cmd = cmd.substr(0,cmd.size()-1);
-
-    errorMsg = m_DatabasePtr->nmfUpdateDatabase(cmd);
-    if (nmfUtilsQt::isAnError(errorMsg)) {
-        m_Logger->logMsg(nmfConstants::Error,"REMORA::saveHarvestData: Write table error: " + errorMsg);
-        m_Logger->logMsg(nmfConstants::Error,"cmd: " + cmd);
-        QApplication::restoreOverrideCursor();
-        return false;
-    }
-    return true;
 }
 
 void
@@ -1789,103 +2494,12 @@ REMORA_UI::saveOutputBiomassData()
 }
 
 void
-REMORA_UI::saveUncertaintyParameters()
+REMORA_UI::scheduleDrawPlot()
 {
-    std::string cmd;
-    std::string errorMsg;
-    std::vector<std::string> SpeNames;
-    std::string CompetitionForm;
-
-    for (int i = 0; i < MModeSpeciesCMB->count(); i++)
-    {
-        SpeNames.push_back(MModeSpeciesCMB->itemText(i).toStdString());
-    }
-
-    std::string ForecastName =  m_ForecastName;
-    std::vector<std::string> fields = {"ForecastName","Algorithm","Minimizer","ObjectiveCriterion","Scaling"};
-    std::string queryStr = "SELECT ForecastName,Algorithm,Minimizer,ObjectiveCriterion,Scaling FROM " +
-                            nmfConstantsMSSPM::TableForecasts +
-                           " WHERE ProjectName = '" + m_ProjectName +
-                           "' AND ForecastName = '" + ForecastName  + "'";
-    std::map<std::string, std::vector<std::string> > dataMap = m_DatabasePtr->nmfQueryDatabase(queryStr, fields);
-
-    int NumRecords = dataMap["ForecastName"].size();
-    if (NumRecords == 0) {
-        std::cout << "Error: No records found." << std::endl;
-        std::cout << queryStr << std::endl;
-        return;
-    }
-
-    std::string Algorithm          = dataMap["Algorithm"][0];
-    std::string Minimizer          = dataMap["Minimizer"][0];
-    std::string ObjectiveCriterion = dataMap["ObjectiveCriterion"][0];
-    std::string Scaling            = dataMap["Scaling"][0];
-    std::string InitBiomass        = "0.0"; // May need to supply a dial widget for this later
-    std::string GrowthRate         = std::to_string(MModeRParamLE->text().toDouble()/100.0);
-    std::string CarryingCapacity   = std::to_string(MModeKParamLE->text().toDouble()/100.0);
-    std::string Harvest            = std::to_string(MModeHParamLE->text().toDouble()/100.0);
-    std::string GrowthRateShape    = "0";
-    std::string Catchability       = "0";
-    // Clear previous entry in ForecastUncertainty table
-    cmd = "DELETE FROM " +
-           nmfConstantsMSSPM::TableForecastUncertainty +
-          " WHERE ProjectName = '" + m_ProjectName +
-          "' AND ModelName = '"    + m_ModelName +
-          "' AND ForecastName = '" + ForecastName + "'";
-    errorMsg = m_DatabasePtr->nmfUpdateDatabase(cmd);
-    if (nmfUtilsQt::isAnError(errorMsg)) {
-        m_Logger->logMsg(nmfConstants::Error,"REMORA::callback_SavePB: DELETE error: " + errorMsg);
-        m_Logger->logMsg(nmfConstants::Error,"cmd: " + cmd);
-        QMessageBox::warning(MModeWindowWidget, "Error",
-                             "\nError(1) in REMORA_UI::saveUncertaintyParameters:  Couldn't delete all records from ForecastUncertainty table.\n",
-                             QMessageBox::Ok);
-        return;
-    }
-
-//  checkAlgorithmIdentifiersForMultiRun(Algorithm,Minimizer,ObjectiveCriterion,Scaling);
-
-    QStringList ParameterNames = {"InitBiomass","GrowthRate","GrowthRateShape","CarryingCapacity","Catchability","Harvest",
-                                  "CompetitionAlpha","CompetitionBetaSpecies","CompetitionBetaGuilds","CompetitionBetaGuildsGuilds",
-                                  "PredationRho","PredationHandling","PredationExponent","SurveyQ",
-                                  "GrowthRateCovCoeff","CarryingCapacityCovCoeff","CatchabilityCovCoeff","SurveyQCovCoeff"};
-    cmd  = "INSERT INTO " + nmfConstantsMSSPM::TableForecastUncertainty + " (" ;
-    cmd += "SpeName,ProjectName,ModelName,ForecastName,Algorithm,Minimizer,ObjectiveCriterion,Scaling,";
-    cmd +=  ParameterNames.join(",").toStdString();
-    cmd += ") VALUES ";
-    for (unsigned i = 0; i < SpeNames.size(); ++i) { // Species
-            cmd += "('"   + SpeNames[i] +
-                    "','" + m_ProjectName +
-                    "','" + m_ModelName +
-                    "','" + ForecastName +
-                    "','" + Algorithm +
-                    "','" + Minimizer +
-                    "','" + ObjectiveCriterion +
-                    "','" + Scaling +
-                    "',"  + InitBiomass +
-                    ","   + GrowthRate +
-                    ","   + GrowthRateShape +   // 0 for now
-                    ","   + CarryingCapacity +
-                    ","   + Catchability +      // 0 for now
-                    ","   + Harvest;
-            // N.B. Next line will need to be modified once more parameters are used in the ForecastUncertainty calculations
-            for (int i=0;i<ParameterNames.size()-6;++i) { //-6 because we are supplying data for: InitBiomass, GrowthRate, GrowthRateShape, CarryingCapacity, Catchability, and Harvest
-                cmd += ", 0";
-            }
-            cmd += "),";
-
-            //Ask about the number of columns in the parameter count
-            //ERROR: REMORA::callback_SavePB: Write table error: Column count doesn't match value count at row 1 QMYSQL: Unable to execute query
-    }
-    cmd = cmd.substr(0,cmd.size()-1);
-
-    errorMsg = m_DatabasePtr->nmfUpdateDatabase(cmd);
-    if (nmfUtilsQt::isAnError(errorMsg)) {
-        m_Logger->logMsg(nmfConstants::Error,"REMORA::callback_SavePB: Write table error: " + errorMsg);
-        m_Logger->logMsg(nmfConstants::Error,"cmd: " + cmd);
-        QMessageBox::warning(MModeWindowWidget, "Error",
-                             "\nError(2) in REMORA_UI::saveUncertaintyParameters.  Check that all cells are populated.\n",
-                             QMessageBox::Ok);
-        return;
+    // The pending redraw draws whatever the controls are set to by then
+    ++m_NumDrawsRequested;
+    if (! m_DrawPlotTimer->isActive()) {
+        m_DrawPlotTimer->start();
     }
 }
 
@@ -1909,6 +2523,18 @@ REMORA_UI::setAScaleFactorPoint(QString arg1)
     ++m_IndexScaleFactorPoint;
 }
 
+void
+REMORA_UI::setAdaptive(QString isChecked)
+{
+    MModeAdaptiveCB->setChecked(isChecked == "1");
+}
+
+void
+REMORA_UI::setConvergenceTolerance(QString tolerance)
+{
+    MModeConvergenceToleranceSB->setValue(tolerance.toDouble());
+}
+
 void
 REMORA_UI::setDeterministic(QString isChecked)
 {
@@ -1916,6 +2542,14 @@ REMORA_UI::setDeterministic(QString isChecked)
    MModeStochasticRB->setChecked(   isChecked == "0");
 }
 
+void
+REMORA_UI::setFanChart(QString isChecked)
+{
+    MModeFanChartCB->blockSignals(true);
+    MModeFanChartCB->setChecked(isChecked == "1");
+    MModeFanChartCB->blockSignals(false);
+}
+
 std::string
 REMORA_UI::getForecastName()
 {
@@ -2034,6 +2668,47 @@ void
 REMORA_UI::setProjectName(const std::string& projectName)
 {
     m_ProjectName = projectName;
+    m_PreviewParameters = REMORA_ModelParameters();
+    m_PreviewForecastName.clear();
+    invalidateModelMetadata();
+    invalidateForecastInfo();
+    clearMSYCache();
+}
+
+void
+REMORA_UI::setRunInProgress(bool inProgress)
+{
+    m_RunInProgress = inProgress;
+
+    // The run saves the forecast again and may follow a new estimation of the model
+    invalidateForecastInfo();
+    if (inProgress) {
+        clearMSYCache();
+    }
+
+    MModeForecastRunPB->setEnabled(   ! inProgress);
+    MModeForecastLoadPB->setEnabled(  ! inProgress);
+    MModeForecastSavePB->setEnabled(  ! inProgress);
+    MModeForecastDelPB->setEnabled(   ! inProgress);
+    MModeForecastSweepPB->setEnabled( ! inProgress);
+    MModeForecastCancelPB->setEnabled(  inProgress);
+    MModeForecastCancelPB->setVisible(  inProgress);
+    MModeRunProgressBar->setVisible(    inProgress);
+
+    // Don't allow the plot controls to redraw while the forecast data are being replaced
+    if (inProgress) {
+        m_WidgetsEnabledBeforeRun = MModeForecastPlotTypeCMB->isEnabled();
+        MModeRunProgressBar->setValue(0);
+        enableWidgets(false);
+    } else {
+        enableWidgets(m_WidgetsEnabledBeforeRun);
+    }
+}
+
+void
+REMORA_UI::setSamplingMethod(QString method)
+{
+    MModeSamplingCMB->setCurrentText(method);
 }
 
 void
@@ -2071,6 +2746,9 @@ REMORA_UI::setSpeciesList(const QStringList& speciesList)
     MModeSpeciesCMB->clear();
     MModeSpeciesCMB->addItems(speciesList);
     MModeSpeciesCMB->blockSignals(false);
+
+    // The species are part of the cached model metadata
+    invalidateModelMetadata();
 }
 
 void
@@ -2083,6 +2761,19 @@ REMORA_UI::initializeScaleFactors()
     MModePlotScaleFactorCMB->setToolTip("Sets the scale of the y-axis");
     MModePlotScaleFactorCMB->setStatusTip("Sets the scale of the y-axis");
 }
+
+void
+REMORA_UI::invalidateForecastInfo()
+{
+    m_ForecastInfo = REMORA_ForecastInfo();
+}
+
+void
+REMORA_UI::invalidateModelMetadata()
+{
+    m_ModelMetadata = REMORA_ModelMetadata();
+}
+
 void
 REMORA_UI::setUncertaintyCarryingCapacity(QString arg1)
 {
@@ -2119,22 +2810,34 @@ REMORA_UI::setupConnections()
             this,                     SLOT(callback_UncertaintyHarvestParameterDL(int)));
     connect(MModeForecastRunPB,       SIGNAL(clicked()),
             this,                     SLOT(callback_RunPB()));
+    connect(MModeForecastCancelPB,    SIGNAL(clicked()),
+            this,                     SLOT(callback_CancelPB()));
     connect(MModeForecastLoadPB,      SIGNAL(clicked()),
             this,                     SLOT(callback_LoadPB()));
     connect(MModeForecastSavePB,      SIGNAL(clicked()),
             this,                     SLOT(callback_SavePB()));
     connect(MModeForecastDelPB,       SIGNAL(clicked()),
             this,                     SLOT(callback_DelPB()));
+    connect(MModeForecastSweepPB,     SIGNAL(clicked()),
+            this,                     SLOT(callback_SweepPB()));
     connect(MModeShowMSYCB,           SIGNAL(toggled(bool)),
             this,                     SLOT(callback_MSYCB(bool)));
     connect(MModePctMSYDL,            SIGNAL(valueChanged(int)),
             this,                     SLOT(callback_PctMSYDL(int)));
     connect(MModePctMSYCB,            SIGNAL(toggled(bool)),
             this,                     SLOT(callback_PctMSYCB(bool)));
+    connect(MModeFanChartCB,          SIGNAL(toggled(bool)),
+            this,                     SLOT(callback_FanChartCB(bool)));
     connect(MModeDeterministicRB,     SIGNAL(clicked(bool)),
             this,                     SLOT(callback_DeterministicRB(bool)));
     connect(MModeStochasticRB,        SIGNAL(clicked(bool)),
             this,                     SLOT(callback_StochasticRB(bool)));
+    connect(MModeSamplingCMB,         SIGNAL(currentTextChanged(QString)),
+            this,                     SLOT(callback_SamplingCMB(QString)));
+    connect(MModeAdaptiveCB,          SIGNAL(toggled(bool)),
+            this,                     SLOT(callback_AdaptiveCB(bool)));
+    connect(MModeConvergenceToleranceSB, SIGNAL(valueChanged(double)),
+            this,                     SLOT(callback_ConvergenceToleranceSB(double)));
     connect(MModePlotTypeSSRB,        SIGNAL(clicked(bool)),
             this,                     SLOT(callback_SingleSpeciesRB(bool)));
     connect(MModePlotTypeMSRB,        SIGNAL(clicked(bool)),
@@ -2155,6 +2858,54 @@ REMORA_UI::setupConnections()
             this,                     SLOT(callback_PlotTypeScaleFactorCMB()));
 }
 
+void
+REMORA_UI::setupRunThread()
+{
+    qRegisterMetaType<REMORA_RunSettings>("REMORA_RunSettings");
+    qRegisterMetaType<REMORA_ForecastData>("REMORA_ForecastData");
+    qRegisterMetaType<REMORA_RunBatch>("REMORA_RunBatch");
+    qRegisterMetaType<REMORA_ModelParameters>("REMORA_ModelParameters");
+    qRegisterMetaType<REMORA_SweepSettings>("REMORA_SweepSettings");
+    qRegisterMetaType<REMORA_SweepResult>("REMORA_SweepResult");
+
+    m_RunThread = new QThread(this);
+    m_RunWorker = new REMORA_RunWorker(m_Logger);
+    m_RunWorker->moveToThread(m_RunThread);
+
+    connect(m_RunThread, SIGNAL(finished()),
+            m_RunWorker, SLOT(deleteLater()));
+    connect(this,        SIGNAL(StartSaveForecastConfiguration(REMORA_RunSettings)),
+            m_RunWorker, SLOT(callback_SaveForecastConfiguration(REMORA_RunSettings)));
+    connect(this,        SIGNAL(StartLoadForecastData(REMORA_RunSettings)),
+            m_RunWorker, SLOT(callback_LoadForecastData(REMORA_RunSettings)));
+    connect(m_RunWorker, SIGNAL(ForecastConfigurationSaved(REMORA_RunSettings)),
+            this,        SLOT(callback_ForecastConfigurationSaved(REMORA_RunSettings)));
+    connect(m_RunWorker, SIGNAL(RunProgress(int,int,QString)),
+            this,        SLOT(callback_RunProgress(int,int,QString)));
+    connect(m_RunWorker, SIGNAL(RunBatchSimulated(REMORA_RunBatch)),
+            this,        SLOT(callback_RunBatchSimulated(REMORA_RunBatch)));
+    connect(m_RunWorker, SIGNAL(RunFinished(REMORA_ForecastData)),
+            this,        SLOT(callback_RunFinished(REMORA_ForecastData)));
+    connect(m_RunWorker, SIGNAL(RunFailed(QString)),
+            this,        SLOT(callback_RunFailed(QString)));
+    connect(m_RunWorker, SIGNAL(RunCancelled()),
+            this,        SLOT(callback_RunCancelled()));
+    connect(m_RunWorker, SIGNAL(ModelParametersLoaded(REMORA_ModelParameters)),
+            this,        SLOT(callback_ModelParametersLoaded(REMORA_ModelParameters)));
+    connect(this,        SIGNAL(StartSweep(REMORA_RunSettings,REMORA_SweepSettings)),
+            m_RunWorker, SLOT(callback_RunSweep(REMORA_RunSettings,REMORA_SweepSettings)));
+    connect(m_RunWorker, SIGNAL(SweepProgress(int)),
+            this,        SLOT(callback_SweepProgress(int)));
+    connect(m_RunWorker, SIGNAL(SweepFinished(REMORA_SweepResult)),
+            this,        SLOT(callback_SweepFinished(REMORA_SweepResult)));
+    connect(m_RunWorker, SIGNAL(SweepFailed(QString)),
+            this,        SLOT(callback_SweepFailed(QString)));
+    connect(m_RunWorker, SIGNAL(SweepCancelled()),
+            this,        SLOT(callback_SweepCancelled()));
+
+    m_RunThread->start();
+}
+
 void
 REMORA_UI::setupMovableLineCharts(const QStringList& SpeciesList)
 {
@@ -2197,6 +2948,28 @@ REMORA_UI::setupMovableLineCharts(const QStringList& SpeciesList)
     }
 }
 
+void
+REMORA_UI::showRunsUsed(const REMORA_ForecastData& data)
+{
+    QString msg;
+
+    if (! isAdaptive() || (data.NumRunsRequested <= 0)) {
+        MModeAdaptiveRunsLB->clear();
+        return;
+    }
+    if (m_IsHostSimulated) {
+        msg = "Adaptive mode unavailable for these model forms, used all " +
+              QString::number(data.NumRunsPerForecast) + " runs";
+    } else if (data.IsConverged) {
+        msg = "Converged in " + QString::number(data.NumRunsPerForecast) + " of " +
+              QString::number(data.NumRunsRequested) + " runs";
+    } else {
+        msg = "Not converged in " + QString::number(data.NumRunsPerForecast) + " runs";
+    }
+    MModeAdaptiveRunsLB->setText(msg);
+    m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::showRunsUsed: " + msg.toStdString());
+}
+
 void
 REMORA_UI::resetXAxis()
 {
@@ -2231,6 +3004,118 @@ REMORA_UI::resetYAxis()
     }
 }
 
+bool
+REMORA_UI::updateChartInPlace(
+        QChart*            chart,
+        const std::string& layout,
+        const boost::numeric::ublas::matrix<double>& ChartData,
+        const QStringList& SeriesNames,
+        const int&         StartForecastYear,
+        const double&      YMinVal,
+        const double&      YMaxVal,
+        const std::string& MainTitle)
+{
+    int NumYears   = ChartData.size1();
+    int NumColumns = 0;
+    int col        = 0;
+    double maxValue = YMinVal;
+    QAreaSeries* area;
+    QXYSeries*   line;
+
+    if ((m_ChartLayouts.find(chart) == m_ChartLayouts.end()) || (m_ChartLayouts[chart] != layout)) {
+        return false;
+    }
+
+    // The forecast series must all still be the chart's first series. Area series take two
+    // columns (their lower and upper lines) and lines one.
+    const QList<QPointer<QAbstractSeries> >& dataSeries = m_ChartDataSeries[chart];
+    QList<QAbstractSeries*> chartSeries = chart->series();
+    if (dataSeries.isEmpty() || (chartSeries.size() < dataSeries.size())) {
+        return false;
+    }
+    for (int i=0; i<dataSeries.size(); ++i) {
+        if (dataSeries[i].isNull() || (dataSeries[i].data() != chartSeries[i])) {
+            return false;
+        }
+        if (qobject_cast<QAreaSeries*>(dataSeries[i].data())) {
+            NumColumns += 2;
+        } else if (qobject_cast<QXYSeries*>(dataSeries[i].data())) {
+            NumColumns += 1;
+        } else {
+            return false;
+        }
+    }
+    if (NumColumns != int(ChartData.size2())) {
+        return false;
+    }
+
+    // Gaps split a line into several series, so those are drawn from scratch
+    for (int time=0; time<NumYears; ++time) {
+        for (int j=0; j<NumColumns; ++j) {
+            if (ChartData(time,j) < 0) {
+                return false;
+            }
+            maxValue = std::max(maxValue,ChartData(time,j));
+        }
+    }
+
+    auto columnPoints = [&](const int& column) {
+        QVector<QPointF> points(NumYears);
+        for (int time=0; time<NumYears; ++time) {
+            points[time] = QPointF(StartForecastYear+time,ChartData(time,column));
+        }
+        return points;
+    };
+    for (int i=0; i<dataSeries.size(); ++i) {
+        area = qobject_cast<QAreaSeries*>(dataSeries[i].data());
+        if (area) {
+            area->lowerSeries()->replace(columnPoints(col++));
+            area->upperSeries()->replace(columnPoints(col++));
+        } else {
+            line = qobject_cast<QXYSeries*>(dataSeries[i].data());
+            line->replace(columnPoints(col++));
+            if ((i < SeriesNames.size()) && ! SeriesNames[i].isEmpty()) {
+                line->setName(SeriesNames[i]);
+            }
+        }
+    }
+
+    chart->setTitle(QString::fromStdString(MainTitle));
+    for (QAbstractAxis* axis : chart->axes(Qt::Vertical)) {
+        QValueAxis* axisY = qobject_cast<QValueAxis*>(axis);
+        if (axisY == nullptr) {
+            continue;
+        }
+        if (YMaxVal == nmfConstants::NoValueDouble) {
+            axisY->setRange(YMinVal,maxValue);
+            axisY->applyNiceNumbers();
+        } else {
+            axisY->setRange(YMinVal,YMaxVal);
+        }
+    }
+    return true;
+}
+
+bool
+REMORA_UI::updatePreviewScaleFactors()
+{
+    int SpeciesNum     = getSpeciesNum();
+    int NumYearsPerRun = getNumYearsPerRun();
+    std::vector<double> ScaleFactors(NumYearsPerRun+1);
+
+    if ((SpeciesNum < 0) || (SpeciesNum >= int(m_PreviewScaleFactors.size()))) {
+        return false;
+    }
+    for (int time=0; time<=NumYearsPerRun; ++time) {
+        ScaleFactors[time] = getScaleValueFromPlot(SpeciesNum,time);
+    }
+    if (ScaleFactors == m_PreviewScaleFactors[SpeciesNum]) {
+        return false;
+    }
+    m_PreviewScaleFactors[SpeciesNum] = ScaleFactors;
+    return true;
+}
+
 void
 REMORA_UI::updateYearlyScaleFactorPoints()
 {
@@ -2248,6 +3133,30 @@ REMORA_UI::updateYearlyScaleFactorPoints()
 
 
 
+void
+REMORA_UI::callback_AdaptiveCB(bool isChecked)
+{
+    MModeConvergenceToleranceSB->setEnabled(isChecked);
+    MModeAdaptiveRunsLB->clear();
+    setScenarioChanged(true);
+}
+
+void
+REMORA_UI::callback_CancelPB()
+{
+    m_RunWorker->cancel();
+    MModeForecastCancelPB->setEnabled(false);
+    MModeRunProgressBar->setFormat("Cancelling...");
+    m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_CancelPB: Cancel requested");
+}
+
+void
+REMORA_UI::callback_ConvergenceToleranceSB(double value)
+{
+    (void)value;
+    setScenarioChanged(true);
+}
+
 void
 REMORA_UI::callback_DelPB()
 {
@@ -2288,6 +3197,37 @@ REMORA_UI::callback_DeterministicRB(bool pressed)
     setScenarioChanged(true);
 }
 
+void
+REMORA_UI::callback_FanChartCB(bool isChecked)
+{
+    (void)isChecked;
+    scheduleDrawPlot();
+    setScenarioChanged(true);
+}
+
+void
+REMORA_UI::callback_ForecastConfigurationSaved(REMORA_RunSettings settings)
+{
+    if (! m_RunInProgress) {
+        return;
+    }
+
+    // The host application simulates the forecast runs on the GUI thread
+    callback_RunProgress(REMORA_RunWorker::PhaseSimulate,
+                         REMORA_RunWorker::overallPercent(REMORA_RunWorker::PhaseSimulate,0),
+                         REMORA_RunWorker::phaseDescription(REMORA_RunWorker::PhaseSimulate));
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_RunPB saveOutputBiomassData");
+    saveOutputBiomassData();
+    QApplication::restoreOverrideCursor();
+
+    // The previous forecast data are no longer current
+    m_ForecastData.clear();
+    m_IsHostSimulated = true;
+
+    emit StartLoadForecastData(settings);
+}
+
 void
 REMORA_UI::callback_ForecastPlotTypeCMB(QString type)
 {
@@ -2310,7 +3250,7 @@ REMORA_UI::callback_ForecastPlotTypeCMB(QString type)
         MModeShowMSYCB->setEnabled(showMSYCheckboxes);
         MModePctMSYCB->setEnabled(showMSYCheckboxes);
     }
-    drawPlot();
+    scheduleDrawPlot();
     setScenarioChanged(true);
 }
 
@@ -2348,16 +3288,43 @@ REMORA_UI::callback_MaxScaleFactorSB(int newValue)
     setScenarioChanged(true);
 }
 
+void
+REMORA_UI::callback_ModelParametersLoaded(REMORA_ModelParameters parameters)
+{
+    m_PreviewParameters   = parameters;
+    m_PreviewForecastName = m_ForecastName;
+}
+
 void
 REMORA_UI::callback_MouseMoved(QMouseEvent* event)
 {
     emit MouseMoved(event);
+
+    // A point may be being dragged, so schedule a preview if one isn't already pending
+    if ((event->buttons() & Qt::LeftButton) && ! m_PreviewTimer->isActive()) {
+        m_PreviewTimer->start();
+    }
 }
 
 void
 REMORA_UI::callback_MouseReleased(QMouseEvent* event)
 {
     emit MouseReleased(event);
+
+    // Replace the preview with a full run now that the user has let go of the point. A drag
+    // shorter than the preview interval is only seen by the pending tick, so check it here.
+    if (m_PreviewTimer->isActive()) {
+        m_PreviewTimer->stop();
+        m_PreviewActive = updatePreviewScaleFactors() || m_PreviewActive;
+    }
+    if (m_PreviewActive) {
+        m_PreviewActive = false;
+        if (m_RunInProgress) {
+            m_RunQueued = true;
+        } else {
+            callback_RunPB();
+        }
+    }
 }
 
 void
@@ -2387,7 +3354,7 @@ REMORA_UI::callback_MultiPlotTypePB()
         MModePctMSYCB->setChecked(false);
         MModeYAxisLockCB->setEnabled(true);
     }
-    drawPlot();
+    scheduleDrawPlot();
     setScenarioChanged(true);
 }
 
@@ -2403,7 +3370,7 @@ REMORA_UI::callback_MultiSpeciesRB(bool pressed)
         MModeShowMSYCB->setChecked(false);
         MModePctMSYCB->setChecked(false);
     }
-    drawPlot();
+    scheduleDrawPlot();
     setScenarioChanged(true);
 }
 
@@ -2430,43 +3397,316 @@ REMORA_UI::callback_PctMSYDL(int value)
     setScenarioChanged(true);
 }
 
+void
+REMORA_UI::callback_DrawPlotTimer()
+{
+    int numDrawsElided = m_NumDrawsRequested-1;
+
+    m_NumDrawsRequested = 0;
+    if (numDrawsElided > 0) {
+        m_NumDrawsElided += numDrawsElided;
+        m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_DrawPlotTimer: Drew once for " +
+                         std::to_string(numDrawsElided+1) + " redraw requests (" +
+                         std::to_string(m_NumDrawsElided) + " elided in total)");
+    }
+    drawPlot();
+}
+
+void
+REMORA_UI::callback_PreviewTimer()
+{
+    int SpeciesNum = getSpeciesNum();
+
+    // Only preview if the current species' scale factors have actually changed
+    if (! updatePreviewScaleFactors()) {
+        return;
+    }
+    m_PreviewActive = true;
+
+    // The preview would be replaced by the run's results anyway
+    if (! m_RunInProgress && isPreviewAvailable()) {
+        drawForecastPreview(SpeciesNum);
+    }
+}
+
 void
 REMORA_UI::callback_RunPB()
 {
-    bool ok;
     QString msg;
-    QApplication::setOverrideCursor(Qt::WaitCursor);
+    REMORA_RunSettings settings;
+
+    if (m_RunInProgress) {
+        return;
+    }
+
+    // Everything getRunSettings copies from the settings file must be current
+    readSettings();
+
     m_MainWindowWidth  = m_MainWindow->width();
     m_MainWindowHeight = m_MainWindow->height();
     m_FrameWidth       = MModeFrame->width();
     m_FrameHeight      = MModeFrame->height();
 
     m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_RunPB start");
+    m_QueryProfiler.clear();
 
     updateYearlyScaleFactorPoints();
-    m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_RunPB saveForecastParameters");
-    saveForecastParameters();
-    m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_RunPB saveUncertaintyParameters");
-    saveUncertaintyParameters();
-    m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_RunPB saveHarvestData");
-    ok = saveHarvestData();
-    if (! ok) {
-        QApplication::restoreOverrideCursor();
+    if (! getRunSettings(settings)) {
         msg = "\nREMORA run failed. Please check log for error messages.\n";
         QMessageBox::warning(m_TopLevelWidget, "Warning", msg, QMessageBox::Ok);
         return;
     }
-    m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_RunPB saveOutputBiomassData");
-    saveOutputBiomassData();
 
-    m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_RunPB drawPlot");
-    drawPlot();
+    // Update seed value in main
+    emit UpdateSeedValue(isDeterministic());
 
-    enableWidgets(true);
+    m_PreviewScaleFactors = settings.ScaleFactors;
+    m_PreviewParameters   = REMORA_ModelParameters();
+    m_PreviewForecastName.clear();
+    m_IsHostSimulated     = false;
+    m_RunQueued = false;
 
-    QApplication::restoreOverrideCursor();
+    // The run replaces the forecast's store file, which can't be replaced while it's mapped
+    m_ForecastData.BiomassTensor.detach();
+
+    // The remaining phases are performed by the run worker
+    setRunInProgress(true);
+    m_RunWorker->clearCancel();
+    emit StartSaveForecastConfiguration(settings);
+}
+
+void
+REMORA_UI::callback_RunBatchSimulated(REMORA_RunBatch batch)
+{
+    bool isFishingMortality = isFishingMortalityPlotType();
+    bool isRelativeBiomass  = isRelativeBiomassPlotType();
+    int StartYear;
+    int EndYear;
+    int SpeciesNum          = getSpeciesNum();
+    int Theme               = 0;
+    int NumLines            = int(batch.BiomassMonteCarlo.size());
+    double YMinVal          = 0;
+    double YMaxVal          = nmfConstants::NoValueDouble;
+    double ScaleVal         = getPlotScaleFactor();
+    double brightnessFactor = 0.2;
+    double biomass;
+    double value;
+    double time0Value;
+    std::string ChartType   = "Line";
+    std::string LineStyle   = "SolidLine";
+    std::string MainTitle   = "Forecast Run for Species: " + getCurrentSpecies();
+    std::string XLabel      = "Year";
+    std::string YLabel      = "Biomass (" + getYLBLPlotScaleFactor(ScaleVal).toStdString() + "metric tons)";
+    QStringList RowLabelsForBars;
+    QStringList ColumnLabelsForLegend;
+    QLineSeries* series;
+    QPen pen;
+    boost::numeric::ublas::matrix<double> ChartLine;
+    QColor dimmedColor = QColor(255-brightnessFactor*255,
+                                255-brightnessFactor*255,
+                                255-brightnessFactor*255);
+
+    // Runs are only streamed onto the single species chart when drawn one line per run. Anything
+    // else that redraws the chart during the run stops the streaming until the run finishes.
+    if (! m_RunInProgress || ! isSingleSpecies() || isFanChart() ||
+        (batch.ProjectName  != m_ProjectName)  ||
+        (batch.ModelName    != m_ModelName)    ||
+        (batch.ForecastName != m_ForecastName) ||
+        (SpeciesNum < 0) || (SpeciesNum >= batch.NumSpecies)) {
+        m_StreamedNoUncertaintySeries = nullptr;
+        return;
+    }
+    if ((batch.FirstRun != 0) &&
+        ((m_StreamedNoUncertaintySeries == nullptr) || (batch.FirstRun != m_StreamedRuns) ||
+         ! m_ChartWidget->series().contains(m_StreamedNoUncertaintySeries))) {
+        m_StreamedNoUncertaintySeries = nullptr;
+        return;
+    }
+
+    // F is computed from the forecast harvest loaded with the model parameters
+    bool hasHarvest = (m_PreviewParameters.Harvest.size1() == unsigned(batch.NumYearsPerRun+1)) &&
+                      (m_PreviewParameters.Harvest.size2() == unsigned(batch.NumSpecies));
+    if (isFishingMortality && ! hasHarvest) {
+        return;
+    }
+    if (isFishingMortality) {
+        YLabel = nmfConstantsMSSPM::OutputChartExploitationCatchTitle.toStdString();
+    } else if (isRelativeBiomass) {
+        YLabel = "Relative Biomass";
+    }
+    auto toChartLine = [&](const boost::numeric::ublas::matrix<double>& runBiomass) {
+        ChartLine.resize(batch.NumYearsPerRun+1,1);
+        time0Value = runBiomass(0,SpeciesNum)/ScaleVal;
+        for (int time=0; time<=batch.NumYearsPerRun; ++time) {
+            biomass = runBiomass(time,SpeciesNum);
+            if (isFishingMortality) {
+                value = (nmfUtils::isNearlyZero(biomass)) ? nmfConstantsMSSPM::NoFishingMortality :
+                                                            m_PreviewParameters.Harvest(time,SpeciesNum)/biomass;
+            } else {
+                value = biomass/ScaleVal;
+                if (isRelativeBiomass) {
+                    value = (nmfUtils::isNearlyZero(time0Value)) ? 0 : value/time0Value;
+                }
+            }
+            ChartLine(time,0) = value;
+            m_StreamedYMax = std::max(m_StreamedYMax,value);
+        }
+    };
+
+    getYearRange(StartYear,EndYear);
+
+    // The forecast without uncertainty arrives first and sets up the chart and its axes
+    if (batch.FirstRun == 0) {
+        if (batch.Biomass.size() != 1) {
+            return;
+        }
+        m_StreamedRuns = 0;
+        m_StreamedYMax = 0;
+        toChartLine(batch.Biomass[0]);
+
+        m_GridParent->hide();
+        m_ChartView->show();
+        m_ForecastBiomassLineChart->clear(m_ChartWidget);
+        m_ForecastLineChartMonteCarlo->clear(m_ChartWidget);
+        m_ChartWidget->removeAllSeries();
+        m_ForecastBiomassLineChart->populateChart(
+                    m_ChartWidget,
+                    ChartType,
+                    LineStyle,
+                    m_LineWidthData,
+                    nmfConstantsMSSPM::ShowFirstPoint,
+                    nmfConstants::DontShowLegend,
+                    EndYear,
+                    nmfConstantsMSSPM::DontApplyNiceNumbersXAxis,
+                    nmfConstantsMSSPM::LabelXAxisAsInts,
+                    YMinVal,YMaxVal,
+                    nmfConstantsMSSPM::LeaveGapsWhereNegative,
+                    ChartLine,
+                    RowLabelsForBars,
+                    ColumnLabelsForLegend,
+                    {"No Uncertainty Variations"},
+                    MainTitle,
+                    XLabel,
+                    YLabel,
+                    m_FontSizeLabel,
+                    m_FontSizeNumber,
+                    m_Font,
+                    m_LineWidthAxes,
+                    m_LineColor,
+                    {m_GridLines,m_GridLines},
+                    Theme,
+                    QColor(nmfConstants::LineColors[0].c_str()),
+                    "No Uncertainty Variations",
+                    1.0);
+        m_StreamedNoUncertaintySeries = nullptr;
+        if (! m_ChartWidget->series().isEmpty()) {
+            m_StreamedNoUncertaintySeries = qobject_cast<QLineSeries*>(m_ChartWidget->series().back());
+        }
+        if ((m_StreamedNoUncertaintySeries == nullptr) || m_ChartWidget->axes().isEmpty()) {
+            m_StreamedNoUncertaintySeries = nullptr;
+            return;
+        }
+    }
+
+    // Append the batch's runs beneath the forecast without uncertainty
+    QAbstractAxis* axisX = m_ChartWidget->axes(Qt::Horizontal).back();
+    QValueAxis*    axisY = qobject_cast<QValueAxis*>(m_ChartWidget->axes(Qt::Vertical).back());
+    pen.setColor(dimmedColor);
+    pen.setWidth(m_LineWidthData);
+    for (int line=0; line<NumLines; ++line) {
+        toChartLine(batch.BiomassMonteCarlo[line]);
+        series = new QLineSeries();
+        series->setPen(pen);
+        series->setName("MonteCarloSimulation");
+        for (int time=0; time<=batch.NumYearsPerRun; ++time) {
+            if (ChartLine(time,0) >= 0) {
+                series->append(EndYear+time,ChartLine(time,0));
+            }
+        }
+        m_ChartWidget->addSeries(series);
+        series->attachAxis(axisX);
+        series->attachAxis(axisY);
+    }
+    m_StreamedRuns += NumLines;
+
+    // Keep the forecast without uncertainty on top
+    m_ChartWidget->removeSeries(m_StreamedNoUncertaintySeries);
+    m_ChartWidget->addSeries(m_StreamedNoUncertaintySeries);
+    m_StreamedNoUncertaintySeries->attachAxis(axisX);
+    m_StreamedNoUncertaintySeries->attachAxis(axisY);
+
+    // The y axis only ever grows so that the chart doesn't jump around as runs arrive
+    if (axisY && ! MModeYAxisLockCB->isChecked() && (m_StreamedYMax > axisY->max())) {
+        axisY->setRange(0,m_StreamedYMax);
+        axisY->applyNiceNumbers();
+        axisY->setTickCount(5);
+    }
+}
+
+void
+REMORA_UI::callback_RunCancelled()
+{
+    m_RunQueued = false;
+    setRunInProgress(false);
+
+    // Replace any partially streamed runs with the last complete forecast
+    if (m_StreamedNoUncertaintySeries != nullptr) {
+        m_StreamedNoUncertaintySeries = nullptr;
+        drawPlot();
+    }
+    m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_RunPB cancelled");
+}
+
+void
+REMORA_UI::callback_RunFailed(QString msg)
+{
+    m_RunQueued = false;
+    m_StreamedNoUncertaintySeries = nullptr;
+    setRunInProgress(false);
+    m_Logger->logMsg(nmfConstants::Error,"REMORA_UI::callback_RunPB failed: " + msg.toStdString());
+    reportQueryProfile("failed run of forecast " + m_ForecastName);
+    msg = "\nREMORA run failed. Please check log for error messages.\n\n" + msg + "\n";
+    QMessageBox::warning(m_TopLevelWidget, "Warning", msg, QMessageBox::Ok);
+}
+
+void
+REMORA_UI::callback_RunFinished(REMORA_ForecastData data)
+{
+    bool isRedrawNeeded = isForecastRedrawNeeded(data) || (m_StreamedNoUncertaintySeries != nullptr);
+
+    m_ForecastData = data;
+    m_StreamedNoUncertaintySeries = nullptr;
+    showRunsUsed(data);
+
+    callback_RunProgress(REMORA_RunWorker::PhaseDraw,
+                         REMORA_RunWorker::overallPercent(REMORA_RunWorker::PhaseDraw,0),
+                         REMORA_RunWorker::phaseDescription(REMORA_RunWorker::PhaseDraw));
+    if (isRedrawNeeded) {
+        m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_RunPB drawPlot");
+        drawPlot();
+    } else {
+        m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_RunPB no displayed species changed");
+    }
+    setRunInProgress(false);
+    enableWidgets(true);
 
     m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_RunPB end");
+    reportQueryProfile("run of forecast " + m_ForecastName);
+
+    // The scale factors were dragged during the run
+    if (m_RunQueued) {
+        m_RunQueued = false;
+        callback_RunPB();
+    }
+}
+
+void
+REMORA_UI::callback_RunProgress(int phase, int percent, QString description)
+{
+    MModeRunProgressBar->setValue(percent);
+    MModeRunProgressBar->setFormat(description + "  %p%");
+    m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_RunPB phase " + std::to_string(phase) +
+                     ": " + description.toStdString());
 }
 
 void
@@ -2477,6 +3717,13 @@ REMORA_UI::callback_RunsPerForecastSL(int value)
     setScenarioChanged(true);
 }
 
+void
+REMORA_UI::callback_SamplingCMB(QString method)
+{
+    (void)method;
+    setScenarioChanged(true);
+}
+
 void
 REMORA_UI::callback_SavePB()
 {
@@ -2526,7 +3773,7 @@ REMORA_UI::callback_SingleSpeciesRB(bool pressed)
     MModeMultiPlotTypePB->setEnabled(! pressed);
     MModeShowMSYCB->setEnabled(        pressed && ! isRelativeBiomassPlotType());
     MModePctMSYCB->setEnabled(         pressed && ! isRelativeBiomassPlotType());
-    drawPlot();
+    scheduleDrawPlot();
     setScenarioChanged(true);
 }
 
@@ -2543,14 +3790,14 @@ REMORA_UI::callback_SpeciesCMB(QString species)
         m_MovableLineCharts[speciesNum]->show();
         MModeMaxScaleFactorSB->setValue(m_MaxYAxisValues[speciesNum]);
     }
-    drawPlot();
+    scheduleDrawPlot();
     setScenarioChanged(true);
 }
 
 void
 REMORA_UI::callback_PlotTypeScaleFactorCMB()
 {
-    drawPlot();
+    scheduleDrawPlot();
 }
 
 void
@@ -2560,6 +3807,108 @@ REMORA_UI::callback_StochasticRB(bool pressed)
     setScenarioChanged(true);
 }
 
+void
+REMORA_UI::callback_SweepCancelPB()
+{
+    if (m_SweepInProgress) {
+        m_RunWorker->cancel();
+        m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_SweepCancelPB: Cancel requested");
+    }
+}
+
+void
+REMORA_UI::callback_SweepCancelled()
+{
+    m_SweepInProgress = false;
+    setRunInProgress(false);
+    m_SweepDialog->setRunInProgress(false,"Sweep cancelled.");
+    m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_SweepRunPB cancelled");
+}
+
+void
+REMORA_UI::callback_SweepFailed(QString msg)
+{
+    m_SweepInProgress = false;
+    setRunInProgress(false);
+    m_SweepDialog->setRunInProgress(false,"Sweep failed: " + msg);
+    m_Logger->logMsg(nmfConstants::Error,"REMORA_UI::callback_SweepRunPB failed: " + msg.toStdString());
+}
+
+void
+REMORA_UI::callback_SweepFinished(REMORA_SweepResult result)
+{
+    m_SweepInProgress = false;
+    setRunInProgress(false);
+    m_SweepDialog->setRunInProgress(false,"Each point is the outcome of " +
+                                    QString::number(m_NumRunsPerForecast) + " forecast runs.");
+    m_SweepDialog->setResult(result);
+    m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_SweepRunPB end");
+
+    // The scale factors were dragged during the sweep
+    if (m_RunQueued) {
+        m_RunQueued = false;
+        callback_RunPB();
+    }
+}
+
+void
+REMORA_UI::callback_SweepPB()
+{
+    QStringList SpeciesList;
+
+    for (int i=0; i<MModeSpeciesCMB->count(); ++i) {
+        SpeciesList << MModeSpeciesCMB->itemText(i);
+    }
+    if (m_SweepDialog == nullptr) {
+        m_SweepDialog = new REMORA_SweepDialog(m_TopLevelWidget,SpeciesList);
+        connect(m_SweepDialog, SIGNAL(RunSweep(REMORA_SweepSettings)),
+                this,          SLOT(callback_SweepRunPB(REMORA_SweepSettings)));
+        connect(m_SweepDialog, SIGNAL(CancelSweep()),
+                this,          SLOT(callback_SweepCancelPB()));
+    } else if (! m_SweepInProgress) {
+        m_SweepDialog->setSpeciesList(SpeciesList);
+    }
+    m_SweepDialog->show();
+    m_SweepDialog->raise();
+    m_SweepDialog->activateWindow();
+}
+
+void
+REMORA_UI::callback_SweepProgress(int percent)
+{
+    m_SweepDialog->setProgress(percent);
+    MModeRunProgressBar->setValue(percent);
+    MModeRunProgressBar->setFormat("Sweeping...  %p%");
+}
+
+void
+REMORA_UI::callback_SweepRunPB(REMORA_SweepSettings sweep)
+{
+    REMORA_RunSettings settings;
+
+    if (m_RunInProgress) {
+        m_SweepDialog->setRunInProgress(false,"Please wait for the current forecast run to finish.");
+        return;
+    }
+
+    readSettings();
+
+    m_Logger->logMsg(nmfConstants::Normal,"REMORA_UI::callback_SweepRunPB start");
+    updateYearlyScaleFactorPoints();
+    if (! getRunSettings(settings)) {
+        m_SweepDialog->setRunInProgress(false,"Sweep failed. Please check log for error messages.");
+        return;
+    }
+
+    // The sweep shares the run worker with the forecast runs so only one may be in progress
+    m_SweepInProgress = true;
+    setRunInProgress(true);
+    m_SweepDialog->setRunInProgress(true,"Sweeping " +
+                                    QString::number(sweep.XNumSteps*sweep.YNumSteps) + " grid points...");
+    m_RunWorker->clearCancel();
+    emit StartSweep(settings,sweep);
+}
+
 void
 REMORA_UI::callback_UncertaintyHarvestParameterDL(int value)
 {
@@ -32,17 +32,23 @@
 #ifndef MSSPM_GUIMANAGERMODE_H
 #define MSSPM_GUIMANAGERMODE_H
 
+#include <QAreaSeries>
 #include <QCheckBox>
 #include <QComboBox>
+#include <QDoubleSpinBox>
 #include <QDial>
 #include <QFileDialog>
 #include <QLineEdit>
 #include <QLineSeries>
 #include <QMessageBox>
+#include <QPointer>
+#include <QProgressBar>
 #include <QPushButton>
 #include <QRadioButton>
 #include <QSlider>
 #include <QSpinBox>
+#include <QThread>
+#include <QTimer>
 #include <QUiLoader>
 #include <QVBoxLayout>
 
@@ -50,6 +56,14 @@
 #include "nmfChartLine.h"
 #include "nmfConstantsMSSPM.h"
 #include "nmfUtils.h"
+#include "REMORA_ForecastData.h"
+#include "REMORA_ForecastEngine.h"
+#include "REMORA_ForecastStore.h"
+#include "REMORA_QueryProfiler.h"
+#include "REMORA_RunWorker.h"
+#include "REMORA_Statistics.h"
+#include "REMORA_Storage.h"
+#include "REMORA_SweepDialog.h"
 
 #include <string.h>
 
@@ -67,16 +81,21 @@ class REMORA_UI : public QObject
 private:
     const int     DEFAULT_MAX_SCALE_VALUE = 4;
 
+    QCheckBox*    MModeAdaptiveCB;
+    QCheckBox*    MModeFanChartCB;
     QCheckBox*    MModeShowMSYCB;
     QCheckBox*    MModePctMSYCB;
     QCheckBox*    MModeYAxisLockCB;
     QComboBox*    MModeSpeciesCMB;
     QComboBox*    MModeForecastPlotTypeCMB;
     QComboBox*    MModePlotScaleFactorCMB;
+    QComboBox*    MModeSamplingCMB;
+    QDoubleSpinBox* MModeConvergenceToleranceSB;
     QDial*        MModeRParamDL;
     QDial*        MModeKParamDL;
     QDial*        MModeHParamDL;
     QDial*        MModePctMSYDL;
+    QLabel*       MModeAdaptiveRunsLB;
     QLabel*       MModeForecastPlotTypeLB;
     QLabel*       MModeForecastTypeLB;
     QLabel*       MModePlotTypeLB;
@@ -95,11 +114,14 @@ private:
     QLineEdit*    MModeHParamLE;
     QLineEdit*    MModePctMSYLE;
     QPushButton*  MModeForecastRunPB;
+    QPushButton*  MModeForecastCancelPB;
     QPushButton*  MModeForecastDelPB;
     QPushButton*  MModeForecastLoadPB;
     QPushButton*  MModeForecastSavePB;
+    QPushButton*  MModeForecastSweepPB;
     QPushButton*  MModeMultiPlotTypePB;
     QSpinBox*     MModeMaxScaleFactorSB;
+    QProgressBar* MModeRunProgressBar;
     QRadioButton* MModeDeterministicRB;
     QRadioButton* MModeStochasticRB;
     QRadioButton* MModePlotTypeSSRB;
@@ -154,7 +176,7 @@ private:
     QGridLayout*          m_GridLayt;
     QVBoxLayout*          m_GridVLayt;
     QVBoxLayout*          m_VLayt;
-    QList<QChart*>        m_Charts;
+    QList<QChart*>        m_Charts;  // Multi-plot grid charts, one per species, kept between draws
     QList<QChartView*>    m_Views;
     QString               m_RemoraScenarioDir;
     QWidget*              m_GridParent;
@@ -162,7 +184,37 @@ private:
     QWidget*              m_REMORAWidget;
     std::string           m_MultiRunType;
     bool                  m_UseLastSingleRun;
+    int                   m_InsertChunkSize;
+    bool                  m_IsQueryProfiling;
+    QString               m_QueryProfileFile;
+    REMORA_QueryProfiler  m_QueryProfiler;
     QMainWindow*          m_MainWindow;
+    bool                  m_RunInProgress;
+    bool                  m_WidgetsEnabledBeforeRun;
+    QThread*              m_RunThread;
+    REMORA_RunWorker*     m_RunWorker;
+    REMORA_ForecastData   m_ForecastData;
+    REMORA_ForecastStore  m_ForecastStore;
+    bool                  m_IsHostSimulated;             // True if the last run was handed to the host application, which has no adaptive mode
+    REMORA_ModelParameters m_PreviewParameters;
+    std::string           m_PreviewForecastName;         // Forecast whose parameters were last loaded, see loadPreviewParameters
+    std::vector<std::vector<double> > m_PreviewScaleFactors;
+    QTimer*               m_PreviewTimer;
+    bool                  m_PreviewActive;
+    QTimer*               m_DrawPlotTimer;               // Pending redraw requested by the controls, see scheduleDrawPlot
+    int                   m_NumDrawsRequested;           // Redraws requested since the pending one was scheduled
+    int                   m_NumDrawsElided;              // Redraws that weren't needed since REMORA started
+    bool                  m_RunQueued;
+    REMORA_SweepDialog*   m_SweepDialog;
+    bool                  m_SweepInProgress;
+    QLineSeries*          m_StreamedNoUncertaintySeries; // Forecast without uncertainty drawn while streaming runs (nullptr if not streaming)
+    int                   m_StreamedRuns;                // Number of Monte Carlo runs drawn while streaming
+    double                m_StreamedYMax;
+    REMORA_ModelMetadata  m_ModelMetadata;               // Cached per project and model, see getModelMetadata
+    REMORA_ForecastInfo   m_ForecastInfo;                // Cached per forecast, see getForecastInfo
+    std::map<std::string,std::vector<double> > m_MSYCache; // MSY values (ordered by species name) per MSY table, project, model, and algorithm identifiers
+    std::map<QChart*,std::string> m_ChartLayouts;        // What each chart was last fully drawn with, apart from its data and title
+    std::map<QChart*,QList<QPointer<QAbstractSeries> > > m_ChartDataSeries; // Each chart's forecast series in the order drawn
 
     bool couldShowMSYCB();
     void checkAlgorithmIdentifiersForMultiRun(
@@ -170,6 +222,17 @@ private:
             std::string& Minimizer,
             std::string& ObjectiveCriterion,
             std::string& Scaling);
+    void drawFanChart(
+            QChart* chart,
+            const boost::numeric::ublas::matrix<double>& FanChartQuantiles,
+            int& StartForecastYear,
+            double& YMinVal,
+            double& YMaxVal,
+            std::string& MainTitle,
+            std::string& XLabel,
+            std::string& YLabel,
+            const QColor& BandColor);
+    void drawForecastPreview(const int& SpeciesNum);
     void drawMultiSpeciesChart();
     void drawMSYLines();
     void drawMSYLines(
@@ -193,32 +256,63 @@ private:
             const bool& ShowLegend,
             const double& Pct);
     void drawPlot();
-    void drawSingleSpeciesChart();
+    bool drawSingleSpeciesChart();
     void enableWidgets(bool enable);
     QString getCarryingCapacityUncertainty();
+    QString getConvergenceTolerance();
     std::string getCurrentSpecies();
+    void getFanChartQuantiles(
+            const boost::numeric::ublas::matrix<double>& ChartLinesMonteCarlo,
+            const boost::numeric::ublas::matrix<double>& ChartLine,
+            boost::numeric::ublas::matrix<double>& FanChartQuantiles,
+            double& YMaxVal);
     QString getForecastPlotType();
     QString getGrowthUncertainty();
     QString getHarvestType();
     QString getHarvestUncertainty();
-    bool getLastYearsCatchValues(
-            int& lastYear,
-            std::vector<double>& lastYearsCatchValues);
+    bool getForecastBiomass(
+            int& NumSpecies,
+            int& NumYearsPerRun,
+            int& NumRunsPerForecast,
+            std::string& Algorithm,
+            std::string& Minimizer,
+            std::string& ObjectiveCriterion,
+            std::string& Scaling,
+            const bool& includeMonteCarlo,
+            const int& monteCarloSpeciesNum = -1);
+    const REMORA_ForecastInfo& getForecastInfo();
+    bool getForecastHoverData(
+            const int&         SpeciesNum,
+            const std::string& Algorithm,
+            const std::string& Minimizer,
+            const std::string& ObjectiveCriterion,
+            const std::string& Scaling,
+            QStringList&       HoverData);
+    bool getLastCatch(const int& NumSpecies);
     int getMaxYScaleFactor(const int& speciesNum);
+    const REMORA_ModelMetadata& getModelMetadata();
     int getNumRunsPerForecast();
     int getNumScaleFactorPoints(const int& speciesNum);
     int getNumSpecies();
     int getNumYearsPerRun();
     double getPctMSYValue();
+    bool getRunSettings(REMORA_RunSettings& settings);
     QList<QPointF> getScaleFactorPoints(const int& speciesNum);
+    QString getSamplingMethod();
     QString getScenarioName();
     int getSpeciesNum();
     double getPlotScaleFactor();
     QString getYLBLPlotScaleFactor(double scaleFactor);
     void getYearRange(int& firstYear, int& lastYear);
     void initializeScaleFactors();
+    void invalidateForecastInfo();
+    void invalidateModelMetadata();
     bool isAbsoluteBiomassPlotType();
+    bool isAdaptive();
+    bool isFanChart();
     bool isFishingMortalityPlotType();
+    bool isForecastRedrawNeeded(const REMORA_ForecastData& data);
+    bool isPreviewAvailable();
     bool isMultiPlot();
     bool isMultiSpecies();
     bool isMSYBoxChecked();
@@ -226,9 +320,16 @@ private:
     bool isRelativeBiomassPlotType();
     bool isSingleSpecies();
     bool isYAxisLocked();
+    bool loadForecastBiomassMonteCarlo(const int& speciesNum);
     void loadForecastScenario(QString filename);
+    void loadPreviewParameters();
     QWidget* loadUI(QWidget* parentW);
+    REMORA_QueryProfiler* queryProfiler();
     void readSettings();
+    void reportQueryProfile(const std::string& title);
+    void rememberChartLayout(
+            QChart*            chart,
+            const std::string& layout);
     void removeAllMSYLines(QString type);
     void removeMSYLines(
             QChart*             chart,
@@ -237,13 +338,15 @@ private:
     void resetNumYearsOnScaleFactorCharts();
     void resetScenarioName();
     void resetYearsPerRunOnScaleFactorPlot();
-    void saveForecastParameters();
+    void resizeChartGrid(const int& numCharts);
     bool saveForecastScenario(QString filename);
-    bool saveHarvestData();
     void saveOutputBiomassData();
-    void saveUncertaintyParameters();
+    void scheduleDrawPlot();
+    void setAdaptive(QString isChecked);
     void setAScaleFactorPoint(QString arg1);
+    void setConvergenceTolerance(QString tolerance);
     void setDeterministic(QString arg1);
+    void setFanChart(QString isChecked);
     void setForecastPlotType(QString arg1);
     void setMaxYScaleFactor(QString maxY);
     void setMultiPlot(QString isChecked);
@@ -251,6 +354,8 @@ private:
     void setNumRunsPerForecast(QString numRuns);
     void setNumScaleFactorPoints(QString arg1);
     void setNumYearsPerRun(QString numYears);
+    void setRunInProgress(bool inProgress);
+    void setSamplingMethod(QString method);
     void setScenarioChanged(bool state);
     void setScenarioName(QString scenarioName);
     void setSingleSpecies(QString arg1);
@@ -258,13 +363,25 @@ private:
     void setUncertaintyGrowth(QString arg1);
     void setUncertaintyHarvest(QString arg1);
     void setupConnections();
+    void setupRunThread();
     void setupMovableLineCharts(const QStringList& SpeciesList);
+    void showRunsUsed(const REMORA_ForecastData& data);
     void resetXAxis();
     /**
      * @brief Resets the maximum y-axis value of the model plot if the user has
      * checked the lock button in the controls
      */
     void resetYAxis();
+    bool updateChartInPlace(
+            QChart*            chart,
+            const std::string& layout,
+            const boost::numeric::ublas::matrix<double>& ChartData,
+            const QStringList& SeriesNames,
+            const int&         StartForecastYear,
+            const double&      YMinVal,
+            const double&      YMaxVal,
+            const std::string& MainTitle);
+    bool updatePreviewScaleFactors();
     void updateYearlyScaleFactorPoints();
 
 signals:
@@ -294,6 +411,23 @@ signals:
      * @param seedValue : 1 or 0 (0 signifies that a random seed value will be used)
      */
     void UpdateSeedValue(int seedValue);
+    /**
+     * @brief Signal emitted to have the run worker load the forecast data once the simulation is complete
+     * @param settings : snapshot of the REMORA controls used for the run
+     */
+    void StartLoadForecastData(REMORA_RunSettings settings);
+    /**
+     * @brief Signal emitted to have the run worker save the forecast configuration at the start of a run
+     * @param settings : snapshot of the REMORA controls used for the run
+     */
+    void StartSaveForecastConfiguration(REMORA_RunSettings settings);
+    /**
+     * @brief Signal emitted to have the run worker simulate the forecast over a grid of uncertainty or harvest values
+     * @param settings : snapshot of the REMORA controls
+     * @param sweep : the sweep grid
+     */
+    void StartSweep(REMORA_RunSettings   settings,
+                    REMORA_SweepSettings sweep);
 
 public:
     /**
@@ -316,6 +450,12 @@ public:
             QStringList&   speciesList);
     ~REMORA_UI();
 
+    /**
+     * @brief Discards the cached MSY values. This is done whenever the project or model
+     * changes, a run starts, or the forecast is reloaded, so that the values of a newer
+     * estimation of the current model are read.
+     */
+    void clearMSYCache();
     /**
      * @brief Toggle the enable-ness of the carrying capacity widgets
      * @param enable : true if widgets are enabled, false otherwise
@@ -386,12 +526,15 @@ public:
      */
     void setHarvestType(QString harvestType);
     /**
-     * @brief Sets the model name to be used in the current REMORA instance
+     * @brief Sets the model name to be used in the current REMORA instance. This also
+     * discards the cached model metadata (i.e., year range, species, and algorithm identifiers),
+     * so the host application must call it whenever the model is (re)loaded.
      * @param modelName : model name of current REMORA instance
      */
     void setModelName(std::string modelName);
     /**
-     * @brief Sets the project name to be used in the current REMORA instance
+     * @brief Sets the project name to be used in the current REMORA instance. This also
+     * discards the cached model metadata.
      * @param projectName : project name of current REMORA instance
      */
     void setProjectName(const std::string& projectName);
@@ -402,6 +545,20 @@ public:
     void setSpeciesList(const QStringList& speciesList);
 
 public Q_SLOTS:
+    /**
+     * @brief Callback invoked when the user checks the Adaptive checkbox
+     * @param isChecked : true if runs are to be added until the forecast's quantiles converge
+     */
+    void callback_AdaptiveCB(bool isChecked);
+    /**
+     * @brief Callback invoked when the user presses the Cancel button while a run is in progress
+     */
+    void callback_CancelPB();
+    /**
+     * @brief Callback invoked when the user changes the adaptive convergence tolerance
+     * @param value : the tolerance as a percent
+     */
+    void callback_ConvergenceToleranceSB(double value);
     /**
      * @brief Callback invoked when the user presses the delete scenario button
      */
@@ -411,6 +568,22 @@ public Q_SLOTS:
      * @param pressed : state of the radio button (true/false)
      */
     void callback_DeterministicRB(bool pressed);
+    /**
+     * @brief Callback invoked once control returns to the event loop after a redraw was requested.
+     * Draws the forecast plot once for all of the redraws requested since then.
+     */
+    void callback_DrawPlotTimer();
+    /**
+     * @brief Callback invoked when the user checks the Fan Chart checkbox
+     * @param isChecked : true if the forecast runs are to be drawn as percentile bands
+     */
+    void callback_FanChartCB(bool isChecked);
+    /**
+     * @brief Callback invoked when the run worker has saved the forecast configuration. The host
+     * application is then asked to simulate the forecast runs after which the run worker loads the results.
+     * @param settings : snapshot of the REMORA controls used for the run
+     */
+    void callback_ForecastConfigurationSaved(REMORA_RunSettings settings);
     /**
      * @brief Callback invoked when the user selects a new forecast plot type
      * @param type : name of the forecast plot type chosen
@@ -440,6 +613,12 @@ public Q_SLOTS:
      * @param event : mouse event data
      */
     void callback_MouseReleased(QMouseEvent* event);
+    /**
+     * @brief Callback invoked when the run worker has loaded the model parameters used for the
+     * forecast. These are kept so that the forecast may be previewed while dragging scale factor points.
+     * @param parameters : the model parameters and forecast harvest
+     */
+    void callback_ModelParametersLoaded(REMORA_ModelParameters parameters);
     /**
      * @brief Callback invoked when the user checks the MSY checkbox
      * @param isChecked : boolean signifying if the checkbox has been checked
@@ -474,18 +653,59 @@ public Q_SLOTS:
      * @param pressed : state of the stochastic radio button
      */
     void callback_PlotTypeScaleFactorCMB();
+    /**
+     * @brief Callback invoked periodically while the user drags a scale factor point. Draws a
+     * deterministic forecast for the current species using the dragged scale factors.
+     */
+    void callback_PreviewTimer();
     /**
      * @brief Callback invoked when the user presses the Run button. Run causes the appropriate
      * forecast scenario biomass data to be generated and saved in the database for each species.
      * A default plot is then displayed using these data. Additional plots can be viewed by selecting
-     * another species or by changing the plot type.
+     * another species or by changing the plot type. The database phases of the run are performed
+     * on the run worker thread so the GUI remains responsive and the run may be cancelled.
      */
     void callback_RunPB();
+    /**
+     * @brief Callback invoked as the run worker simulates batches of Monte Carlo runs. In single
+     * species mode the forecast without uncertainty is drawn first and each batch of runs is
+     * then added to the chart, growing the y axis as needed, until the run finishes and the
+     * complete chart is drawn.
+     * @param batch : the newly completed runs
+     */
+    void callback_RunBatchSimulated(REMORA_RunBatch batch);
+    /**
+     * @brief Callback invoked when the run worker has stopped due to a user cancel request
+     */
+    void callback_RunCancelled();
+    /**
+     * @brief Callback invoked when a phase of the run has failed
+     * @param msg : message describing the failure
+     */
+    void callback_RunFailed(QString msg);
+    /**
+     * @brief Callback invoked when the run worker has loaded the forecast data. The data
+     * are stored and drawn.
+     * @param data : the forecast data
+     */
+    void callback_RunFinished(REMORA_ForecastData data);
+    /**
+     * @brief Callback invoked as the run worker progresses through the phases of a run
+     * @param phase : the current run phase
+     * @param percent : overall percentage complete of the run
+     * @param description : description of the current phase
+     */
+    void callback_RunProgress(int phase, int percent, QString description);
     /**
      * @brief Callback invoked when the user interacts with the Runs per Forecast slider
      * @param value : current value on the Runs per Forecast slider
      */
     void callback_RunsPerForecastSL(int value);
+    /**
+     * @brief Callback invoked when the user selects a sampling method for the uncertainty values
+     * @param method : Random or Latin Hypercube
+     */
+    void callback_SamplingCMB(QString method);
     /**
      * @brief Callback invoked when the user presses the Save Scenario button
      */
@@ -506,6 +726,39 @@ public Q_SLOTS:
      * @param
      */
     void callback_StochasticRB(bool pressed);
+    /**
+     * @brief Callback invoked when the user cancels the sweep from the sweep dialog
+     */
+    void callback_SweepCancelPB();
+    /**
+     * @brief Callback invoked when the run worker has cancelled the sweep
+     */
+    void callback_SweepCancelled();
+    /**
+     * @brief Callback invoked when the run worker couldn't perform the sweep
+     * @param msg : message describing the failure
+     */
+    void callback_SweepFailed(QString msg);
+    /**
+     * @brief Callback invoked when the run worker has simulated every point of the sweep grid
+     * @param result : the sweep result
+     */
+    void callback_SweepFinished(REMORA_SweepResult result);
+    /**
+     * @brief Callback invoked when the user presses the Sweep button. Opens the dialog that
+     * shows the forecast outcome over a grid of uncertainty or harvest values as a surface.
+     */
+    void callback_SweepPB();
+    /**
+     * @brief Callback invoked as the sweep progresses
+     * @param percent : percentage complete (0-100) of the sweep
+     */
+    void callback_SweepProgress(int percent);
+    /**
+     * @brief Callback invoked when the user runs a sweep from the sweep dialog
+     * @param sweep : the sweep grid
+     */
+    void callback_SweepRunPB(REMORA_SweepSettings sweep);
     /**
      * @brief Callback invoked when the user modifies the Harvest Uncertainty dial
      * @param value : current value of the Harvest Uncertainty dial
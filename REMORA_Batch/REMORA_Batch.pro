@@ -0,0 +1,64 @@
+#-------------------------------------------------
+#
+# Headless batch runner for REMORA forecast scenarios
+#
+#-------------------------------------------------
+
+QT       += core gui sql
+
+TARGET = REMORA_Batch
+TEMPLATE = app
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += $$PWD/../REMORA
+DEPENDPATH += $$PWD/../REMORA
+
+SOURCES += \
+    main.cpp \
+    REMORA_BatchRunner.cpp \
+    ../REMORA/REMORA_Database.cpp \
+    ../REMORA/REMORA_ForecastEngine.cpp \
+    ../REMORA/REMORA_ModelLoader.cpp \
+    ../REMORA/REMORA_QueryProfiler.cpp \
+    ../REMORA/REMORA_Scenario.cpp \
+    ../REMORA/REMORA_SQLiteStorage.cpp \
+    ../REMORA/REMORA_SqlStorage.cpp \
+    ../REMORA/REMORA_Statistics.cpp \
+    ../REMORA/REMORA_Storage.cpp
+
+HEADERS += \
+    REMORA_BatchRunner.h \
+    ../REMORA/REMORA_Database.h \
+    ../REMORA/REMORA_ForecastData.h \
+    ../REMORA/REMORA_ForecastEngine.h \
+    ../REMORA/REMORA_ModelLoader.h \
+    ../REMORA/REMORA_QueryProfiler.h \
+    ../REMORA/REMORA_Scenario.h \
+    ../REMORA/REMORA_SQLiteStorage.h \
+    ../REMORA/REMORA_SqlStorage.h \
+    ../REMORA/REMORA_Statistics.h \
+    ../REMORA/REMORA_Storage.h
+
+unix {
+    target.path = /usr/bin
+    INSTALLS += target
+}
+
+
+win32:CONFIG(release, debug|release): LIBS += -L$$PWD/../../../builds/build-nmfUtilities-Desktop_Qt_5_15_1_GCC_64bit-Release/release/ -lnmfUtilities
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$PWD/../../../builds/build-nmfUtilities-Desktop_Qt_5_15_1_GCC_64bit-Release/debug/ -lnmfUtilities
+else:unix: LIBS += -L$$PWD/../../../builds/build-nmfUtilities-Desktop_Qt_5_15_1_GCC_64bit-Release/ -lnmfUtilities
+
+INCLUDEPATH += $$PWD/../../nmfSharedUtilities/nmfUtilities
+DEPENDPATH += $$PWD/../../nmfSharedUtilities/nmfUtilities
+
+win32:CONFIG(release, debug|release): LIBS += -L$$PWD/../../../builds/build-nmfDatabase-Desktop_Qt_5_15_1_GCC_64bit-Release/release/ -lnmfDatabase
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$PWD/../../../builds/build-nmfDatabase-Desktop_Qt_5_15_1_GCC_64bit-Release/debug/ -lnmfDatabase
+else:unix: LIBS += -L$$PWD/../../../builds/build-nmfDatabase-Desktop_Qt_5_15_1_GCC_64bit-Release/ -lnmfDatabase
+
+INCLUDEPATH += $$PWD/../../nmfSharedUtilities/nmfDatabase
+DEPENDPATH += $$PWD/../../nmfSharedUtilities/nmfDatabase
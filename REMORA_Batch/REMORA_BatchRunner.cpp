@@ -0,0 +1,391 @@
+#include "REMORA_BatchRunner.h"
+
+#include "nmfConstants.h"
+#include "REMORA_Database.h"
+#include "REMORA_ModelLoader.h"
+#include "REMORA_Statistics.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+#include <QRegularExpression>
+#include <QRunnable>
+#include <QTextStream>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <random>
+
+
+/**
+ * @brief Runs a single scenario of a batch on a pool thread
+ */
+class REMORA_BatchTask : public QRunnable
+{
+private:
+    std::function<void()> m_Function;
+public:
+    REMORA_BatchTask(std::function<void()> function) : m_Function(function) {}
+    void run() override { m_Function(); }
+};
+
+
+REMORA_BatchRunner::REMORA_BatchRunner(
+        const REMORA_BatchOptions& options,
+        nmfLogger*                 logger)
+{
+    m_Options     = options;
+    m_Logger      = logger;
+    m_NumFinished = 0;
+}
+
+REMORA_BatchRunner::~REMORA_BatchRunner()
+{
+}
+
+QStringList
+REMORA_BatchRunner::findScenarios(const QString& scenarioDir)
+{
+    QStringList filenames;
+    QDir dir(scenarioDir);
+
+    for (QString filename : dir.entryList(QStringList() << "*.scn",QDir::Files,QDir::Name)) {
+        filenames << dir.filePath(filename);
+    }
+    return filenames;
+}
+
+QString
+REMORA_BatchRunner::outputFilename(
+        const REMORA_BatchResult& result,
+        const QString&            suffix)
+{
+    QString name = QFileInfo(result.Filename).completeBaseName() + suffix;
+    name.replace(QRegularExpression("[^A-Za-z0-9_.-]"),"_");
+    return QDir(m_Options.OutputDir).filePath(name);
+}
+
+const std::vector<REMORA_BatchResult>&
+REMORA_BatchRunner::results()
+{
+    return m_Results;
+}
+
+int
+REMORA_BatchRunner::run(std::string& errorMsg)
+{
+    int NumFailed = 0;
+    QStringList filenames = findScenarios(m_Options.ScenarioDir);
+    QThreadPool pool;
+
+    if (filenames.isEmpty()) {
+        errorMsg = "No scenario files found in: " + m_Options.ScenarioDir.toStdString();
+        return -1;
+    }
+    if (! QDir().mkpath(m_Options.OutputDir)) {
+        errorMsg = "Couldn't create output directory: " + m_Options.OutputDir.toStdString();
+        return -1;
+    }
+
+    // Each scenario writes only to its own result so the results need no locking
+    m_Results.assign(filenames.size(),REMORA_BatchResult());
+    m_NumFinished = 0;
+    if (m_Options.NumThreads > 0) {
+        pool.setMaxThreadCount(m_Options.NumThreads);
+    }
+    for (int i=0; i<filenames.size(); ++i) {
+        REMORA_BatchResult* result = &m_Results[i];
+        result->Filename = filenames[i];
+        pool.start(new REMORA_BatchTask([this,result]() {
+            runScenario(*result);
+            std::lock_guard<std::mutex> lock(m_OutputMutex);
+            int NumFinished = ++m_NumFinished;
+            std::cout << NumFinished << "/" << m_Results.size() << " "
+                      << result->Filename.toStdString()
+                      << (result->Succeeded ? "" : ": " + result->ErrorMsg) << std::endl;
+        }));
+    }
+    pool.waitForDone();
+
+    // Images and files are written from this thread once all of the scenarios are finished
+    for (const REMORA_BatchResult& result : m_Results) {
+        if (! result.Succeeded) {
+            ++NumFailed;
+            m_Logger->logMsg(nmfConstants::Error,"REMORA_BatchRunner: " +
+                             result.Filename.toStdString() + ": " + result.ErrorMsg);
+        } else if (! writeQuantiles(result) || ! writePlots(result)) {
+            ++NumFailed;
+        }
+    }
+    if (! writeSummary()) {
+        errorMsg = "Couldn't write summary to: " + m_Options.OutputDir.toStdString();
+        return -1;
+    }
+
+    return NumFailed;
+}
+
+void
+REMORA_BatchRunner::runScenario(REMORA_BatchResult& result)
+{
+    int NumSpecies;
+    uint64_t seed;
+    std::string& errorMsg = result.ErrorMsg;
+    std::vector<double> lastYearsCatchValues;
+    boost::numeric::ublas::matrix<double> harvest;
+    REMORA_ModelParameters parameters;
+    REMORA_RunSettings& settings = result.Settings;
+    REMORA_Database database(REMORA_Database::hostConnectionName(),m_Logger);
+    REMORA_ModelLoader loader(&database,m_Logger);
+    REMORA_ForecastEngine engine(1); // Scenarios, rather than runs, are spread over the cores
+
+    if (! database.isOpen()) {
+        errorMsg = "Couldn't open database connection";
+        return;
+    }
+    if (! result.Scenario.load(result.Filename,errorMsg)) {
+        return;
+    }
+
+    settings.ConnectionName     = database.connectionName();
+    settings.ProjectName        = m_Options.ProjectName;
+    settings.ModelName          = m_Options.ModelName;
+    settings.ForecastName       = m_Options.ForecastName;
+    settings.HarvestType        = result.Scenario.harvestTable();
+    settings.NumYearsPerRun     = result.Scenario.NumYearsPerRun;
+    settings.NumRunsPerForecast = result.Scenario.NumRunsPerForecast;
+    settings.IsDeterministic    = result.Scenario.IsDeterministic;
+    settings.SamplingMethod     = result.Scenario.SamplingMethod;
+    settings.IsAdaptive         = result.Scenario.IsAdaptive;
+    settings.ConvergenceTolerance        = result.Scenario.ConvergenceTolerance/100.0;
+    settings.GrowthUncertainty           = result.Scenario.GrowthUncertainty/100.0;
+    settings.CarryingCapacityUncertainty = result.Scenario.CarryingCapacityUncertainty/100.0;
+    settings.HarvestUncertainty          = result.Scenario.HarvestUncertainty/100.0;
+
+    if (! loader.getYearRange(settings.ProjectName,settings.ModelName,settings.StartYear,settings.EndYear)) {
+        errorMsg = "No model found: " + settings.ModelName;
+        return;
+    }
+    if (! loader.getForecastInfo(settings,errorMsg)) {
+        return;
+    }
+    if (! m_Options.UseLastSingleRun) {
+        settings.ForecastAlgorithm          = m_Options.MultiRunType;
+        settings.ForecastMinimizer          = m_Options.MultiRunType;
+        settings.ForecastObjectiveCriterion = m_Options.MultiRunType;
+        settings.ForecastScaling            = m_Options.MultiRunType;
+    }
+    settings.Algorithm          = settings.ForecastAlgorithm;
+    settings.Minimizer          = settings.ForecastMinimizer;
+    settings.ObjectiveCriterion = settings.ForecastObjectiveCriterion;
+    settings.Scaling            = settings.ForecastScaling;
+
+    if (! loader.getSpecies(settings.SpeciesNames)) {
+        errorMsg = "No species found";
+        return;
+    }
+    NumSpecies = int(settings.SpeciesNames.size());
+    settings.ScaleFactors = result.Scenario.scaleFactors(settings.EndYear,NumSpecies);
+
+    if (! loader.getForecastHarvest(settings,lastYearsCatchValues,harvest,errorMsg) ||
+        ! loader.loadModelParameters(settings,lastYearsCatchValues,harvest,parameters,errorMsg)) {
+        return;
+    }
+    result.CarryingCapacity = parameters.CarryingCapacity;
+
+    if (settings.IsDeterministic) {
+        seed = REMORA_ForecastEngine::DeterministicSeed;
+    } else if (m_Options.Seed != 0) {
+        seed = m_Options.Seed;
+    } else {
+        seed = (uint64_t(std::random_device()()) << 32) | std::random_device()();
+    }
+    engine.run(parameters,settings,seed,std::vector<bool>(NumSpecies,true),result.Data,
+               [](int) { return true; });
+    result.Succeeded = result.Data.isValid();
+    if (! result.Succeeded) {
+        errorMsg = "Forecast simulation produced no data";
+    }
+}
+
+bool
+REMORA_BatchRunner::writePlots(const REMORA_BatchResult& result)
+{
+    const int Width  = 900;
+    const int Height = 560;
+    const int Left   = 80;
+    const int Right  = 30;
+    const int Top    = 50;
+    const int Bottom = 60;
+    const int NumTicks = 5;
+    int NumYears = result.Data.NumYearsPerRun;
+    int FirstYear = result.Settings.EndYear;
+    double maxBiomass;
+    const REMORA_BiomassTensor& Runs = result.Data.BiomassTensor;
+    QString filename;
+    std::vector<double> values;
+    std::vector<double> quantiles;
+
+    for (int species=0; species<result.Data.NumSpecies; ++species) {
+        QImage image(Width,Height,QImage::Format_ARGB32);
+        QPainter painter(&image);
+        std::vector<QPolygonF> quantileLines(3);
+        QPolygonF deterministicLine;
+
+        maxBiomass = 0.0;
+        for (int year=0; year<=NumYears; ++year) {
+            const double* runs = Runs.runs(year,species);
+            if (Runs.NumRuns > 0) {
+                maxBiomass = std::max(maxBiomass,*std::max_element(runs,runs+Runs.NumRuns));
+            }
+            maxBiomass = std::max(maxBiomass,result.Data.Biomass[0](year,species));
+        }
+        maxBiomass = (maxBiomass > 0) ? 1.05*maxBiomass : 1.0;
+
+        auto toPixel = [&](const double& year, const double& biomass) {
+            return QPointF(Left + (Width-Left-Right)*year/std::max(1,NumYears),
+                           Height-Bottom - (Height-Top-Bottom)*biomass/maxBiomass);
+        };
+
+        image.fill(Qt::white);
+        painter.setRenderHint(QPainter::Antialiasing);
+
+        // Axes, ticks, and labels
+        painter.setPen(Qt::black);
+        painter.drawLine(toPixel(0,0),toPixel(NumYears,0));
+        painter.drawLine(toPixel(0,0),toPixel(0,maxBiomass));
+        for (int tick=0; tick<=NumTicks; ++tick) {
+            double year    = double(tick*NumYears)/NumTicks;
+            double biomass = tick*maxBiomass/NumTicks;
+            QPointF xTick  = toPixel(year,0);
+            QPointF yTick  = toPixel(0,biomass);
+            painter.drawLine(xTick,xTick+QPointF(0,5));
+            painter.drawLine(yTick,yTick-QPointF(5,0));
+            painter.drawText(QRectF(xTick.x()-40,xTick.y()+8,80,20),Qt::AlignHCenter|Qt::AlignTop,
+                             QString::number(FirstYear+year,'f',0));
+            painter.drawText(QRectF(0,yTick.y()-10,Left-8,20),Qt::AlignRight|Qt::AlignVCenter,
+                             QString::number(biomass,'g',4));
+        }
+        painter.drawText(QRectF(0,Height-24,Width,20),Qt::AlignHCenter,"Year");
+        painter.drawText(QRectF(0,8,Width,24),Qt::AlignHCenter,
+                         QString::fromStdString(result.Scenario.Name + ": " + result.Settings.SpeciesNames[species]) +
+                         " Forecast Biomass");
+
+        // Individual runs
+        painter.setPen(QPen(QColor(150,150,150,60),1));
+        for (int run=0; run<Runs.NumRuns; ++run) {
+            QPolygonF line;
+            for (int year=0; year<=NumYears; ++year) {
+                line << toPixel(year,Runs.runs(year,species)[run]);
+            }
+            painter.drawPolyline(line);
+        }
+
+        // 5th, 50th, and 95th percentiles and the run without uncertainty
+        for (int year=0; year<=NumYears; ++year) {
+            const double* runs = Runs.runs(year,species);
+            values.assign(runs,runs+Runs.NumRuns);
+            quantiles = REMORA_Statistics::quantiles(values,{0.05,0.5,0.95});
+            for (int i=0; i<3; ++i) {
+                quantileLines[i] << toPixel(year,quantiles[i]);
+            }
+            deterministicLine << toPixel(year,result.Data.Biomass[0](year,species));
+        }
+        painter.setPen(QPen(QColor(200,80,0),1.5,Qt::DashLine));
+        painter.drawPolyline(quantileLines[0]);
+        painter.drawPolyline(quantileLines[2]);
+        painter.setPen(QPen(QColor(200,80,0),2));
+        painter.drawPolyline(quantileLines[1]);
+        painter.setPen(QPen(QColor(0,70,200),2));
+        painter.drawPolyline(deterministicLine);
+        painter.end();
+
+        filename = outputFilename(result,"_" + QString::fromStdString(result.Settings.SpeciesNames[species]) + ".png");
+        if (! image.save(filename)) {
+            m_Logger->logMsg(nmfConstants::Error,"REMORA_BatchRunner: Couldn't write image: " + filename.toStdString());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+REMORA_BatchRunner::writeQuantiles(const REMORA_BatchResult& result)
+{
+    std::vector<double> values;
+    std::vector<double> quantiles;
+    QFile file(outputFilename(result,"_quantiles.csv"));
+
+    if (! file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_Logger->logMsg(nmfConstants::Error,"REMORA_BatchRunner: Couldn't write: " + file.fileName().toStdString());
+        return false;
+    }
+
+    QTextStream stream(&file);
+    stream << "Species,Year,Deterministic,P5,Median,P95\n";
+    for (int species=0; species<result.Data.NumSpecies; ++species) {
+        for (int year=0; year<=result.Data.NumYearsPerRun; ++year) {
+            const double* runs = result.Data.BiomassTensor.runs(year,species);
+            values.assign(runs,runs+result.Data.BiomassTensor.NumRuns);
+            quantiles = REMORA_Statistics::quantiles(values,{0.05,0.5,0.95});
+            stream << QString::fromStdString(result.Settings.SpeciesNames[species]) << ","
+                   << result.Settings.EndYear+year << ","
+                   << result.Data.Biomass[0](year,species) << ","
+                   << quantiles[0] << "," << quantiles[1] << "," << quantiles[2] << "\n";
+        }
+    }
+    file.close();
+    return true;
+}
+
+bool
+REMORA_BatchRunner::writeSummary()
+{
+    int NumBelow;
+    int LastYear;
+    double halfK;
+    std::vector<double> values;
+    std::vector<double> quantiles;
+    QFile file(QDir(m_Options.OutputDir).filePath("summary.csv"));
+
+    if (! file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    // End year biomass statistics. P(B<K/2) is the fraction of runs ending below the biomass at MSY.
+    QTextStream stream(&file);
+    stream << "File,Scenario,Status,Species,NumRuns,Deterministic,Mean,P5,Median,P95,P(B<K/2)\n";
+    for (const REMORA_BatchResult& result : m_Results) {
+        QString fileName = QFileInfo(result.Filename).fileName();
+        QString scenario = QString::fromStdString(result.Scenario.Name);
+        if (! result.Succeeded) {
+            stream << fileName << "," << scenario << ",\"" <<
+                      QString::fromStdString(result.ErrorMsg).replace('"',"'") << "\",,,,,,,,\n";
+            continue;
+        }
+        LastYear = result.Data.NumYearsPerRun;
+        for (int species=0; species<result.Data.NumSpecies; ++species) {
+            const double* runs = result.Data.BiomassTensor.runs(LastYear,species);
+            values.assign(runs,runs+result.Data.BiomassTensor.NumRuns);
+            halfK    = (species < int(result.CarryingCapacity.size())) ? result.CarryingCapacity[species]/2.0 : 0.0;
+            NumBelow = int(std::count_if(values.begin(),values.end(),[halfK](double value) { return value < halfK; }));
+            stream << fileName << "," << scenario << ",OK,"
+                   << QString::fromStdString(result.Settings.SpeciesNames[species]) << ","
+                   << values.size() << ","
+                   << result.Data.Biomass[0](LastYear,species) << ","
+                   << REMORA_Statistics::mean(values) << ",";
+            quantiles = REMORA_Statistics::quantiles(values,{0.05,0.5,0.95});
+            stream << quantiles[0] << "," << quantiles[1] << "," << quantiles[2] << ",";
+            if (halfK > 0) {
+                stream << double(NumBelow)/values.size();
+            }
+            stream << "\n";
+        }
+    }
+    file.close();
+    return true;
+}
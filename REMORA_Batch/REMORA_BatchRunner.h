@@ -0,0 +1,134 @@
+/**
+ * @file REMORA_BatchRunner.h
+ * @brief Definition for the REMORA headless batch runner
+ *
+ * This file contains the definition of the class that simulates every REMORA
+ * forecast scenario (.scn) file in a directory concurrently, without the REMORA GUI,
+ * and writes summary statistics and plots of the results.
+ *
+ * @copyright
+ * Public Domain Notice\n
+ *
+ * National Oceanic And Atmospheric Administration\n\n
+ *
+ * This software is a "United States Government Work" under the terms of the
+ * United States Copyright Act.  It was written as part of the author's official
+ * duties as a United States Government employee/contractor and thus cannot be copyrighted.
+ * This software is freely available to the public for use. The National Oceanic
+ * And Atmospheric Administration and the U.S. Government have not placed any
+ * restriction on its use or reproduction.  Although all reasonable efforts have
+ * been taken to ensure the accuracy and reliability of the software and data,
+ * the National Oceanic And Atmospheric Administration and the U.S. Government
+ * do not and cannot warrant the performance or results that may be obtained
+ * by using this software or data. The National Oceanic And Atmospheric
+ * Administration and the U.S. Government disclaim all warranties, express
+ * or implied, including warranties of performance, merchantability or fitness
+ * for any particular purpose.\n\n
+ *
+ * Please cite the author(s) in any work or product based on this material.
+ *
+ */
+
+#ifndef REMORA_BATCHRUNNER_H
+#define REMORA_BATCHRUNNER_H
+
+#include <QString>
+#include <QStringList>
+
+#include "nmfLogger.h"
+#include "REMORA_ForecastData.h"
+#include "REMORA_ForecastEngine.h"
+#include "REMORA_Scenario.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The options of a batch of forecast scenarios
+ */
+struct REMORA_BatchOptions {
+    QString     ScenarioDir;           ///< Directory containing the .scn files
+    QString     OutputDir;             ///< Directory to which the summary and plots are written
+    std::string ProjectName;
+    std::string ModelName;
+    std::string ForecastName;          ///< The MSSPM forecast the scenarios modify
+    std::string MultiRunType;          ///< Algorithm identifier used for multi-run estimations
+    bool        UseLastSingleRun = true;
+    int         NumThreads       = 0;  ///< Number of scenarios run concurrently (0 signifies use all available cores)
+    uint64_t    Seed             = 0;  ///< Base seed of the stochastic scenarios (0 signifies a random seed)
+};
+
+/**
+ * @brief The outcome of a single scenario of a batch
+ */
+struct REMORA_BatchResult {
+    QString             Filename;
+    REMORA_Scenario     Scenario;
+    REMORA_RunSettings  Settings;
+    REMORA_ForecastData Data;
+    std::vector<double> CarryingCapacity; ///< K per species (0 if not used by the model)
+    bool                Succeeded = false;
+    std::string         ErrorMsg;
+};
+
+/**
+ * @brief Simulates a directory of REMORA forecast scenarios on a pool of worker threads
+ *
+ * Each scenario is simulated with REMORA_ForecastEngine on its own worker thread with its
+ * own database connection cloned from the application's default connection. Nothing is
+ * written to the database. The following are written to the output directory:
+ *   - summary.csv: the end year biomass statistics per scenario and species
+ *   - <scenario>_quantiles.csv: the median, 5th and 95th percentile biomass per year
+ *   - <scenario>_<species>.png: a plot of the forecast runs per species
+ */
+class REMORA_BatchRunner
+{
+
+private:
+    nmfLogger*                      m_Logger;
+    REMORA_BatchOptions             m_Options;
+    std::vector<REMORA_BatchResult> m_Results;
+    std::atomic<int>                m_NumFinished;
+    std::mutex                      m_OutputMutex;   // Serializes the pool threads' progress lines
+
+    QString outputFilename(
+            const REMORA_BatchResult& result,
+            const QString&            suffix);
+    void runScenario(REMORA_BatchResult& result);
+    bool writePlots(const REMORA_BatchResult& result);
+    bool writeQuantiles(const REMORA_BatchResult& result);
+    bool writeSummary();
+
+public:
+    /**
+     * @brief Class definition for the REMORA batch runner
+     * @param options : the batch options
+     * @param logger : pointer to error logger API
+     */
+    REMORA_BatchRunner(const REMORA_BatchOptions& options,
+                       nmfLogger*                 logger);
+   ~REMORA_BatchRunner();
+
+    /**
+     * @brief Returns the .scn files found in a directory, sorted by name
+     * @param scenarioDir : the directory
+     * @return The full file names
+     */
+    static QStringList findScenarios(const QString& scenarioDir);
+    /**
+     * @brief Returns the results of the last batch
+     * @return One result per scenario file
+     */
+    const std::vector<REMORA_BatchResult>& results();
+    /**
+     * @brief Simulates all of the scenarios and writes the summary and plots
+     * @param errorMsg : description of any error that prevented the batch from running
+     * @return Number of scenarios that failed, or -1 if the batch couldn't be run
+     */
+    int run(std::string& errorMsg);
+};
+
+#endif // REMORA_BATCHRUNNER_H
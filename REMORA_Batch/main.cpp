@@ -0,0 +1,160 @@
+#include "nmfConstants.h"
+#include "nmfConstantsMSSPM.h"
+#include "nmfLogger.h"
+#include "nmfUtilsQt.h"
+#include "REMORA_BatchRunner.h"
+#include "REMORA_Database.h"
+#include "REMORA_SQLiteStorage.h"
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QGuiApplication>
+#include <QSettings>
+#include <QSqlDatabase>
+#include <QSqlError>
+
+#include <iostream>
+
+
+static bool
+openDatabase(
+        const QString& connectionName,
+        const QString& driver,
+        const QString& host,
+        const QString& user,
+        const QString& password,
+        const QString& database)
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase(driver,connectionName);
+    db.setHostName(    host);
+    db.setUserName(    user);
+    db.setPassword(    password);
+    db.setDatabaseName(database);
+    if (! db.open()) {
+        std::cerr << "Error: Couldn't open database: " << db.lastError().text().toStdString() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    // Images are drawn without a display so the batch may be run from a terminal or a scheduler
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM","offscreen");
+    }
+    QGuiApplication app(argc,argv);
+    QCoreApplication::setApplicationName("REMORA_Batch");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Simulates every REMORA forecast scenario (.scn) file of a project "
+                                     "and writes summary statistics and plots of the results.");
+    parser.addHelpOption();
+    QCommandLineOption projectDirOpt( "project-dir", "MSSPM project directory.","dir");
+    QCommandLineOption scenarioDirOpt("scenario-dir","Scenario directory (default: the project's REMORA scenario directory).","dir");
+    QCommandLineOption outputDirOpt(  "output-dir",  "Output directory (default: <scenario-dir>/batch).","dir");
+    QCommandLineOption projectOpt(    "project",     "Project name.","name");
+    QCommandLineOption modelOpt(      "model",       "Model name.","name");
+    QCommandLineOption forecastOpt(   "forecast",    "Forecast name.","name");
+    QCommandLineOption driverOpt(     "driver",      "Qt SQL driver (default: QMYSQL).","driver","QMYSQL");
+    QCommandLineOption hostOpt(       "host",        "Database host (default: localhost).","host","localhost");
+    QCommandLineOption userOpt(       "user",        "Database user.","user");
+    QCommandLineOption passwordOpt(   "password",    "Database password.","password");
+    QCommandLineOption databaseOpt(   "database",    "Database name.","name");
+    QCommandLineOption sqliteOpt(     "sqlite",      "Local SQLite database file in which the scenarios are run, seeded from the database if needed.","file");
+    QCommandLineOption seedSQLiteOpt( "seed-sqlite", "Seed the SQLite database from the database even if it already holds the project, model, and forecast.");
+    QCommandLineOption threadsOpt(    "threads",     "Number of scenarios run concurrently (default: all cores).","n","0");
+    QCommandLineOption seedOpt(       "seed",        "Base seed shared by all stochastic scenarios (default: random).","seed","0");
+    parser.addOptions({projectDirOpt,scenarioDirOpt,outputDirOpt,projectOpt,modelOpt,forecastOpt,
+                       driverOpt,hostOpt,userOpt,passwordOpt,databaseOpt,sqliteOpt,seedSQLiteOpt,threadsOpt,seedOpt});
+    parser.process(app);
+
+    if (! parser.isSet(projectOpt) || ! parser.isSet(modelOpt) || ! parser.isSet(forecastOpt) ||
+        (! parser.isSet(databaseOpt) && ! parser.isSet(sqliteOpt)) ||
+        (! parser.isSet(projectDirOpt) && ! parser.isSet(scenarioDirOpt))) {
+        std::cerr << "Error: --project, --model, --forecast, --database or --sqlite, and --project-dir or --scenario-dir are required."
+                  << std::endl;
+        parser.showHelp(1);
+    }
+
+    nmfLogger* logger = new nmfLogger();
+    logger->initLogger("REMORA_Batch");
+
+    REMORA_BatchOptions options;
+    options.ScenarioDir  = parser.isSet(scenarioDirOpt) ? parser.value(scenarioDirOpt) :
+                           QDir(parser.value(projectDirOpt)).filePath(
+                               QString::fromStdString(nmfConstantsMSSPM::OutputScenariosDirMMode));
+    options.OutputDir    = parser.isSet(outputDirOpt) ? parser.value(outputDirOpt) :
+                           QDir(options.ScenarioDir).filePath("batch");
+    options.ProjectName  = parser.value(projectOpt).toStdString();
+    options.ModelName    = parser.value(modelOpt).toStdString();
+    options.ForecastName = parser.value(forecastOpt).toStdString();
+    options.NumThreads   = parser.value(threadsOpt).toInt();
+    options.Seed         = parser.value(seedOpt).toULongLong();
+
+    // The batch runner clones the default connection for each of its worker threads. With
+    // --sqlite that's the SQLite file, which is seeded from the database only if it doesn't
+    // yet hold the project, model, and forecast (or --seed-sqlite is set).
+    if (parser.isSet(sqliteOpt)) {
+        bool isSeedNeeded;
+        std::string errorMsg;
+        if (! REMORA_SQLiteStorage::addConnection(QSqlDatabase::defaultConnection,parser.value(sqliteOpt),logger)) {
+            std::cerr << "Error: Couldn't open SQLite database: " << parser.value(sqliteOpt).toStdString() << std::endl;
+            return 1;
+        }
+        {
+            REMORA_Database local(QSqlDatabase::defaultConnection,logger);
+            isSeedNeeded = parser.isSet(seedSQLiteOpt) ||
+                           ! REMORA_SQLiteStorage::isSeeded(local,options.ProjectName,options.ModelName,options.ForecastName);
+        }
+        if (isSeedNeeded) {
+            if (! parser.isSet(databaseOpt)) {
+                std::cerr << "Error: The SQLite database doesn't hold the project, model, and forecast. "
+                             "Pass --database to seed it." << std::endl;
+                return 1;
+            }
+            if (! openDatabase("REMORA_Host",parser.value(driverOpt),parser.value(hostOpt),parser.value(userOpt),
+                               parser.value(passwordOpt),parser.value(databaseOpt))) {
+                return 1;
+            }
+            {
+                REMORA_Database host("REMORA_Host",logger);
+                REMORA_Database local(QSqlDatabase::defaultConnection,logger);
+                if (! REMORA_SQLiteStorage::seed(host,local,options.ProjectName,options.ModelName,
+                                                 options.ForecastName,errorMsg)) {
+                    std::cerr << "Error: Couldn't seed SQLite database: " << errorMsg << std::endl;
+                    return 1;
+                }
+            }
+            QSqlDatabase::database("REMORA_Host",false).close();
+            QSqlDatabase::removeDatabase("REMORA_Host");
+            std::cout << "Seeded SQLite database: " << parser.value(sqliteOpt).toStdString() << std::endl;
+        }
+    } else if (! openDatabase(QSqlDatabase::defaultConnection,parser.value(driverOpt),parser.value(hostOpt),
+                              parser.value(userOpt),parser.value(passwordOpt),parser.value(databaseOpt))) {
+        return 1;
+    }
+
+    // Use the same estimation as REMORA would (see REMORA_UI::readSettings)
+    QSettings* settings = nmfUtilsQt::createSettings(nmfConstantsMSSPM::SettingsDirWindows,"MSSPM");
+    settings->beginGroup("Runtime");
+    options.MultiRunType     = settings->value("MultiRunType","").toString().toStdString();
+    options.UseLastSingleRun = settings->value("LastRunTypeForecast",false).toBool();
+    settings->endGroup();
+    delete settings;
+
+    std::string errorMsg;
+    REMORA_BatchRunner runner(options,logger);
+    int NumFailed = runner.run(errorMsg);
+    if (NumFailed < 0) {
+        std::cerr << "Error: " << errorMsg << std::endl;
+        return 1;
+    }
+    std::cout << runner.results().size()-NumFailed << " of " << runner.results().size()
+              << " scenarios succeeded. Output written to: " << options.OutputDir.toStdString() << std::endl;
+
+    QSqlDatabase::database(QSqlDatabase::defaultConnection,false).close();
+    delete logger;
+
+    return (NumFailed == 0) ? 0 : 2;
+}